@@ -0,0 +1,350 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file dump.c Defines the implementation of video dumps.
+///
+/// The context renders 8-bit shades straight into a ring of frames through
+/// its video output. The frame-complete callback queues the frame and hands
+/// the context the next free one, so the emulation thread only waits if the
+/// whole ring is queued. A writer thread converts the queued frames to the
+/// output format and writes them through a large stdio buffer.
+
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "dump.h"
+
+/// The number of frames in the ring.
+#define QUEUE_SIZE (32)
+
+/// The size of the stdio buffer of the output in bytes.
+#define OUT_BUF_SIZE (1 << 20)
+
+/// The size of a frame converted to the output format in bytes; three bytes
+/// per pixel in either format.
+#define PIXELS_SIZE (AGOGE_CORE_FRAME_SIZE * 3)
+
+struct dump {
+	FILE *out;
+	enum dump_fmt fmt;
+	unsigned int decimation;
+
+	pthread_t thread;
+	pthread_mutex_t mtx;
+
+	/// Signalled when a frame is queued, or the dump is closing.
+	pthread_cond_t queued_cond;
+
+	/// Signalled when a frame was written.
+	pthread_cond_t written_cond;
+
+	/// The number of frames written, and queued; the context renders into
+	/// frame `tail % QUEUE_SIZE`.
+	size_t head;
+	size_t tail;
+
+	bool closing;
+	bool failed;
+
+	/// The error of the first failed write.
+	int error;
+
+	/// The output of each shade; one byte per component, R, G and B or Y, U
+	/// and V.
+	uint8_t lut[3][4];
+
+	uint8_t frames[QUEUE_SIZE][AGOGE_CORE_FRAME_SIZE];
+	uint8_t pixels[PIXELS_SIZE];
+	char out_buf[OUT_BUF_SIZE];
+};
+
+/// The color of each shade; the default palette of the video output.
+static const uint8_t palette[4][3] = { { 0xFF, 0xFF, 0xFF },
+				       { 0xAA, 0xAA, 0xAA },
+				       { 0x55, 0x55, 0x55 },
+				       { 0x00, 0x00, 0x00 } };
+
+static void lut_init(struct dump *const dump)
+{
+	for (unsigned int i = 0; i < 4; ++i) {
+		const int r = palette[i][0];
+		const int g = palette[i][1];
+		const int b = palette[i][2];
+
+		if (dump->fmt == DUMP_FMT_RGB) {
+			dump->lut[0][i] = (uint8_t)r;
+			dump->lut[1][i] = (uint8_t)g;
+			dump->lut[2][i] = (uint8_t)b;
+
+			continue;
+		}
+
+		// BT.601, limited range.
+		const int y =
+			(((66 * r) + (129 * g) + (25 * b) + 128) >> 8) + 16;
+		const int u =
+			(((-38 * r) - (74 * g) + (112 * b) + 128) >> 8) + 128;
+		const int v =
+			(((112 * r) - (94 * g) - (18 * b) + 128) >> 8) + 128;
+
+		dump->lut[0][i] = (uint8_t)y;
+		dump->lut[1][i] = (uint8_t)u;
+		dump->lut[2][i] = (uint8_t)v;
+	}
+}
+
+/// Converts a frame of shades to the output format.
+static void frame_convert(struct dump *const dump, const uint8_t *const src)
+{
+	uint8_t *const dst = dump->pixels;
+
+	if (dump->fmt == DUMP_FMT_RGB) {
+		for (size_t i = 0; i < AGOGE_CORE_FRAME_SIZE; ++i) {
+			dst[(i * 3) + 0] = dump->lut[0][src[i] & 3];
+			dst[(i * 3) + 1] = dump->lut[1][src[i] & 3];
+			dst[(i * 3) + 2] = dump->lut[2][src[i] & 3];
+		}
+		return;
+	}
+
+	// Planar: Y, then U, then V.
+	for (size_t p = 0; p < 3; ++p) {
+		uint8_t *const plane = &dst[p * AGOGE_CORE_FRAME_SIZE];
+
+		for (size_t i = 0; i < AGOGE_CORE_FRAME_SIZE; ++i) {
+			plane[i] = dump->lut[p][src[i] & 3];
+		}
+	}
+}
+
+static bool frame_write(struct dump *const dump, const uint8_t *const frame)
+{
+	static const char y4m_frame[] = "FRAME\n";
+
+	frame_convert(dump, frame);
+
+	if ((dump->fmt == DUMP_FMT_Y4M) &&
+	    (fwrite(y4m_frame, 1, sizeof(y4m_frame) - 1, dump->out) !=
+	     (sizeof(y4m_frame) - 1))) {
+		return false;
+	}
+	return fwrite(dump->pixels, 1, PIXELS_SIZE, dump->out) == PIXELS_SIZE;
+}
+
+static void *writer_main(void *const arg)
+{
+	struct dump *const dump = arg;
+
+	pthread_mutex_lock(&dump->mtx);
+
+	for (;;) {
+		while ((dump->head == dump->tail) && !dump->closing) {
+			pthread_cond_wait(&dump->queued_cond, &dump->mtx);
+		}
+
+		if (dump->head == dump->tail) {
+			break;
+		}
+
+		const uint8_t *const frame =
+			dump->frames[dump->head % QUEUE_SIZE];
+		const bool failed = dump->failed;
+
+		// The frame is not touched by the context until it is
+		// released below.
+		pthread_mutex_unlock(&dump->mtx);
+
+		// Once writing failed, keep releasing frames so that the
+		// context never waits forever.
+		const bool ok = failed || frame_write(dump, frame);
+		const int error = errno;
+
+		pthread_mutex_lock(&dump->mtx);
+
+		if (!ok && !dump->failed) {
+			dump->failed = true;
+			dump->error = error;
+		}
+		dump->head++;
+
+		pthread_cond_signal(&dump->written_cond);
+	}
+	pthread_mutex_unlock(&dump->mtx);
+
+	return NULL;
+}
+
+/// Queues a complete frame and returns the frame to render next; called by
+/// the context.
+static void *frame_cb(void *const udata, void *const buf)
+{
+	struct dump *const dump = udata;
+
+	(void)buf;
+
+	pthread_mutex_lock(&dump->mtx);
+
+	dump->tail++;
+	pthread_cond_signal(&dump->queued_cond);
+
+	while ((dump->tail - dump->head) >= QUEUE_SIZE) {
+		pthread_cond_wait(&dump->written_cond, &dump->mtx);
+	}
+
+	void *const next = dump->frames[dump->tail % QUEUE_SIZE];
+	pthread_mutex_unlock(&dump->mtx);
+
+	return next;
+}
+
+static bool hdr_write(struct dump *const dump)
+{
+	// Both are multiples of 16; reducing them keeps large decimations from
+	// overflowing the denominator.
+	const uint32_t num = AGOGE_CORE_CYCLES_PER_SEC / 16;
+	const uint32_t den = (AGOGE_CORE_FRAME_CYCLES / 16) * dump->decimation;
+
+	if (dump->fmt == DUMP_FMT_Y4M) {
+		return fprintf(dump->out,
+			       "YUV4MPEG2 W%d H%d F%" PRIu32 ":%" PRIu32
+			       " Ip A1:1 C444\n",
+			       AGOGE_CORE_FRAME_WIDTH, AGOGE_CORE_FRAME_HEIGHT,
+			       num, den) > 0;
+	}
+
+	const uint32_t fields[4] = { AGOGE_CORE_FRAME_WIDTH,
+				     AGOGE_CORE_FRAME_HEIGHT,
+				     num, den };
+	uint8_t hdr[DUMP_RGB_HDR_SIZE] = "AGOGERGB";
+
+	for (size_t i = 0; i < 4; ++i) {
+		for (size_t b = 0; b < sizeof(uint32_t); ++b) {
+			hdr[8 + (i * 4) + b] = (uint8_t)(fields[i] >> (b * 8));
+		}
+	}
+	return fwrite(hdr, 1, sizeof(hdr), dump->out) == sizeof(hdr);
+}
+
+struct dump *dump_open(const char *const path, const enum dump_fmt fmt,
+		       const unsigned int decimation)
+{
+	struct dump *const dump = calloc(1, sizeof(*dump));
+
+	if (dump == NULL) {
+		fprintf(stderr, "Unable to allocate video dump\n");
+		return NULL;
+	}
+
+	// The standard output gets a stream of its own, so that its buffer
+	// goes away with the dump.
+	if (strcmp(path, "-") == 0) {
+		dump->out = fdopen(dup(STDOUT_FILENO), "wb");
+	} else {
+		dump->out = fopen(path, "wb");
+	}
+
+	if (dump->out == NULL) {
+		fprintf(stderr, "Unable to open %s: %s\n", path,
+			strerror(errno));
+		free(dump);
+
+		return NULL;
+	}
+
+	dump->fmt = fmt;
+	dump->decimation = decimation;
+
+	setvbuf(dump->out, dump->out_buf, _IOFBF, sizeof(dump->out_buf));
+	lut_init(dump);
+
+	if (!hdr_write(dump)) {
+		fprintf(stderr, "Unable to write %s: %s\n", path,
+			strerror(errno));
+
+		fclose(dump->out);
+		free(dump);
+
+		return NULL;
+	}
+
+	pthread_mutex_init(&dump->mtx, NULL);
+	pthread_cond_init(&dump->queued_cond, NULL);
+	pthread_cond_init(&dump->written_cond, NULL);
+	pthread_create(&dump->thread, NULL, &writer_main, dump);
+
+	return dump;
+}
+
+void dump_attach(struct dump *const dump, struct agoge_core_ctx *const ctx)
+{
+	agoge_core_video_set(agoge_core_ctx_video(ctx), dump->frames[0],
+			     AGOGE_CORE_FRAME_WIDTH,
+			     AGOGE_CORE_VIDEO_FORMAT_INDEX8, NULL, &frame_cb,
+			     dump);
+
+	if (dump->decimation > 1) {
+		agoge_core_ppu_render_set(ctx, AGOGE_CORE_PPU_RENDER_NTH,
+					  dump->decimation);
+	}
+}
+
+bool dump_failed(struct dump *const dump)
+{
+	pthread_mutex_lock(&dump->mtx);
+	const bool failed = dump->failed;
+	pthread_mutex_unlock(&dump->mtx);
+
+	return failed;
+}
+
+bool dump_close(struct dump *const dump)
+{
+	pthread_mutex_lock(&dump->mtx);
+	dump->closing = true;
+	pthread_cond_signal(&dump->queued_cond);
+	pthread_mutex_unlock(&dump->mtx);
+
+	pthread_join(dump->thread, NULL);
+
+	bool ok = !dump->failed;
+
+	if ((fclose(dump->out) != 0) && ok) {
+		ok = false;
+		dump->error = errno;
+	}
+
+	if (!ok) {
+		fprintf(stderr, "Unable to write video dump: %s\n",
+			strerror(dump->error));
+	}
+
+	pthread_cond_destroy(&dump->written_cond);
+	pthread_cond_destroy(&dump->queued_cond);
+	pthread_mutex_destroy(&dump->mtx);
+	free(dump);
+
+	return ok;
+}
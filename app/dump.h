@@ -0,0 +1,74 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file dump.h Defines the interface of video dumps, which stream the frames
+/// of a context to a file or a pipe for offline encoding.
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "agoge/ctx.h"
+
+/// Defines the formats of a video dump.
+enum dump_fmt {
+	/// YUV4MPEG2 with 4:4:4 chroma, as read by most encoders.
+	DUMP_FMT_Y4M,
+
+	/// 24-bit RGB frames after a `DUMP_RGB_HDR_SIZE` byte header.
+	DUMP_FMT_RGB
+};
+
+/// The size of the header of `DUMP_FMT_RGB` in bytes: the magic "AGOGERGB",
+/// then the width, height, and frame rate numerator and denominator as 32-bit
+/// little endian integers.
+#define DUMP_RGB_HDR_SIZE (24)
+
+struct dump;
+
+/// Opens a video dump and starts its writer thread.
+///
+/// @param path The file to write, or "-" for the standard output.
+/// @param fmt The format of the dump.
+/// @param decimation Only one frame in every `decimation` frames is dumped;
+/// not zero.
+/// @returns The dump, or `NULL` on failure, which is reported on the standard
+/// error.
+struct dump *dump_open(const char *path, enum dump_fmt fmt,
+		       unsigned int decimation);
+
+/// Makes a context render its frames into the dump.
+///
+/// @param dump The dump.
+/// @param ctx The context.
+void dump_attach(struct dump *dump, struct agoge_core_ctx *ctx);
+
+/// Checks whether writing the dump failed, e.g., because the reader of the
+/// pipe went away.
+///
+/// @param dump The dump.
+/// @returns Whether writing the dump failed.
+bool dump_failed(struct dump *dump);
+
+/// Writes the queued frames, and closes a video dump.
+///
+/// @param dump The dump.
+/// @returns Whether every frame was written.
+bool dump_close(struct dump *dump);
@@ -25,8 +25,15 @@
 #include <stdint.h>
 #include <sys/stat.h>
 #include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <signal.h>
 
 #include "agoge/ctx.h"
+#include "dump.h"
+#include "pace.h"
+#include "renderer.h"
+#include "wav.h"
 
 #define RED "\e[1;91m"
 #define YEL "\e[1;93m"
@@ -36,29 +43,44 @@
 
 static size_t rom_size;
 static uint8_t rom[AGOGE_CORE_CART_SIZE_MAX];
-static struct agoge_core_ctx ctx;
+static struct agoge_core_ctx *ctx;
+
+/// Set when running without tracing, e.g., to dump video; logs then go to the
+/// standard error, and only warnings and errors are logged.
+static bool headless;
+
+/// Set by SIGINT and SIGTERM to stop a real-time run.
+static volatile sig_atomic_t quit;
+
+static void signal_handler(const int sig)
+{
+	(void)sig;
+	quit = 1;
+}
 
 static void log_cb(struct agoge_core_ctx *const m_ctx,
 		   const struct agoge_core_log_msg *const msg)
 {
 	(void)m_ctx;
 
+	FILE *const out = headless ? stderr : stdout;
+
 	switch (msg->lvl) {
 	case AGOGE_CORE_LOG_LVL_INFO:
-		printf(WHT "%s\n" RESET, msg->msg);
+		fprintf(out, WHT "%s\n" RESET, msg->msg);
 		return;
 
 	case AGOGE_CORE_LOG_LVL_WARN:
-		printf(YEL "%s\n" RESET, msg->msg);
+		fprintf(out, YEL "%s\n" RESET, msg->msg);
 		return;
 
 	case AGOGE_CORE_LOG_LVL_ERR:
-		printf(RED "%s\n" RESET, msg->msg);
+		fprintf(out, RED "%s\n" RESET, msg->msg);
 		return;
 
 	case AGOGE_CORE_LOG_LVL_DBG:
 	case AGOGE_CORE_LOG_LVL_TRACE:
-		printf(PURPLE "%s\n" RESET, msg->msg);
+		fprintf(out, PURPLE "%s\n" RESET, msg->msg);
 		return;
 
 	case AGOGE_CORE_LOG_LVL_OFF:
@@ -99,44 +121,342 @@ static bool open_rom(const char *const rom_file)
 	return true;
 }
 
-static void setup_ctx(void)
+static bool setup_ctx(const bool threaded)
 {
-	ctx.log.cb = &log_cb;
-	ctx.log.curr_lvl = AGOGE_CORE_LOG_LVL_TRACE;
+	ctx = agoge_core_ctx_create(NULL, AGOGE_CORE_CTX_ALIGN_CACHE_LINE);
+
+	if (ctx == NULL) {
+		fprintf(stderr, "Unable to allocate emulator context\n");
+		return false;
+	}
+
+	struct agoge_core_log *const log = agoge_core_ctx_log(ctx);
+
+	log->cb = &log_cb;
+	log->curr_lvl =
+		headless ? AGOGE_CORE_LOG_LVL_WARN : AGOGE_CORE_LOG_LVL_TRACE;
 
-	ctx.log.ch_enabled |=
+	log->ch_enabled |=
 		AGOGE_CORE_LOG_CH_CTX_BIT | AGOGE_CORE_LOG_CH_BUS_BIT |
 		AGOGE_CORE_LOG_CH_CART_BIT | AGOGE_CORE_LOG_CH_DISASM_BIT;
 
-	agoge_core_ctx_reset(&ctx);
+	// Only the fast backend hands its scanlines to a render thread.
+	if (threaded) {
+		agoge_core_ppu_backend_set(ctx, AGOGE_CORE_PPU_BACKEND_FAST);
+	}
+
+	agoge_core_ctx_reset(ctx);
+	return true;
+}
+
+/// Defines the options of a headless run.
+struct headless_opts {
+	/// The file to dump video to, or `NULL` for none.
+	const char *dump_path;
+	enum dump_fmt dump_fmt;
+	unsigned long decimation;
+
+	/// The file to capture audio to, or `NULL` for none.
+	const char *wav_path;
+
+	/// The number of frames to run; zero to run until a dump or capture
+	/// fails.
+	unsigned long num_frames;
+
+	/// Whether to run in real time, and report the latency and jitter of
+	/// the frames.
+	bool realtime;
+
+	/// Whether to render on a separate thread.
+	bool threaded;
+
+	/// Whether to print the hash of the final frame, and the hash it is
+	/// expected to have, if any.
+	bool hash_print;
+	bool hash_check;
+	uint64_t hash_expected;
+};
+
+static void usage(const char *const argv0)
+{
+	fprintf(stderr,
+		"Syntax: %s [-o video_file] [-f y4m|rgb] [-k decimation]\n"
+		"       [-w wav_file] [-n num_frames] [-r] [-t] [-x] [-e hash]\n"
+		"       <rom_file>\n"
+		"\n"
+		"Without -o, -w, -r, -t, -x or -e, the ROM runs forever with\n"
+		"an instruction trace.\n"
+		"  -o  Run headless and dump video to a file, or - for the\n"
+		"      standard output\n"
+		"  -f  The format of the dump: Y4M (default) or raw RGB\n"
+		"  -k  Render only one frame in every decimation frames\n"
+		"  -w  Run headless and capture audio to a WAV file, or - for\n"
+		"      the standard output; it starts with the video dump\n"
+		"  -n  Stop after num_frames frames; 0 (default) runs until\n"
+		"      the reader of the dump or capture goes away\n"
+		"  -r  Run headless in real time, and report the latency and\n"
+		"      jitter of the frames on exit; SIGINT stops the run\n"
+		"  -t  Run headless with the fast backend, and render on a\n"
+		"      separate thread\n"
+		"  -x  Run headless and print the hash of the final frame;\n"
+		"      requires -n, and excludes -k\n"
+		"  -e  Run headless and fail unless the final frame has the\n"
+		"      given hash, in hexadecimal; requires -n, and excludes\n"
+		"      -k\n",
+		argv0);
+}
+
+/// Checks whether a path of an option is the standard output.
+static bool is_stdout(const char *const path)
+{
+	return (path != NULL) && (strcmp(path, "-") == 0);
+}
+
+/// Runs the ROM headless, dumping its video and audio and checking the hash of
+/// its final frame as requested.
+static bool headless_run(const struct headless_opts *const opts)
+{
+	struct dump *dump = NULL;
+	struct wav *wav = NULL;
+
+	if (opts->dump_path != NULL) {
+		dump = dump_open(opts->dump_path, opts->dump_fmt,
+				 (unsigned int)opts->decimation);
+
+		if (dump == NULL) {
+			return false;
+		}
+
+		// A reader going away fails the write instead of killing us.
+		signal(SIGPIPE, SIG_IGN);
+		dump_attach(dump, ctx);
+	} else if (opts->decimation > 1) {
+		agoge_core_ppu_render_set(ctx, AGOGE_CORE_PPU_RENDER_NTH,
+					  (uint32_t)opts->decimation);
+	}
+
+	// Attached before the first frame, like the video dump, so that both
+	// start at the same cycle.
+	if (opts->wav_path != NULL) {
+		wav = wav_open(opts->wav_path);
+
+		if (wav == NULL) {
+			if (dump != NULL) {
+				dump_close(dump);
+			}
+			return false;
+		}
+
+		signal(SIGPIPE, SIG_IGN);
+		wav_attach(wav, ctx);
+	}
+
+	struct pace *pace = NULL;
+	struct renderer *renderer = NULL;
+	bool ok = true;
+
+	// Opened once the video output is set, which goes to the render
+	// thread.
+	if (opts->threaded) {
+		renderer = renderer_open(ctx);
+		ok = (renderer != NULL);
+	}
+
+	if (ok && opts->realtime) {
+		const struct sigaction sa = { .sa_handler = &signal_handler };
+
+		sigaction(SIGINT, &sa, NULL);
+		sigaction(SIGTERM, &sa, NULL);
+
+		pace = pace_create();
+
+		if (pace == NULL) {
+			fprintf(stderr, "Unable to allocate pacer\n");
+			ok = false;
+		}
+	}
+
+	for (unsigned long i = 0;
+	     ok && !quit && ((opts->num_frames == 0) || (i < opts->num_frames));
+	     ++i) {
+		if (pace != NULL) {
+			// Input would be read here, as late as the frame can
+			// start.
+			pace_wait(pace);
+		}
+
+		agoge_core_ctx_run_frame(ctx);
+
+		if (pace != NULL) {
+			pace_present(pace);
+		}
+
+		if (wav != NULL) {
+			wav_frame(wav);
+
+			if (wav_failed(wav)) {
+				break;
+			}
+		}
+
+		if ((dump != NULL) && dump_failed(dump)) {
+			break;
+		}
+	}
+
+	if (pace != NULL) {
+		pace_report(pace, stderr);
+		pace_destroy(pace);
+	}
+
+	// The render thread hands its last frames to the video dump, so it is
+	// closed first.
+	const uint64_t hash = (renderer != NULL) ?
+				      renderer_close(renderer, ctx) :
+				      agoge_core_ppu_frame_hash(ctx);
+
+	if ((dump != NULL) && !dump_close(dump)) {
+		ok = false;
+	}
+
+	if ((wav != NULL) && !wav_close(wav)) {
+		ok = false;
+	}
+
+	if (opts->hash_print) {
+		// Keep the standard output for the video or audio if either
+		// goes there.
+		FILE *const out = (is_stdout(opts->dump_path) ||
+				   is_stdout(opts->wav_path)) ?
+					  stderr :
+					  stdout;
+
+		fprintf(out, "%016" PRIx64 "\n", hash);
+	}
+
+	if (opts->hash_check && (hash != opts->hash_expected)) {
+		fprintf(stderr,
+			"Frame hash mismatch: expected %016" PRIx64
+			", got %016" PRIx64 "\n",
+			opts->hash_expected, hash);
+		ok = false;
+	}
+	return ok;
 }
 
 int main(int argc, char *argv[])
 {
-	if (argc < 2) {
-		fprintf(stderr, "%s: Missing required argument.\n", argv[0]);
-		fprintf(stderr, "Syntax: %s <rom_file>\n", argv[0]);
+	struct headless_opts opts = { .dump_fmt = DUMP_FMT_Y4M,
+				      .decimation = 1 };
+	int opt;
+
+	while ((opt = getopt(argc, argv, "o:f:k:w:n:rtxe:")) != -1) {
+		switch (opt) {
+		case 'o':
+			opts.dump_path = optarg;
+			break;
+
+		case 'f':
+			if (strcmp(optarg, "y4m") == 0) {
+				opts.dump_fmt = DUMP_FMT_Y4M;
+			} else if (strcmp(optarg, "rgb") == 0) {
+				opts.dump_fmt = DUMP_FMT_RGB;
+			} else {
+				usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			break;
 
+		case 'k':
+			opts.decimation = strtoul(optarg, NULL, 10);
+			break;
+
+		case 'w':
+			opts.wav_path = optarg;
+			break;
+
+		case 'n':
+			opts.num_frames = strtoul(optarg, NULL, 10);
+			break;
+
+		case 'r':
+			opts.realtime = true;
+			break;
+
+		case 't':
+			opts.threaded = true;
+			break;
+
+		case 'x':
+			opts.hash_print = true;
+			break;
+
+		case 'e': {
+			char *end;
+
+			errno = 0;
+			opts.hash_expected = strtoull(optarg, &end, 16);
+
+			if ((errno != 0) || (end == optarg) || (*end != '\0')) {
+				usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+			opts.hash_check = true;
+
+			break;
+		}
+
+		default:
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	const bool hashing = opts.hash_print || opts.hash_check;
+
+	// With decimation, the final frame may not be rendered, and the hash
+	// would be that of an earlier frame.
+	if ((optind != (argc - 1)) || (opts.decimation == 0) ||
+	    (opts.decimation > UINT16_MAX) ||
+	    (hashing && ((opts.num_frames == 0) || (opts.decimation > 1))) ||
+	    (is_stdout(opts.dump_path) && is_stdout(opts.wav_path))) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	headless = (opts.dump_path != NULL) || (opts.wav_path != NULL) ||
+		   opts.realtime || opts.threaded || hashing;
+
+	if (!setup_ctx(opts.threaded)) {
 		return EXIT_FAILURE;
 	}
-	setup_ctx();
 
-	if (!open_rom(argv[1])) {
+	if (!open_rom(argv[optind])) {
+		agoge_core_ctx_destroy(ctx);
 		return EXIT_FAILURE;
 	}
 
 	const enum agoge_core_cart_retval ret =
-		agoge_core_cart_set(&ctx, rom, rom_size);
+		agoge_core_cart_set(ctx, rom, rom_size);
 
 	if (ret != AGOGE_CORE_CART_RETVAL_OK) {
 		fprintf(stderr, "agoge_core_cart_set error, see log\n");
+		agoge_core_ctx_destroy(ctx);
+
 		return EXIT_FAILURE;
 	}
 
+	if (headless) {
+		const bool ok = headless_run(&opts);
+
+		agoge_core_ctx_destroy(ctx);
+		return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
 	for (;;) {
-		agoge_core_disasm_trace_before(&ctx);
-		agoge_core_ctx_step(&ctx, 1);
-		agoge_core_disasm_trace_after(&ctx);
+		agoge_core_disasm_trace_before(ctx);
+		agoge_core_ctx_step(ctx, 1);
+		agoge_core_disasm_trace_after(ctx);
 	}
 	return EXIT_SUCCESS;
 }
@@ -0,0 +1,272 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file pace.c Defines the implementation of frame pacing.
+///
+/// The vsyncs are at exact multiples of the refresh period of the DMG after
+/// the creation of the pacer, on the monotonic clock, and every wait is until
+/// an absolute time; errors of sleeping thus never add up. A frame starts as
+/// late before its vsync as the slowest of the recent frames took from the
+/// time it was to start, wake-up delay included, plus a margin, so that input
+/// read just before it reaches the screen as soon as possible.
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "agoge/ctx.h"
+#include "pace.h"
+
+#define NSEC_PER_SEC (1000000000)
+#define NSEC_PER_MSEC (1000000)
+
+/// The refresh period of the DMG is `AGOGE_CORE_FRAME_CYCLES` T-cycles, i.e.,
+/// `AGOGE_CORE_FRAME_CYCLES * NSEC_PER_SEC / AGOGE_CORE_CYCLES_PER_SEC`
+/// nanoseconds; the fraction is reduced by 512 so that the time of a vsync
+/// fits in 64 bits for about 25 days.
+#define PERIOD_NUM ((uint64_t)AGOGE_CORE_FRAME_CYCLES * (NSEC_PER_SEC / 512))
+#define PERIOD_DEN ((uint64_t)AGOGE_CORE_CYCLES_PER_SEC / 512)
+
+/// The number of recent frames whose time sets when a frame starts.
+#define BUDGET_WINDOW (64)
+
+/// The time left between the expected end of a frame and its vsync, in
+/// nanoseconds.
+#define BUDGET_MARGIN (500000)
+
+/// The width of a bucket of the histograms, in nanoseconds, and their number;
+/// times past the last bucket go in it.
+#define HIST_BUCKET (10000)
+#define HIST_SIZE (4096)
+
+/// Defines the statistics of a kind of time.
+struct times {
+	uint64_t min;
+	uint64_t max;
+	double sum;
+	double sum_sq;
+	uint32_t hist[HIST_SIZE];
+};
+
+struct pace {
+	/// The time of vsync zero.
+	uint64_t t0;
+
+	/// The index of the vsync of the next frame, and its time.
+	uint64_t vsync_idx;
+	uint64_t vsync;
+
+	/// The time the current frame was to start, or the time `pace_wait`
+	/// was called if that was later, and the time it started.
+	uint64_t target;
+	uint64_t start;
+
+	/// The time the recent frames took from their target to their end.
+	uint64_t window[BUDGET_WINDOW];
+	size_t window_pos;
+
+	uint64_t frames;
+	uint64_t missed;
+
+	/// From the start of a frame to its presentation.
+	struct times latency;
+
+	/// From a vsync to the presentation of its frame.
+	struct times jitter;
+
+	/// From the start of a frame to its end.
+	struct times busy;
+};
+
+static uint64_t now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * NSEC_PER_SEC) + (uint64_t)ts.tv_nsec;
+}
+
+static void sleep_until(const uint64_t t)
+{
+	const struct timespec ts = { .tv_sec = (time_t)(t / NSEC_PER_SEC),
+				     .tv_nsec = (long)(t % NSEC_PER_SEC) };
+
+	// Restarting after a signal is fine; the time is absolute.
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) !=
+	       0) {
+	}
+}
+
+static uint64_t vsync_at(const struct pace *const pace, const uint64_t idx)
+{
+	return pace->t0 + ((idx * PERIOD_NUM) / PERIOD_DEN);
+}
+
+static void times_add(struct times *const times, const uint64_t t)
+{
+	if (t < times->min) {
+		times->min = t;
+	}
+
+	if (t > times->max) {
+		times->max = t;
+	}
+
+	const double ms = (double)t / NSEC_PER_MSEC;
+
+	times->sum += ms;
+	times->sum_sq += ms * ms;
+
+	const uint64_t bucket = t / HIST_BUCKET;
+
+	times->hist[(bucket < HIST_SIZE) ? bucket : (HIST_SIZE - 1)]++;
+}
+
+/// Retrieves the time under which a share of the times are, in milliseconds,
+/// rounded up to a bucket.
+///
+/// @param times The times.
+/// @param num The number of times.
+/// @param permille The share, in thousandths.
+static double times_quantile(const struct times *const times,
+			     const uint64_t num, const uint64_t permille)
+{
+	const uint64_t rank = ((num * permille) + 999) / 1000;
+	uint64_t seen = 0;
+
+	for (size_t i = 0; i < HIST_SIZE; ++i) {
+		seen += times->hist[i];
+
+		if (seen >= rank) {
+			return (double)((i + 1) * HIST_BUCKET) / NSEC_PER_MSEC;
+		}
+	}
+	return (double)times->max / NSEC_PER_MSEC;
+}
+
+static void times_print(const struct times *const times, const uint64_t num,
+			const char *const name, FILE *const out)
+{
+	const double mean = times->sum / (double)num;
+	const double var = (times->sum_sq / (double)num) - (mean * mean);
+
+	fprintf(out,
+		"%-8s min %7.3f  mean %7.3f  sd %7.3f  p99 %7.3f  max %7.3f\n",
+		name, (double)times->min / NSEC_PER_MSEC, mean,
+		(var > 0) ? sqrt(var) : 0, times_quantile(times, num, 990),
+		(double)times->max / NSEC_PER_MSEC);
+}
+
+struct pace *pace_create(void)
+{
+	struct pace *const pace = calloc(1, sizeof(*pace));
+
+	if (pace == NULL) {
+		return NULL;
+	}
+
+	pace->t0 = now();
+	pace->vsync_idx = 1;
+	pace->vsync = vsync_at(pace, 1);
+
+	// Until frames have been timed, start them half a period early.
+	for (size_t i = 0; i < BUDGET_WINDOW; ++i) {
+		pace->window[i] = PERIOD_NUM / PERIOD_DEN / 2;
+	}
+
+	pace->latency.min = UINT64_MAX;
+	pace->jitter.min = UINT64_MAX;
+	pace->busy.min = UINT64_MAX;
+
+	return pace;
+}
+
+void pace_destroy(struct pace *const pace)
+{
+	free(pace);
+}
+
+void pace_wait(struct pace *const pace)
+{
+	uint64_t budget = 0;
+
+	for (size_t i = 0; i < BUDGET_WINDOW; ++i) {
+		if (pace->window[i] > budget) {
+			budget = pace->window[i];
+		}
+	}
+	budget += BUDGET_MARGIN;
+
+	const uint64_t t = now();
+
+	if ((budget < pace->vsync) && ((pace->vsync - budget) > t)) {
+		pace->target = pace->vsync - budget;
+		sleep_until(pace->target);
+	} else {
+		pace->target = t;
+	}
+	pace->start = now();
+}
+
+void pace_present(struct pace *const pace)
+{
+	const uint64_t done = now();
+	uint64_t presented = done;
+
+	pace->window[pace->window_pos++ % BUDGET_WINDOW] = done - pace->target;
+	times_add(&pace->busy, done - pace->start);
+
+	if (done <= pace->vsync) {
+		sleep_until(pace->vsync);
+		presented = now();
+		pace->vsync_idx++;
+	} else {
+		// Late: the vsync is gone, so wait for the first one to come
+		// instead of running frames back to back to catch up.
+		pace->missed++;
+		pace->vsync_idx = (((done - pace->t0) * PERIOD_DEN) /
+				   PERIOD_NUM) + 1;
+	}
+
+	times_add(&pace->latency, presented - pace->start);
+	times_add(&pace->jitter, presented - pace->vsync);
+
+	pace->frames++;
+	pace->vsync = vsync_at(pace, pace->vsync_idx);
+}
+
+void pace_report(const struct pace *const pace, FILE *const out)
+{
+	if (pace->frames == 0) {
+		return;
+	}
+
+	fprintf(out, "%" PRIu64 " frames, %" PRIu64 " missed (%.2f%%)\n",
+		pace->frames, pace->missed,
+		(double)(pace->missed * 100) / (double)pace->frames);
+
+	fprintf(out, "Times in ms:\n");
+	times_print(&pace->latency, pace->frames, "latency", out);
+	times_print(&pace->jitter, pace->frames, "jitter", out);
+	times_print(&pace->busy, pace->frames, "busy", out);
+}
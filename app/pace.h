@@ -0,0 +1,59 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file pace.h Defines the interface of frame pacing, which runs a context in
+/// real time with as little latency as its frames allow.
+
+#pragma once
+
+#include <stdio.h>
+
+struct pace;
+
+/// Creates a pacer; its first vsync is one refresh period away.
+///
+/// @returns The pacer, or `NULL` if memory could not be allocated.
+struct pace *pace_create(void);
+
+/// Destroys a pacer.
+///
+/// @param pace The pacer; may be `NULL`.
+void pace_destroy(struct pace *pace);
+
+/// Waits until the latest time the next frame can start and still be done by
+/// its vsync, going by the time the recent frames took. Input is to be read
+/// right after, and the frame run.
+///
+/// @param pace The pacer.
+void pace_wait(struct pace *pace);
+
+/// Waits for the vsync of the frame just run, and records its latency, i.e.,
+/// the time from the end of `pace_wait` to the vsync, and its jitter. A frame
+/// done after its vsync is presented at once, and the next frame waits for the
+/// first vsync to come.
+///
+/// @param pace The pacer.
+void pace_present(struct pace *pace);
+
+/// Prints the statistics of the frames presented.
+///
+/// @param pace The pacer.
+/// @param out The stream to print to.
+void pace_report(const struct pace *pace, FILE *out);
@@ -0,0 +1,121 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file renderer.c Defines the implementation of the render thread of the app.
+///
+/// The render thread replays the queue of the renderer as fast as it fills,
+/// and yields while it is empty. Once asked to stop, it drains the queue
+/// before it exits, so that no frame of the run is lost.
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "agoge/render.h"
+#include "renderer.h"
+
+struct renderer {
+	struct agoge_core_render *render;
+	pthread_t thread;
+
+	/// Set by `renderer_close` once the context queues nothing more.
+	atomic_bool closing;
+};
+
+static void *renderer_main(void *const arg)
+{
+	struct renderer *const renderer = arg;
+
+	for (;;) {
+		// Read before the queue, so that an empty queue seen after it
+		// was set holds every record.
+		const bool closing = atomic_load_explicit(&renderer->closing,
+							  memory_order_acquire);
+
+		if (agoge_core_render_run(renderer->render)) {
+			continue;
+		}
+
+		if (closing) {
+			break;
+		}
+		sched_yield();
+	}
+
+	agoge_core_render_stop(renderer->render);
+	return NULL;
+}
+
+struct renderer *renderer_open(struct agoge_core_ctx *const ctx)
+{
+	struct renderer *const renderer = malloc(sizeof(*renderer));
+
+	if (renderer == NULL) {
+		fprintf(stderr, "Unable to allocate render thread\n");
+		return NULL;
+	}
+
+	renderer->render = agoge_core_render_create();
+
+	if (renderer->render == NULL) {
+		fprintf(stderr, "Unable to allocate renderer\n");
+		free(renderer);
+
+		return NULL;
+	}
+
+	atomic_init(&renderer->closing, false);
+
+	// The render thread is not running yet, so the video output of the
+	// renderer may be set here.
+	*agoge_core_render_video(renderer->render) =
+		*agoge_core_ctx_video(ctx);
+
+	if (pthread_create(&renderer->thread, NULL, &renderer_main,
+			   renderer) != 0) {
+		fprintf(stderr, "Unable to start render thread\n");
+		agoge_core_render_destroy(renderer->render);
+		free(renderer);
+
+		return NULL;
+	}
+
+	agoge_core_render_attach(ctx, renderer->render);
+	return renderer;
+}
+
+uint64_t renderer_close(struct renderer *const renderer,
+			struct agoge_core_ctx *const ctx)
+{
+	atomic_store_explicit(&renderer->closing, true, memory_order_release);
+	pthread_join(renderer->thread, NULL);
+
+	agoge_core_render_attach(ctx, NULL);
+
+	const uint64_t hash = agoge_core_render_frame_hash(renderer->render);
+
+	agoge_core_render_destroy(renderer->render);
+	free(renderer);
+
+	return hash;
+}
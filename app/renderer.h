@@ -0,0 +1,49 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file renderer.h Defines the interface of the render thread of the app,
+/// which renders the frames of a context off the emulation thread through a
+/// renderer of the core.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "agoge/ctx.h"
+
+struct renderer;
+
+/// Starts a render thread and attaches its renderer to a context. The video
+/// output of the context, e.g., a video dump, goes to the renderer from then
+/// on.
+///
+/// @param ctx The context; its fast backend hands its scanlines to the render
+/// thread.
+/// @returns The render thread, or `NULL` on failure, which is reported on the
+/// standard error.
+struct renderer *renderer_open(struct agoge_core_ctx *ctx);
+
+/// Renders the frames still queued, stops the render thread and detaches its
+/// renderer from the context.
+///
+/// @param renderer The render thread.
+/// @param ctx The context it was opened with.
+/// @returns The hash of the last frame rendered.
+uint64_t renderer_close(struct renderer *renderer, struct agoge_core_ctx *ctx);
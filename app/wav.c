@@ -0,0 +1,450 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file wav.c Defines the implementation of audio captures.
+///
+/// The context synthesizes into an audio buffer of the capture. After each
+/// frame, the emulation thread moves the ready samples into a ring of chunks,
+/// and a writer thread writes the queued chunks through a large stdio buffer.
+/// The emulation thread never waits for the writer: samples which find the
+/// ring full are counted, and written as silence before the next chunk, so
+/// the capture stays in time with the video.
+
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "agoge/audio.h"
+#include "wav.h"
+
+/// The number of samples per channel of a chunk.
+#define CHUNK_FRAMES (2048)
+
+/// The number of chunks in the ring; about eight seconds of audio.
+#define QUEUE_SIZE (256)
+
+/// The size of the stdio buffer of the output in bytes.
+#define OUT_BUF_SIZE (1 << 20)
+
+/// The size of a sample for both channels in bytes.
+#define FRAME_SIZE (4)
+
+/// The size of the header in bytes.
+#define HDR_SIZE (44)
+
+/// The offsets of the sizes in the header: of the RIFF chunk, and of the data
+/// chunk.
+#define HDR_RIFF_SIZE_OFFSET (4)
+#define HDR_DATA_SIZE_OFFSET (40)
+
+/// The size the header gives while the capture is written, which readers take
+/// to mean reading up to the end of the file.
+#define SIZE_UNKNOWN (UINT32_MAX)
+
+struct chunk {
+	/// The number of samples per channel of silence before the samples, for
+	/// the samples dropped before the chunk.
+	size_t silence;
+
+	/// The number of samples per channel.
+	size_t frames;
+
+	int16_t samples[CHUNK_FRAMES * 2];
+};
+
+struct wav {
+	FILE *out;
+	struct agoge_core_ctx *ctx;
+	struct agoge_core_audio *audio;
+
+	pthread_t thread;
+	pthread_mutex_t mtx;
+
+	/// Signalled when a chunk is queued, or the capture is closing.
+	pthread_cond_t queued_cond;
+
+	/// Signalled when a chunk was written.
+	pthread_cond_t written_cond;
+
+	/// The number of chunks written, and queued; the emulation thread fills
+	/// chunk `tail % QUEUE_SIZE`.
+	size_t head;
+	size_t tail;
+
+	bool closing;
+	bool failed;
+
+	/// The error of the first failed write.
+	int error;
+
+	/// The number of samples per channel dropped since the last queued
+	/// chunk, and in total; owned by the emulation thread.
+	size_t lost;
+	uint64_t lost_total;
+
+	/// The number of bytes of samples written; owned by the writer thread.
+	uint64_t data_size;
+
+	struct chunk chunks[QUEUE_SIZE];
+
+	/// Receives the samples which are dropped.
+	int16_t scratch[CHUNK_FRAMES * 2];
+
+	/// A chunk converted to little endian.
+	uint8_t bytes[CHUNK_FRAMES * FRAME_SIZE];
+
+	char out_buf[OUT_BUF_SIZE];
+};
+
+static void le16_put(uint8_t *const dst, const uint16_t val)
+{
+	dst[0] = (uint8_t)val;
+	dst[1] = (uint8_t)(val >> 8);
+}
+
+static void le32_put(uint8_t *const dst, const uint32_t val)
+{
+	le16_put(&dst[0], (uint16_t)val);
+	le16_put(&dst[2], (uint16_t)(val >> 16));
+}
+
+static bool silence_write(struct wav *const wav, size_t frames)
+{
+	memset(wav->bytes, 0, sizeof(wav->bytes));
+
+	while (frames != 0) {
+		const size_t num = (frames < CHUNK_FRAMES) ? frames :
+							      CHUNK_FRAMES;
+		const size_t size = num * FRAME_SIZE;
+
+		if (fwrite(wav->bytes, 1, size, wav->out) != size) {
+			return false;
+		}
+		wav->data_size += size;
+		frames -= num;
+	}
+	return true;
+}
+
+static bool chunk_write(struct wav *const wav, const struct chunk *const chunk)
+{
+	if (!silence_write(wav, chunk->silence)) {
+		return false;
+	}
+
+	const size_t size = chunk->frames * FRAME_SIZE;
+
+	for (size_t i = 0; i < (chunk->frames * 2); ++i) {
+		le16_put(&wav->bytes[i * 2], (uint16_t)chunk->samples[i]);
+	}
+
+	if (fwrite(wav->bytes, 1, size, wav->out) != size) {
+		return false;
+	}
+	wav->data_size += size;
+
+	return true;
+}
+
+static void *writer_main(void *const arg)
+{
+	struct wav *const wav = arg;
+
+	pthread_mutex_lock(&wav->mtx);
+
+	for (;;) {
+		while ((wav->head == wav->tail) && !wav->closing) {
+			pthread_cond_wait(&wav->queued_cond, &wav->mtx);
+		}
+
+		if (wav->head == wav->tail) {
+			break;
+		}
+
+		const struct chunk *const chunk =
+			&wav->chunks[wav->head % QUEUE_SIZE];
+		const bool failed = wav->failed;
+
+		// The chunk is not touched by the emulation thread until it is
+		// released below.
+		pthread_mutex_unlock(&wav->mtx);
+
+		// Once writing failed, keep releasing chunks so that closing
+		// never waits forever.
+		const bool ok = failed || chunk_write(wav, chunk);
+		const int error = errno;
+
+		pthread_mutex_lock(&wav->mtx);
+
+		if (!ok && !wav->failed) {
+			wav->failed = true;
+			wav->error = error;
+		}
+		wav->head++;
+
+		pthread_cond_signal(&wav->written_cond);
+	}
+	pthread_mutex_unlock(&wav->mtx);
+
+	return NULL;
+}
+
+/// Retrieves the chunk to fill next.
+///
+/// @param wav The capture.
+/// @param wait Whether to wait for the writer if the ring is full.
+/// @returns The chunk, or `NULL` if the ring is full.
+static struct chunk *chunk_get(struct wav *const wav, const bool wait)
+{
+	pthread_mutex_lock(&wav->mtx);
+
+	while (wait && ((wav->tail - wav->head) >= QUEUE_SIZE)) {
+		pthread_cond_wait(&wav->written_cond, &wav->mtx);
+	}
+
+	const bool full = (wav->tail - wav->head) >= QUEUE_SIZE;
+	pthread_mutex_unlock(&wav->mtx);
+
+	if (full) {
+		return NULL;
+	}
+
+	struct chunk *const chunk = &wav->chunks[wav->tail % QUEUE_SIZE];
+
+	chunk->silence = wav->lost;
+	chunk->frames = 0;
+	wav->lost = 0;
+
+	return chunk;
+}
+
+static void chunk_queue(struct wav *const wav)
+{
+	pthread_mutex_lock(&wav->mtx);
+	wav->tail++;
+	pthread_cond_signal(&wav->queued_cond);
+	pthread_mutex_unlock(&wav->mtx);
+}
+
+/// Moves the ready samples of the audio buffer into the ring.
+///
+/// @param wav The capture.
+/// @param wait Whether to wait for the writer instead of dropping samples.
+static void samples_queue(struct wav *const wav, const bool wait)
+{
+	while (agoge_core_audio_avail(wav->audio) != 0) {
+		struct chunk *const chunk = chunk_get(wav, wait);
+
+		if (chunk == NULL) {
+			const size_t num = agoge_core_audio_read(
+				wav->audio, wav->scratch, CHUNK_FRAMES);
+
+			wav->lost += num;
+			wav->lost_total += num;
+
+			continue;
+		}
+
+		chunk->frames = agoge_core_audio_read(
+			wav->audio, chunk->samples, CHUNK_FRAMES);
+		chunk_queue(wav);
+	}
+}
+
+static bool hdr_write(struct wav *const wav)
+{
+	uint8_t hdr[HDR_SIZE] = "RIFF\0\0\0\0WAVEfmt ";
+
+	le32_put(&hdr[HDR_RIFF_SIZE_OFFSET], SIZE_UNKNOWN);
+	le32_put(&hdr[16], 16);
+
+	// PCM, two channels.
+	le16_put(&hdr[20], 1);
+	le16_put(&hdr[22], 2);
+
+	le32_put(&hdr[24], AGOGE_CORE_AUDIO_RATE);
+	le32_put(&hdr[28], AGOGE_CORE_AUDIO_RATE * FRAME_SIZE);
+	le16_put(&hdr[32], FRAME_SIZE);
+	le16_put(&hdr[34], 16);
+
+	memcpy(&hdr[36], "data", 4);
+	le32_put(&hdr[HDR_DATA_SIZE_OFFSET], SIZE_UNKNOWN);
+
+	return fwrite(hdr, 1, sizeof(hdr), wav->out) == sizeof(hdr);
+}
+
+/// Patches the sizes in the header; does nothing if the output cannot seek,
+/// e.g., a pipe, or the capture is too large for them.
+static bool hdr_patch(struct wav *const wav)
+{
+	if ((wav->data_size > (UINT32_MAX - (HDR_SIZE - 8))) ||
+	    (fseek(wav->out, HDR_RIFF_SIZE_OFFSET, SEEK_SET) != 0)) {
+		return true;
+	}
+
+	uint8_t size[4];
+
+	le32_put(size, (uint32_t)(wav->data_size + (HDR_SIZE - 8)));
+
+	if (fwrite(size, 1, sizeof(size), wav->out) != sizeof(size)) {
+		return false;
+	}
+
+	le32_put(size, (uint32_t)wav->data_size);
+
+	return (fseek(wav->out, HDR_DATA_SIZE_OFFSET, SEEK_SET) == 0) &&
+	       (fwrite(size, 1, sizeof(size), wav->out) == sizeof(size));
+}
+
+struct wav *wav_open(const char *const path)
+{
+	struct wav *const wav = calloc(1, sizeof(*wav));
+
+	if (wav == NULL) {
+		fprintf(stderr, "Unable to allocate audio capture\n");
+		return NULL;
+	}
+
+	wav->audio = agoge_core_audio_create();
+
+	if (wav->audio == NULL) {
+		fprintf(stderr, "Unable to allocate audio buffer\n");
+		free(wav);
+
+		return NULL;
+	}
+
+	// The standard output gets a stream of its own, so that its buffer
+	// goes away with the capture.
+	if (strcmp(path, "-") == 0) {
+		wav->out = fdopen(dup(STDOUT_FILENO), "wb");
+	} else {
+		wav->out = fopen(path, "wb");
+	}
+
+	if (wav->out == NULL) {
+		fprintf(stderr, "Unable to open %s: %s\n", path,
+			strerror(errno));
+
+		agoge_core_audio_destroy(wav->audio);
+		free(wav);
+
+		return NULL;
+	}
+
+	setvbuf(wav->out, wav->out_buf, _IOFBF, sizeof(wav->out_buf));
+
+	if (!hdr_write(wav)) {
+		fprintf(stderr, "Unable to write %s: %s\n", path,
+			strerror(errno));
+
+		fclose(wav->out);
+		agoge_core_audio_destroy(wav->audio);
+		free(wav);
+
+		return NULL;
+	}
+
+	pthread_mutex_init(&wav->mtx, NULL);
+	pthread_cond_init(&wav->queued_cond, NULL);
+	pthread_cond_init(&wav->written_cond, NULL);
+	pthread_create(&wav->thread, NULL, &writer_main, wav);
+
+	return wav;
+}
+
+void wav_attach(struct wav *const wav, struct agoge_core_ctx *const ctx)
+{
+	wav->ctx = ctx;
+	agoge_core_audio_attach(ctx, wav->audio);
+}
+
+void wav_frame(struct wav *const wav)
+{
+	samples_queue(wav, false);
+}
+
+bool wav_failed(struct wav *const wav)
+{
+	pthread_mutex_lock(&wav->mtx);
+	const bool failed = wav->failed;
+	pthread_mutex_unlock(&wav->mtx);
+
+	return failed;
+}
+
+bool wav_close(struct wav *const wav)
+{
+	samples_queue(wav, true);
+
+	// Samples dropped at the very end still take their time.
+	if (wav->lost != 0) {
+		chunk_get(wav, true);
+		chunk_queue(wav);
+	}
+
+	pthread_mutex_lock(&wav->mtx);
+	wav->closing = true;
+	pthread_cond_signal(&wav->queued_cond);
+	pthread_mutex_unlock(&wav->mtx);
+
+	pthread_join(wav->thread, NULL);
+
+	if (wav->ctx != NULL) {
+		agoge_core_audio_attach(wav->ctx, NULL);
+	}
+	agoge_core_audio_destroy(wav->audio);
+
+	bool ok = !wav->failed;
+
+	if (ok && ((fflush(wav->out) != 0) || !hdr_patch(wav))) {
+		ok = false;
+		wav->error = errno;
+	}
+
+	if ((fclose(wav->out) != 0) && ok) {
+		ok = false;
+		wav->error = errno;
+	}
+
+	if (!ok) {
+		fprintf(stderr, "Unable to write audio capture: %s\n",
+			strerror(wav->error));
+	}
+
+	if (wav->lost_total != 0) {
+		fprintf(stderr,
+			"Audio capture fell behind; %" PRIu64
+			" samples were written as silence\n",
+			wav->lost_total);
+	}
+
+	pthread_cond_destroy(&wav->written_cond);
+	pthread_cond_destroy(&wav->queued_cond);
+	pthread_mutex_destroy(&wav->mtx);
+	free(wav);
+
+	return ok;
+}
@@ -0,0 +1,68 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file wav.h Defines the interface of audio captures, which stream the audio
+/// of a context to a WAV file or a pipe.
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "agoge/ctx.h"
+
+struct wav;
+
+/// Opens an audio capture and starts its writer thread. The capture is 16-bit
+/// stereo at `AGOGE_CORE_AUDIO_RATE`.
+///
+/// @param path The file to write, or "-" for the standard output.
+/// @returns The capture, or `NULL` on failure, which is reported on the
+/// standard error.
+struct wav *wav_open(const char *path);
+
+/// Attaches the audio buffer of a capture to a context. The first sample is
+/// at the current cycle of the context, so a capture and a video dump
+/// attached before the same frame start together.
+///
+/// @param wav The capture.
+/// @param ctx The context.
+void wav_attach(struct wav *wav, struct agoge_core_ctx *ctx);
+
+/// Queues the samples of the frames run since the last call; never waits for
+/// the writer thread. Samples which do not fit in the queue are written as
+/// silence instead, so that later samples keep their time.
+///
+/// @param wav The capture.
+void wav_frame(struct wav *wav);
+
+/// Checks whether writing the capture failed, e.g., because the reader of the
+/// pipe went away.
+///
+/// @param wav The capture.
+/// @returns Whether writing the capture failed.
+bool wav_failed(struct wav *wav);
+
+/// Queues the remaining samples, writes them, detaches the capture from its
+/// context, and closes it. The sizes in the header are patched if the output
+/// is seekable.
+///
+/// @param wav The capture.
+/// @returns Whether every sample was written.
+bool wav_close(struct wav *wav);
@@ -0,0 +1,124 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file batch.h Defines the public interface of the batch runner.
+///
+/// The batch runner executes many short, independent emulation jobs across a
+/// work-stealing thread pool. Each worker owns a single context which is reset
+/// and reused for every job it executes.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "agoge/ctx.h"
+
+struct agoge_batch;
+
+/// Defines a single batch job.
+struct agoge_batch_job {
+	/// The cartridge data to run. This is only ever read, and may be
+	/// shared between any number of jobs.
+	uint8_t *rom;
+
+	/// The size of the cartridge data in bytes.
+	size_t rom_size;
+
+	/// The number of steps to run the context for; see
+	/// `agoge_core_ctx_step`.
+	unsigned int num_steps;
+
+	/// The number of frames to run the context for after `num_steps`; see
+	/// `agoge_core_ctx_run_frame`.
+	unsigned int num_frames;
+
+	/// The buttons held down during each of the `num_frames` frames, as
+	/// `AGOGE_CORE_JOYPAD_*` bitmasks. May be `NULL`, in which case no
+	/// button is held. This is only ever read, and may be shared between
+	/// any number of jobs.
+	const uint8_t *joypad;
+
+	/// User data for this job, passed back through the result.
+	void *udata;
+};
+
+/// Defines the result of a single batch job.
+struct agoge_batch_result {
+	/// The job this result belongs to.
+	const struct agoge_batch_job *job;
+
+	/// The index of the job in the job list.
+	size_t job_idx;
+
+	/// The result of inserting the cartridge. If this is not
+	/// `AGOGE_CORE_CART_RETVAL_OK`, the job was not run.
+	enum agoge_core_cart_retval cart_retval;
+
+	/// The context the job ran in. This is only valid for the duration of
+	/// the result callback, after which it is reused for another job.
+	struct agoge_core_ctx *ctx;
+};
+
+/// Defines the configuration of a batch runner.
+struct agoge_batch_cfg {
+	/// The number of worker threads, including the thread calling
+	/// `agoge_batch_run`. If this is zero, the number of online processors
+	/// is used.
+	unsigned int num_threads;
+
+	/// Called once per job after it finishes. This is called from the
+	/// worker thread which ran the job, so it may be called concurrently.
+	void (*result_cb)(const struct agoge_batch_result *res, void *udata);
+
+	/// Called after a context is cleared and before a job starts, so the
+	/// frontend may configure it (e.g., its logger). May be `NULL`.
+	void (*ctx_init_cb)(struct agoge_core_ctx *ctx, void *udata);
+
+	/// User data passed to every callback.
+	void *udata;
+};
+
+/// Creates a batch runner.
+///
+/// @param cfg The configuration of the batch runner.
+/// @returns The batch runner instance, or `NULL` on failure.
+struct agoge_batch *agoge_batch_create(const struct agoge_batch_cfg *cfg);
+
+/// Releases a batch runner.
+///
+/// @param batch The batch runner instance. May be `NULL`.
+void agoge_batch_destroy(struct agoge_batch *batch);
+
+/// Runs every job in a job list, and waits for all of them to complete.
+///
+/// @param batch The batch runner instance.
+/// @param jobs The job list.
+/// @param num_jobs The number of jobs in the job list.
+void agoge_batch_run(struct agoge_batch *batch,
+		     const struct agoge_batch_job *jobs, size_t num_jobs);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,164 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file env.h Defines the public interface of the vectorized environment.
+///
+/// A vectorized environment owns a fixed number of contexts running the same
+/// cartridge, and steps all of them in lockstep across a thread pool. It is
+/// intended for reinforcement learning, where an agent supplies one action per
+/// environment and receives one observation per environment each step.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "agoge/ctx.h"
+
+struct agoge_env;
+
+/// Defines what an observation is made of.
+enum agoge_env_obs {
+	/// The bytes at `obs_addrs`. No frame is rendered and the APU is
+	/// switched off, since neither is observed.
+	AGOGE_ENV_OBS_RAM = 0,
+
+	/// The last frame of a step, packed by `agoge_core_frame_pack_2bpp`.
+	AGOGE_ENV_OBS_FRAME_2BPP = 1,
+
+	/// The last frame of a step as luma, downsampled by
+	/// `agoge_core_frame_downsample` to `frame_width` by `frame_height`.
+	AGOGE_ENV_OBS_FRAME_LUMA = 2
+};
+
+/// Defines the configuration of a vectorized environment.
+struct agoge_env_cfg {
+	/// The number of environments; must not be zero.
+	size_t num_envs;
+
+	/// The number of worker threads, including the thread calling
+	/// `agoge_env_step`. If this is zero, the number of online processors
+	/// is used.
+	unsigned int num_threads;
+
+	/// The number of frames every environment runs for per step; must not
+	/// be zero.
+	unsigned int frames_per_step;
+
+	/// The cartridge data to run in every environment. This must remain
+	/// valid for the lifetime of the environment.
+	uint8_t *rom;
+
+	/// The size of the cartridge data in bytes.
+	size_t rom_size;
+
+	/// With `AGOGE_ENV_OBS_RAM`, the addresses of the bytes making up an
+	/// observation, in order. The list is copied.
+	const uint16_t *obs_addrs;
+
+	/// The number of addresses in `obs_addrs`.
+	size_t num_obs_addrs;
+
+	/// What an observation is made of.
+	enum agoge_env_obs obs;
+
+	/// With `AGOGE_ENV_OBS_FRAME_LUMA`, the size of the downsampled frame;
+	/// zero selects `AGOGE_CORE_FRAME_WIDTH` and `AGOGE_CORE_FRAME_HEIGHT`.
+	unsigned int frame_width;
+	unsigned int frame_height;
+
+	/// With a frame observation, the number of frames stacked into an
+	/// observation, oldest first; zero is treated as one. Only the last
+	/// frame of each step is rendered.
+	unsigned int frame_stack;
+
+	/// Called for every context after it is cleared and before the
+	/// cartridge is inserted, so the frontend may configure it (e.g., its
+	/// logger). May be `NULL`.
+	void (*ctx_init_cb)(struct agoge_core_ctx *ctx, void *udata);
+
+	/// User data passed to `ctx_init_cb`.
+	void *udata;
+};
+
+/// Creates a vectorized environment. Every context is reset, has the cartridge
+/// inserted, and has its initial state stored as its reset snapshot.
+///
+/// All memory the environment needs is allocated here; stepping and resetting
+/// never allocate.
+///
+/// @param cfg The configuration of the environment.
+/// @returns The environment, or `NULL` if memory could not be allocated or the
+/// cartridge was rejected.
+struct agoge_env *agoge_env_create(const struct agoge_env_cfg *cfg);
+
+/// Releases a vectorized environment.
+///
+/// @param env The environment. May be `NULL`.
+void agoge_env_destroy(struct agoge_env *env);
+
+/// @param env The environment.
+/// @returns The size of a single environment's observation in bytes.
+size_t agoge_env_obs_size(const struct agoge_env *env);
+
+/// Retrieves the context of a single environment, e.g., for inspection.
+///
+/// @param env The environment.
+/// @param env_idx The index of the environment.
+/// @returns The context of the environment.
+struct agoge_core_ctx *agoge_env_ctx(struct agoge_env *env, size_t env_idx);
+
+/// Steps every environment in parallel.
+///
+/// @param env The environment.
+/// @param actions One `AGOGE_CORE_JOYPAD_*` bitmask per environment, held for
+/// the whole step.
+/// @param obs The batch observation tensor of `num_envs` rows, each
+/// `agoge_env_obs_size` bytes long. Environment `i` writes its observation at
+/// `obs + (i * agoge_env_obs_size(env))`. May be `NULL`.
+void agoge_env_step(struct agoge_env *env, const uint8_t *actions,
+		    uint8_t *obs);
+
+/// Writes the current observation of every environment without stepping.
+///
+/// @param env The environment.
+/// @param obs The batch observation tensor; see `agoge_env_step`.
+void agoge_env_observe(struct agoge_env *env, uint8_t *obs);
+
+/// Stores the current state of an environment as its reset snapshot.
+///
+/// @param env The environment.
+/// @param env_idx The index of the environment.
+void agoge_env_snapshot_save(struct agoge_env *env, size_t env_idx);
+
+/// Restores an environment from its reset snapshot. A frame stack is filled
+/// with the restored frame.
+///
+/// @param env The environment.
+/// @param env_idx The index of the environment.
+void agoge_env_reset(struct agoge_env *env, size_t env_idx);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,78 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file pool.h Defines the public interface of the work-stealing thread pool.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stddef.h>
+
+/// The maximum number of workers a pool may have, including the calling
+/// thread.
+#define AGOGE_POOL_WORKERS_MAX (256)
+
+struct agoge_pool;
+
+/// Defines a task function executed by the pool.
+///
+/// @param udata The user data passed to `agoge_pool_run`.
+/// @param task_idx The index of the task to execute.
+/// @param worker_idx The index of the worker executing the task. This is
+/// always less than the value returned by `agoge_pool_num_workers`, and no two
+/// tasks will ever run concurrently with the same worker index.
+typedef void (*agoge_pool_task_fn)(void *udata, size_t task_idx,
+				   unsigned int worker_idx);
+
+/// Creates a thread pool.
+///
+/// @param num_workers The number of workers, including the thread calling
+/// `agoge_pool_run`. If this is zero, the number of online processors is used.
+/// @returns The thread pool instance, or `NULL` on failure.
+struct agoge_pool *agoge_pool_create(unsigned int num_workers);
+
+/// Stops every worker thread and releases a thread pool.
+///
+/// @param pool The thread pool instance. May be `NULL`.
+void agoge_pool_destroy(struct agoge_pool *pool);
+
+/// @param pool The thread pool instance.
+/// @returns The number of workers, including the calling thread.
+unsigned int agoge_pool_num_workers(const struct agoge_pool *pool);
+
+/// Runs `num_tasks` tasks across every worker and waits for them to complete.
+///
+/// The tasks are split into contiguous ranges, one per worker. A worker which
+/// exhausts its own range steals half of the remaining range of another
+/// worker, so uneven task lengths do not leave workers idle.
+///
+/// @param pool The thread pool instance.
+/// @param num_tasks The number of tasks to run.
+/// @param fn The task function.
+/// @param udata User data passed to every invocation of `fn`.
+void agoge_pool_run(struct agoge_pool *pool, size_t num_tasks,
+		    agoge_pool_task_fn fn, void *udata);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,141 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file batch.c Defines the implementation of the batch runner.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "agoge/batch.h"
+#include "agoge/pool.h"
+
+struct agoge_batch {
+	struct agoge_batch_cfg cfg;
+	struct agoge_pool *pool;
+
+	/// The job list of the current run.
+	const struct agoge_batch_job *jobs;
+
+	/// One context per worker, reused for every job that worker runs. Each
+	/// is cache line aligned so that workers never share a cache line.
+	struct agoge_core_ctx **ctxs;
+	unsigned int num_ctxs;
+};
+
+static void job_run(void *const udata, const size_t job_idx,
+		    const unsigned int worker_idx)
+{
+	struct agoge_batch *const batch = udata;
+	struct agoge_core_ctx *const ctx = batch->ctxs[worker_idx];
+	const struct agoge_batch_job *const job = &batch->jobs[job_idx];
+
+	agoge_core_ctx_clear(ctx);
+
+	if (batch->cfg.ctx_init_cb != NULL) {
+		batch->cfg.ctx_init_cb(ctx, batch->cfg.udata);
+	}
+	agoge_core_ctx_reset(ctx);
+
+	const struct agoge_batch_result res = {
+		.job = job,
+		.job_idx = job_idx,
+		.cart_retval = agoge_core_cart_set(ctx, job->rom, job->rom_size),
+		.ctx = ctx
+	};
+
+	if (res.cart_retval == AGOGE_CORE_CART_RETVAL_OK) {
+		if (job->num_steps != 0) {
+			agoge_core_ctx_step(ctx, job->num_steps);
+		}
+
+		for (unsigned int i = 0; i < job->num_frames; ++i) {
+			if (job->joypad != NULL) {
+				agoge_core_joypad_set(ctx, job->joypad[i]);
+			}
+			agoge_core_ctx_run_frame(ctx);
+		}
+	}
+
+	if (batch->cfg.result_cb != NULL) {
+		batch->cfg.result_cb(&res, batch->cfg.udata);
+	}
+}
+
+struct agoge_batch *agoge_batch_create(const struct agoge_batch_cfg *const cfg)
+{
+	struct agoge_batch *const batch = calloc(1, sizeof(*batch));
+
+	if (batch == NULL) {
+		return NULL;
+	}
+
+	batch->cfg = *cfg;
+	batch->pool = agoge_pool_create(cfg->num_threads);
+
+	if (batch->pool == NULL) {
+		agoge_batch_destroy(batch);
+		return NULL;
+	}
+
+	const unsigned int num_ctxs = agoge_pool_num_workers(batch->pool);
+	batch->ctxs = calloc(num_ctxs, sizeof(*batch->ctxs));
+
+	if (batch->ctxs == NULL) {
+		agoge_batch_destroy(batch);
+		return NULL;
+	}
+
+	for (; batch->num_ctxs < num_ctxs; ++batch->num_ctxs) {
+		struct agoge_core_ctx *const ctx = agoge_core_ctx_create(
+			NULL, AGOGE_CORE_CTX_ALIGN_CACHE_LINE);
+
+		if (ctx == NULL) {
+			agoge_batch_destroy(batch);
+			return NULL;
+		}
+		batch->ctxs[batch->num_ctxs] = ctx;
+	}
+	return batch;
+}
+
+void agoge_batch_destroy(struct agoge_batch *const batch)
+{
+	if (batch == NULL) {
+		return;
+	}
+
+	agoge_pool_destroy(batch->pool);
+
+	for (unsigned int i = 0; i < batch->num_ctxs; ++i) {
+		agoge_core_ctx_destroy(batch->ctxs[i]);
+	}
+
+	free(batch->ctxs);
+	free(batch);
+}
+
+void agoge_batch_run(struct agoge_batch *const batch,
+		     const struct agoge_batch_job *const jobs,
+		     const size_t num_jobs)
+{
+	batch->jobs = jobs;
+	agoge_pool_run(batch->pool, num_jobs, &job_run, batch);
+	batch->jobs = NULL;
+}
@@ -0,0 +1,355 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file env.c Defines the implementation of the vectorized environment.
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "agoge/env.h"
+#include "agoge/pool.h"
+
+/// The alignment of the context arena.
+#define ARENA_ALIGN (64)
+
+/// The luma of each palette index of a frame observation, white to black.
+static const uint8_t luma_lut[4] = { 0xFF, 0xAA, 0x55, 0x00 };
+
+/// A bump allocator handing out contexts from a single allocation, so that
+/// every context and snapshot of an environment is allocated in one go.
+struct arena {
+	uint8_t *data;
+	size_t size;
+	size_t used;
+};
+
+struct agoge_env {
+	struct agoge_env_cfg cfg;
+	struct agoge_pool *pool;
+	struct arena arena;
+
+	struct agoge_core_ctx **ctxs;
+	struct agoge_core_ctx **snapshots;
+
+	uint16_t *obs_addrs;
+
+	/// The size of an observation, and of a single frame of a frame stack.
+	size_t obs_size;
+	size_t frame_size;
+
+	/// With a frame observation, the frame stack of every environment,
+	/// followed by room for the frame being converted.
+	uint8_t *stacks;
+	unsigned int stack_depth;
+
+	/// The arguments of the current step.
+	const uint8_t *actions;
+	uint8_t *obs;
+};
+
+static void *arena_alloc(void *const udata, const size_t size,
+			 const size_t align)
+{
+	struct arena *const arena = udata;
+	const size_t offset = (arena->used + align - 1) & ~(align - 1);
+
+	if ((offset + size) > arena->size) {
+		return NULL;
+	}
+
+	arena->used = offset + size;
+	return &arena->data[offset];
+}
+
+static uint8_t *stack_get(const struct agoge_env *const env,
+			  const size_t env_idx)
+{
+	return &env->stacks[env_idx * (env->stack_depth + 1) *
+			    env->frame_size];
+}
+
+/// Converts the current frame of an environment to a single frame of its
+/// observation.
+static void frame_convert(const struct agoge_env *const env,
+			  const size_t env_idx, uint8_t *const dst)
+{
+	const uint8_t *const frame = agoge_core_ctx_frame(env->ctxs[env_idx]);
+
+	if (env->cfg.obs == AGOGE_ENV_OBS_FRAME_2BPP) {
+		agoge_core_frame_pack_2bpp(frame, dst);
+		return;
+	}
+	agoge_core_frame_downsample(frame, luma_lut, dst, env->cfg.frame_width,
+				    env->cfg.frame_height,
+				    env->cfg.frame_width);
+}
+
+/// Fills the frame stack of an environment with its current frame.
+static void stack_fill(struct agoge_env *const env, const size_t env_idx)
+{
+	uint8_t *const stack = stack_get(env, env_idx);
+
+	frame_convert(env, env_idx, stack);
+
+	for (unsigned int i = 1; i < env->stack_depth; ++i) {
+		memcpy(&stack[i * env->frame_size], stack, env->frame_size);
+	}
+}
+
+static void observe_one(struct agoge_env *const env, const size_t env_idx)
+{
+	uint8_t *const obs = &env->obs[env_idx * env->obs_size];
+
+	if (env->cfg.obs == AGOGE_ENV_OBS_RAM) {
+		agoge_core_bus_gather(env->ctxs[env_idx], env->obs_addrs,
+				      env->cfg.num_obs_addrs, obs);
+		return;
+	}
+	memcpy(obs, stack_get(env, env_idx), env->obs_size);
+}
+
+static void step_one(void *const udata, const size_t env_idx,
+		     const unsigned int worker_idx)
+{
+	(void)worker_idx;
+
+	struct agoge_env *const env = udata;
+	struct agoge_core_ctx *const ctx = env->ctxs[env_idx];
+
+	agoge_core_joypad_set(ctx, env->actions[env_idx]);
+
+	if (env->cfg.obs == AGOGE_ENV_OBS_RAM) {
+		for (unsigned int i = 0; i < env->cfg.frames_per_step; ++i) {
+			agoge_core_ctx_run_frame(ctx);
+		}
+	} else {
+		// Only the last frame of a step is observed, so it is the only
+		// one rendered.
+		for (unsigned int i = 1; i <= env->cfg.frames_per_step; ++i) {
+			agoge_core_ppu_render_set(
+				ctx,
+				(i == env->cfg.frames_per_step) ?
+					AGOGE_CORE_PPU_RENDER_ALL :
+					AGOGE_CORE_PPU_RENDER_NONE,
+				1);
+			agoge_core_ctx_run_frame(ctx);
+		}
+
+		uint8_t *const stack = stack_get(env, env_idx);
+		uint8_t *const frame = &stack[env->obs_size];
+
+		frame_convert(env, env_idx, frame);
+		agoge_core_frame_stack_push(stack, env->frame_size,
+					    env->stack_depth, frame);
+	}
+
+	if (env->obs != NULL) {
+		observe_one(env, env_idx);
+	}
+}
+
+static void observe_task(void *const udata, const size_t env_idx,
+			 const unsigned int worker_idx)
+{
+	(void)worker_idx;
+	observe_one(udata, env_idx);
+}
+
+static bool ctxs_init(struct agoge_env *const env)
+{
+	const struct agoge_core_ctx_allocator allocator = {
+		.alloc = &arena_alloc,
+		.free = NULL,
+		.udata = &env->arena
+	};
+
+	for (size_t i = 0; i < env->cfg.num_envs; ++i) {
+		struct agoge_core_ctx *const ctx = agoge_core_ctx_create(
+			&allocator, AGOGE_CORE_CTX_ALIGN_CACHE_LINE);
+
+		struct agoge_core_ctx *const snapshot = agoge_core_ctx_create(
+			&allocator, AGOGE_CORE_CTX_ALIGN_CACHE_LINE);
+
+		if ((ctx == NULL) || (snapshot == NULL)) {
+			return false;
+		}
+
+		if (env->cfg.ctx_init_cb != NULL) {
+			env->cfg.ctx_init_cb(ctx, env->cfg.udata);
+		}
+
+		// Neither frames nor audio make up a RAM observation. Both
+		// settings survive resets and restoring the snapshot.
+		if (env->cfg.obs == AGOGE_ENV_OBS_RAM) {
+			agoge_core_ppu_render_set(
+				ctx, AGOGE_CORE_PPU_RENDER_NONE, 1);
+			agoge_core_apu_level_set(ctx, AGOGE_CORE_APU_LEVEL_OFF);
+		}
+		agoge_core_ctx_reset(ctx);
+
+		if (agoge_core_cart_set(ctx, env->cfg.rom, env->cfg.rom_size) !=
+		    AGOGE_CORE_CART_RETVAL_OK) {
+			return false;
+		}
+
+		env->ctxs[i] = ctx;
+		env->snapshots[i] = snapshot;
+
+		agoge_env_snapshot_save(env, i);
+
+		if (env->cfg.obs != AGOGE_ENV_OBS_RAM) {
+			stack_fill(env, i);
+		}
+	}
+	return true;
+}
+
+struct agoge_env *agoge_env_create(const struct agoge_env_cfg *const cfg)
+{
+	struct agoge_env *const env = calloc(1, sizeof(*env));
+
+	if (env == NULL) {
+		return NULL;
+	}
+
+	env->cfg = *cfg;
+
+	switch (cfg->obs) {
+	case AGOGE_ENV_OBS_FRAME_2BPP:
+		env->frame_size = AGOGE_CORE_FRAME_2BPP_SIZE;
+		break;
+
+	case AGOGE_ENV_OBS_FRAME_LUMA:
+		if ((env->cfg.frame_width == 0) ||
+		    (env->cfg.frame_height == 0)) {
+			env->cfg.frame_width = AGOGE_CORE_FRAME_WIDTH;
+			env->cfg.frame_height = AGOGE_CORE_FRAME_HEIGHT;
+		}
+		env->frame_size = (size_t)env->cfg.frame_width *
+				  env->cfg.frame_height;
+		break;
+
+	case AGOGE_ENV_OBS_RAM:
+	default:
+		env->obs_size = cfg->num_obs_addrs;
+		break;
+	}
+
+	if (env->frame_size != 0) {
+		env->stack_depth = (cfg->frame_stack != 0) ? cfg->frame_stack :
+							     1;
+		env->obs_size = env->frame_size * env->stack_depth;
+		env->stacks = malloc(cfg->num_envs * (env->stack_depth + 1) *
+				     env->frame_size);
+	}
+
+	// Every environment needs a context and a snapshot.
+	env->arena.size = agoge_core_ctx_size(AGOGE_CORE_CTX_ALIGN_CACHE_LINE) *
+			  cfg->num_envs * 2;
+
+	env->arena.data = aligned_alloc(ARENA_ALIGN, env->arena.size);
+	env->ctxs = calloc(cfg->num_envs, sizeof(*env->ctxs));
+	env->snapshots = calloc(cfg->num_envs, sizeof(*env->snapshots));
+	env->obs_addrs = malloc(
+		(cfg->num_obs_addrs + 1) * sizeof(*cfg->obs_addrs));
+
+	env->pool = agoge_pool_create(cfg->num_threads);
+
+	if ((env->arena.data == NULL) || (env->ctxs == NULL) ||
+	    (env->snapshots == NULL) || (env->obs_addrs == NULL) ||
+	    (env->pool == NULL) ||
+	    ((env->frame_size != 0) && (env->stacks == NULL))) {
+		agoge_env_destroy(env);
+		return NULL;
+	}
+
+	if (cfg->num_obs_addrs != 0) {
+		memcpy(env->obs_addrs, cfg->obs_addrs,
+		       cfg->num_obs_addrs * sizeof(*cfg->obs_addrs));
+	}
+
+	if (!ctxs_init(env)) {
+		agoge_env_destroy(env);
+		return NULL;
+	}
+	return env;
+}
+
+void agoge_env_destroy(struct agoge_env *const env)
+{
+	if (env == NULL) {
+		return;
+	}
+
+	// The contexts live in the arena, so they are released along with it.
+	agoge_pool_destroy(env->pool);
+	free(env->stacks);
+	free(env->obs_addrs);
+	free(env->snapshots);
+	free(env->ctxs);
+	free(env->arena.data);
+	free(env);
+}
+
+__attribute__((pure)) size_t
+agoge_env_obs_size(const struct agoge_env *const env)
+{
+	return env->obs_size;
+}
+
+__attribute__((pure)) struct agoge_core_ctx *
+agoge_env_ctx(struct agoge_env *const env, const size_t env_idx)
+{
+	return env->ctxs[env_idx];
+}
+
+void agoge_env_step(struct agoge_env *const env, const uint8_t *const actions,
+		    uint8_t *const obs)
+{
+	env->actions = actions;
+	env->obs = obs;
+
+	agoge_pool_run(env->pool, env->cfg.num_envs, &step_one, env);
+
+	env->actions = NULL;
+	env->obs = NULL;
+}
+
+void agoge_env_observe(struct agoge_env *const env, uint8_t *const obs)
+{
+	env->obs = obs;
+	agoge_pool_run(env->pool, env->cfg.num_envs, &observe_task, env);
+	env->obs = NULL;
+}
+
+void agoge_env_snapshot_save(struct agoge_env *const env, const size_t env_idx)
+{
+	agoge_core_ctx_copy(env->snapshots[env_idx], env->ctxs[env_idx]);
+}
+
+void agoge_env_reset(struct agoge_env *const env, const size_t env_idx)
+{
+	agoge_core_ctx_copy(env->ctxs[env_idx], env->snapshots[env_idx]);
+
+	if (env->cfg.obs != AGOGE_ENV_OBS_RAM) {
+		stack_fill(env, env_idx);
+	}
+}
@@ -0,0 +1,340 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file pool.c Defines the implementation of the work-stealing thread pool.
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "agoge/pool.h"
+
+/// The assumed size of a cache line in bytes. Each worker's task range lives
+/// on its own cache line so that workers popping tasks do not contend with
+/// each other.
+#define CACHE_LINE_SIZE (64)
+
+// A task range is packed into a single 64-bit word so that the owner popping
+// from the front and thieves stealing from the back can both update it with a
+// single compare-and-swap.
+#define RANGE_PACK(begin, end) (((uint64_t)(begin) << 32) | (uint64_t)(end))
+#define RANGE_BEGIN(range) ((size_t)((range) >> 32))
+#define RANGE_END(range) ((size_t)((range) & UINT32_MAX))
+
+/// The largest number of tasks whose ranges can be packed; larger runs are
+/// split into rounds of this many tasks.
+#define ROUND_TASKS_MAX ((size_t)UINT32_MAX)
+
+struct worker {
+	/// The range of tasks not yet claimed by any worker.
+	_Alignas(CACHE_LINE_SIZE) _Atomic uint64_t range;
+
+	/// The pool this worker belongs to.
+	struct agoge_pool *pool;
+
+	/// The thread of this worker; unused for worker 0, which is always the
+	/// thread calling `agoge_pool_run`.
+	pthread_t thread;
+
+	/// The index of this worker.
+	unsigned int idx;
+};
+
+struct agoge_pool {
+	pthread_mutex_t mtx;
+
+	/// Signalled when a new batch of tasks is available, or when the pool
+	/// is being destroyed.
+	pthread_cond_t start_cond;
+
+	/// Signalled when the last worker thread finishes its tasks.
+	pthread_cond_t done_cond;
+
+	/// Incremented every time a new batch of tasks is started.
+	unsigned long gen;
+
+	/// The number of worker threads which have not yet finished the
+	/// current batch of tasks.
+	unsigned int num_pending;
+
+	/// Whether or not the worker threads should exit.
+	bool quit;
+
+	agoge_pool_task_fn fn;
+	void *udata;
+
+	/// The index of the first task of the current round.
+	size_t task_base;
+
+	unsigned int num_workers;
+	struct worker workers[];
+};
+
+static bool range_pop(_Atomic uint64_t *const range, size_t *const task)
+{
+	uint64_t old = atomic_load_explicit(range, memory_order_relaxed);
+
+	for (;;) {
+		const size_t begin = RANGE_BEGIN(old);
+		const size_t end = RANGE_END(old);
+
+		if (begin >= end) {
+			return false;
+		}
+
+		if (atomic_compare_exchange_weak_explicit(
+			    range, &old, RANGE_PACK(begin + 1, end),
+			    memory_order_acquire, memory_order_relaxed)) {
+			*task = begin;
+			return true;
+		}
+	}
+}
+
+static bool steal(struct agoge_pool *const pool, struct worker *const self)
+{
+	for (unsigned int i = 1; i < pool->num_workers; ++i) {
+		struct worker *const victim =
+			&pool->workers[(self->idx + i) % pool->num_workers];
+
+		uint64_t old =
+			atomic_load_explicit(&victim->range, memory_order_relaxed);
+
+		for (;;) {
+			const size_t begin = RANGE_BEGIN(old);
+			const size_t end = RANGE_END(old);
+
+			if (begin >= end) {
+				break;
+			}
+
+			// The victim keeps the lower half, the thief takes the
+			// upper half; a single remaining task goes to the
+			// thief.
+			const size_t mid = begin + ((end - begin) / 2);
+
+			if (atomic_compare_exchange_weak_explicit(
+				    &victim->range, &old,
+				    RANGE_PACK(begin, mid),
+				    memory_order_acquire,
+				    memory_order_relaxed)) {
+				atomic_store_explicit(&self->range,
+						      RANGE_PACK(mid, end),
+						      memory_order_relaxed);
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+static void work(struct worker *const self)
+{
+	struct agoge_pool *const pool = self->pool;
+
+	do {
+		size_t task;
+
+		while (range_pop(&self->range, &task)) {
+			pool->fn(pool->udata, pool->task_base + task,
+				 self->idx);
+		}
+	} while (steal(pool, self));
+}
+
+static void *worker_main(void *const arg)
+{
+	struct worker *const self = arg;
+	struct agoge_pool *const pool = self->pool;
+
+	unsigned long gen = 0;
+
+	pthread_mutex_lock(&pool->mtx);
+
+	for (;;) {
+		while ((pool->gen == gen) && !pool->quit) {
+			pthread_cond_wait(&pool->start_cond, &pool->mtx);
+		}
+
+		if (pool->quit) {
+			break;
+		}
+
+		gen = pool->gen;
+		pthread_mutex_unlock(&pool->mtx);
+
+		work(self);
+
+		pthread_mutex_lock(&pool->mtx);
+
+		if (--pool->num_pending == 0) {
+			pthread_cond_signal(&pool->done_cond);
+		}
+	}
+	pthread_mutex_unlock(&pool->mtx);
+	return NULL;
+}
+
+static void threads_stop(struct agoge_pool *const pool,
+			 const unsigned int num_threads)
+{
+	pthread_mutex_lock(&pool->mtx);
+	pool->quit = true;
+	pthread_cond_broadcast(&pool->start_cond);
+	pthread_mutex_unlock(&pool->mtx);
+
+	for (unsigned int i = 1; i < num_threads; ++i) {
+		pthread_join(pool->workers[i].thread, NULL);
+	}
+}
+
+static void pool_free(struct agoge_pool *const pool)
+{
+	pthread_cond_destroy(&pool->done_cond);
+	pthread_cond_destroy(&pool->start_cond);
+	pthread_mutex_destroy(&pool->mtx);
+
+	free(pool);
+}
+
+struct agoge_pool *agoge_pool_create(unsigned int num_workers)
+{
+	if (num_workers == 0) {
+		const long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		num_workers = (num_cpus > 0) ? (unsigned int)num_cpus : 1;
+	}
+
+	if (num_workers > AGOGE_POOL_WORKERS_MAX) {
+		num_workers = AGOGE_POOL_WORKERS_MAX;
+	}
+
+	const size_t size = sizeof(struct agoge_pool) +
+			    (sizeof(struct worker) * num_workers);
+
+	// aligned_alloc() requires the size to be a multiple of the alignment.
+	struct agoge_pool *const pool = aligned_alloc(
+		CACHE_LINE_SIZE,
+		(size + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1));
+
+	if (pool == NULL) {
+		return NULL;
+	}
+
+	pthread_mutex_init(&pool->mtx, NULL);
+	pthread_cond_init(&pool->start_cond, NULL);
+	pthread_cond_init(&pool->done_cond, NULL);
+
+	pool->gen = 0;
+	pool->num_pending = 0;
+	pool->quit = false;
+	pool->fn = NULL;
+	pool->udata = NULL;
+	pool->task_base = 0;
+	pool->num_workers = num_workers;
+
+	for (unsigned int i = 0; i < num_workers; ++i) {
+		struct worker *const worker = &pool->workers[i];
+
+		atomic_init(&worker->range, RANGE_PACK(0, 0));
+		worker->pool = pool;
+		worker->idx = i;
+	}
+
+	for (unsigned int i = 1; i < num_workers; ++i) {
+		if (pthread_create(&pool->workers[i].thread, NULL, &worker_main,
+				   &pool->workers[i]) != 0) {
+			threads_stop(pool, i);
+			pool_free(pool);
+
+			return NULL;
+		}
+	}
+	return pool;
+}
+
+void agoge_pool_destroy(struct agoge_pool *const pool)
+{
+	if (pool == NULL) {
+		return;
+	}
+
+	threads_stop(pool, pool->num_workers);
+	pool_free(pool);
+}
+
+__attribute__((pure)) unsigned int
+agoge_pool_num_workers(const struct agoge_pool *const pool)
+{
+	return pool->num_workers;
+}
+
+/// Runs a round of at most `ROUND_TASKS_MAX` tasks, starting at a task index.
+static void round_run(struct agoge_pool *const pool, const size_t task_base,
+		      const size_t num_tasks)
+{
+	const unsigned int num_workers = pool->num_workers;
+
+	for (unsigned int i = 0; i < num_workers; ++i) {
+		const size_t begin = (num_tasks * i) / num_workers;
+		const size_t end = (num_tasks * (i + 1)) / num_workers;
+
+		atomic_store_explicit(&pool->workers[i].range,
+				      RANGE_PACK(begin, end),
+				      memory_order_relaxed);
+	}
+
+	pthread_mutex_lock(&pool->mtx);
+
+	pool->task_base = task_base;
+	pool->num_pending = num_workers - 1;
+	pool->gen++;
+
+	pthread_cond_broadcast(&pool->start_cond);
+	pthread_mutex_unlock(&pool->mtx);
+
+	work(&pool->workers[0]);
+
+	pthread_mutex_lock(&pool->mtx);
+
+	while (pool->num_pending != 0) {
+		pthread_cond_wait(&pool->done_cond, &pool->mtx);
+	}
+	pthread_mutex_unlock(&pool->mtx);
+}
+
+void agoge_pool_run(struct agoge_pool *const pool, const size_t num_tasks,
+		    const agoge_pool_task_fn fn, void *const udata)
+{
+	pool->fn = fn;
+	pool->udata = udata;
+
+	// Task ranges are packed into 32-bit halves.
+	for (size_t base = 0; base < num_tasks;) {
+		const size_t left = num_tasks - base;
+		const size_t num = (left < ROUND_TASKS_MAX) ? left :
+							      ROUND_TASKS_MAX;
+
+		round_run(pool, base, num);
+		base += num;
+	}
+}
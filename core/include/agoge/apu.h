@@ -0,0 +1,149 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file apu.h Defines the public interface of the audio processing unit.
+///
+/// The APU does not run along with the CPU. It stays dormant, and catches up
+/// to the current cycle only when a sound register is accessed and at the end
+/// of every frame. Catching up jumps from one event to the next: frame
+/// sequencer steps, and the cycles at which the output of a channel changes.
+/// Square and wave channels skip every step of their waveform that keeps the
+/// same level, and silent channels schedule nothing at all, so the cost of
+/// sound scales with the number of edges of the waveforms rather than with
+/// cycles.
+///
+/// Each change of the mixed output is added to the audio buffer attached to
+/// the context, if any, as a band-limited step; see `agoge_core_audio_attach`.
+///
+/// With `AGOGE_CORE_APU_LEVEL_OFF`, the APU keeps only what the registers
+/// show. It skips every waveform and the catch-up at the end of frames; the
+/// frame sequencer steps it missed are run when a sound register is next
+/// accessed, and skipped outright while no channel is on.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct agoge_core_audio;
+struct agoge_core_ctx;
+
+/// The number of sound registers, $FF10-$FF2F.
+#define AGOGE_CORE_APU_NUM_REGS (32)
+
+/// The size of wave RAM, $FF30-$FF3F, in bytes.
+#define AGOGE_CORE_APU_WAVE_SIZE (16)
+
+/// The number of channels.
+#define AGOGE_CORE_APU_NUM_CHS (4)
+
+/// Defines how much of the APU runs. Register reads, including whether the
+/// channels are on in NR52, do not depend on it.
+enum agoge_core_apu_level {
+	/// Every channel is synthesized into the attached audio buffer, if any.
+	AGOGE_CORE_APU_LEVEL_FULL = 0,
+
+	/// Length counters, envelopes, the sweep and whether the channels are
+	/// on are kept, lazily, when a sound register is accessed. No sample is
+	/// generated; the attached audio buffer, if any, receives nothing.
+	AGOGE_CORE_APU_LEVEL_OFF = 1
+};
+
+/// Defines the state of a channel.
+struct agoge_core_apu_ch {
+	/// The value of `cpu.cycles` at which the output next changes, or
+	/// `UINT64_MAX` if it does not change until a register is written.
+	uint64_t next;
+
+	/// The value of `cpu.cycles` at which the waveform last stepped.
+	uint64_t last;
+
+	/// The frequency of a square or wave channel.
+	uint16_t freq;
+
+	/// The length counter; the channel turns off when it expires.
+	uint16_t length;
+
+	/// The linear feedback shift register of the noise channel.
+	uint16_t lfsr;
+
+	/// The step of the duty cycle, or the sample of wave RAM, played.
+	uint8_t pos;
+
+	/// The output, from 0 to 15.
+	uint8_t out;
+
+	/// The volume and the state of the envelope.
+	uint8_t volume;
+	uint8_t env_timer;
+
+	/// Whether the channel is on, reported in NR52.
+	bool on;
+};
+
+/// Defines the audio processing unit.
+struct agoge_core_apu {
+	/// The value of `cpu.cycles` the APU caught up to.
+	uint64_t cycles;
+
+	/// The value of `cpu.cycles` of the next frame sequencer step.
+	uint64_t seq_next;
+
+	/// The step of the frame sequencer, from 0 to 7.
+	uint8_t seq_step;
+
+	/// The state of the frequency sweep of channel 1.
+	uint8_t sweep_timer;
+	bool sweep_enabled;
+	uint16_t sweep_freq;
+
+	/// The mixed output of the left and right channels.
+	int16_t mix[2];
+
+	/// How much of the APU runs. Loading a state keeps it.
+	uint8_t level;
+
+	/// The sound registers, as last written.
+	uint8_t regs[AGOGE_CORE_APU_NUM_REGS];
+
+	/// Wave RAM; two 4-bit samples per byte, high nibble first.
+	uint8_t wave[AGOGE_CORE_APU_WAVE_SIZE];
+
+	struct agoge_core_apu_ch ch[AGOGE_CORE_APU_NUM_CHS];
+
+	/// The audio buffer receiving the output, if any. Loading a state keeps
+	/// it.
+	struct agoge_core_audio *audio;
+};
+
+/// Selects how much of the APU of a context runs, from now on.
+///
+/// @param ctx The context.
+/// @param level How much of the APU runs.
+void agoge_core_apu_level_set(struct agoge_core_ctx *ctx,
+			      enum agoge_core_apu_level level);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,95 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file audio.h Defines the public interface of audio buffers.
+///
+/// An audio buffer receives the output of the APU as band-limited steps: each
+/// change of level is added as a windowed-sinc step response at its exact
+/// sub-sample position into a buffer of deltas, which is integrated into
+/// samples when read. Synthesis thus costs a fixed number of taps per edge of
+/// the waveforms, with no aliasing from the square waves, however high their
+/// frequency.
+///
+/// Samples come out at `AGOGE_CORE_AUDIO_RATE`, interleaved left then right,
+/// with the DC offset of the DMG output filtered out. An audio buffer belongs
+/// to the thread running its context.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct agoge_core_ctx;
+struct agoge_core_audio;
+
+/// The number of T-cycles per sample of an audio buffer.
+#define AGOGE_CORE_AUDIO_CYCLES_PER_SAMPLE (64)
+
+/// The sample rate of an audio buffer in Hz; `AGOGE_CORE_CYCLES_PER_SEC`
+/// divided by `AGOGE_CORE_AUDIO_CYCLES_PER_SAMPLE`.
+#define AGOGE_CORE_AUDIO_RATE (65536)
+
+/// The number of samples per channel an audio buffer holds, i.e., a quarter of
+/// a second. Output beyond it is dropped until samples are read.
+#define AGOGE_CORE_AUDIO_FRAMES_MAX (16384)
+
+/// Creates an audio buffer.
+///
+/// @returns The audio buffer, or `NULL` if memory could not be allocated.
+struct agoge_core_audio *agoge_core_audio_create(void);
+
+/// Destroys an audio buffer. It must be detached first.
+///
+/// @param audio The audio buffer; may be `NULL`.
+void agoge_core_audio_destroy(struct agoge_core_audio *audio);
+
+/// Attaches an audio buffer to a context, or detaches the current one. A
+/// buffer must be attached to at most one context; it starts empty at the
+/// current cycle of the context.
+///
+/// @param ctx The context.
+/// @param audio The audio buffer, or `NULL` to discard the output of the APU.
+void agoge_core_audio_attach(struct agoge_core_ctx *ctx,
+			     struct agoge_core_audio *audio);
+
+/// Retrieves the number of samples per channel ready to be read. Samples are
+/// ready up to the cycle the APU caught up to, i.e., at least up to the end of
+/// the last frame run.
+///
+/// @param audio The audio buffer.
+/// @returns The number of samples per channel ready.
+size_t agoge_core_audio_avail(const struct agoge_core_audio *audio);
+
+/// Reads samples from an audio buffer.
+///
+/// @param audio The audio buffer.
+/// @param dst The destination; `2 * max_frames` samples, left then right.
+/// @param max_frames The largest number of samples per channel to read.
+/// @returns The number of samples per channel read.
+size_t agoge_core_audio_read(struct agoge_core_audio *audio, int16_t *dst,
+			     size_t max_frames);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -27,6 +27,7 @@ extern "C" {
 #endif // __cplusplus
 
 #include "cart.h"
+#include "palette.h"
 
 struct agoge_core_ctx;
 
@@ -36,16 +37,71 @@ struct agoge_core_ctx;
 /// The size of the work RAM (WRAM) in bytes.
 #define AGOGE_CORE_BUS_WRAM_SIZE (8192)
 
+/// The number of address bits covered by a single page of the page map.
+#define AGOGE_CORE_BUS_PAGE_SHIFT (13)
+
+/// The size of a single page of the page map in bytes.
+#define AGOGE_CORE_BUS_PAGE_SIZE (1 << AGOGE_CORE_BUS_PAGE_SHIFT)
+
+/// The number of pages in the page map.
+#define AGOGE_CORE_BUS_NUM_PAGES (65536 / AGOGE_CORE_BUS_PAGE_SIZE)
+
+/// The size of the video RAM (VRAM) in bytes.
+#define AGOGE_CORE_BUS_VRAM_SIZE (8192)
+
+/// The size of the object attribute memory (OAM) in bytes.
+#define AGOGE_CORE_BUS_OAM_SIZE (160)
+
 #define AGOGE_CORE_BUS_SERIAL_SIZE (128)
 
+/// Defines the memory regions which may be viewed directly.
+enum agoge_core_bus_region {
+	AGOGE_CORE_BUS_REGION_WRAM = 0,
+	AGOGE_CORE_BUS_REGION_HRAM = 1,
+	AGOGE_CORE_BUS_REGION_VRAM = 2,
+	AGOGE_CORE_BUS_REGION_OAM = 3,
+	AGOGE_CORE_BUS_REGION_CART_RAM = 4
+};
+
+/// Defines a read-only view of a memory region.
+struct agoge_core_bus_span {
+	/// The contents of the region, or `NULL` if the region does not exist.
+	const uint8_t *data;
+
+	/// The size of the region in bytes.
+	size_t size;
+
+	/// The emulated address of the first byte of the region.
+	uint16_t addr;
+};
+
 /// Defines the system bus contents.
+///
+/// Members are ordered by access frequency: the cartridge state and page map
+/// used on every memory access come first so that they share the first cache
+/// lines with the CPU registers, and the serial buffer, which is only used for
+/// debug output, comes last.
 struct agoge_core_bus {
-	uint8_t wram[AGOGE_CORE_BUS_WRAM_SIZE];
-	uint8_t hram[AGOGE_CORE_BUS_HRAM_SIZE];
-
 	/// The cartridge instance to use for the system bus.
 	struct agoge_core_cart cart;
 
+	/// The host memory backing each page of the address space for reads,
+	/// or `NULL` if reads from the page must be dispatched. This is purely
+	/// an accelerator; every page may be `NULL`.
+	const uint8_t *read_map[AGOGE_CORE_BUS_NUM_PAGES];
+
+	/// The host memory backing each page of the address space for writes,
+	/// or `NULL` if writes to the page must be dispatched.
+	uint8_t *write_map[AGOGE_CORE_BUS_NUM_PAGES];
+
+	uint8_t hram[AGOGE_CORE_BUS_HRAM_SIZE];
+	uint8_t wram[AGOGE_CORE_BUS_WRAM_SIZE];
+	uint8_t vram[AGOGE_CORE_BUS_VRAM_SIZE];
+	uint8_t oam[AGOGE_CORE_BUS_OAM_SIZE];
+
+	/// The CGB palette RAM.
+	struct agoge_core_palette palette;
+
 	struct {
 		char data[AGOGE_CORE_BUS_SERIAL_SIZE];
 		size_t data_size;
@@ -55,11 +111,70 @@ struct agoge_core_bus {
 /// @brief Retrieves a byte from an emulated memory address without interfering
 /// with emulation operations.
 ///
+/// Peeking never has side effects, even on I/O registers.
+///
 /// @param ctx The system bus instance.
 /// @param addr The address to retrieve a byte from.
 /// @returns The byte retrieved from the emulated memory map.
 uint8_t agoge_core_bus_peek(struct agoge_core_ctx *ctx, uint16_t addr);
 
+/// @brief Retrieves a range of bytes from the emulated memory map without
+/// interfering with emulation operations.
+///
+/// Every page backed by host memory is copied with a single `memcpy`; only the
+/// remaining addresses are peeked one at a time. The range wraps around at
+/// $FFFF.
+///
+/// @param ctx The emulator context.
+/// @param addr The first address to retrieve a byte from.
+/// @param dst The destination.
+/// @param size The number of bytes to retrieve; at most 65536.
+void agoge_core_bus_peek_range(struct agoge_core_ctx *ctx, uint16_t addr,
+			       uint8_t *dst, size_t size);
+
+/// @brief Stores a range of bytes into the emulated memory map without
+/// interfering with emulation operations.
+///
+/// Writes to RAM and I/O registers change their contents without triggering
+/// any side effects, and writes to ROM are ignored. The range wraps around at
+/// $FFFF.
+///
+/// @param ctx The emulator context.
+/// @param addr The first address to store a byte at.
+/// @param src The source.
+/// @param size The number of bytes to store; at most 65536.
+void agoge_core_bus_poke_range(struct agoge_core_ctx *ctx, uint16_t addr,
+			       const uint8_t *src, size_t size);
+
+/// @brief Retrieves a read-only view of a memory region.
+///
+/// The view points directly into the context, so it remains valid and
+/// reflects the current contents of the region for the lifetime of the
+/// context; it only needs to be retrieved once.
+///
+/// @param ctx The emulator context.
+/// @param region The region to view.
+/// @param bank The bank of the region to view; only meaningful for banked
+/// regions, and ignored otherwise.
+/// @returns The view of the region. If the region does not exist (e.g., the
+/// cartridge has no RAM), the view is empty.
+struct agoge_core_bus_span
+agoge_core_bus_view(const struct agoge_core_ctx *ctx,
+		    enum agoge_core_bus_region region, unsigned int bank);
+
+/// @brief Retrieves the bytes at a list of emulated memory addresses without
+/// interfering with emulation operations.
+///
+/// Addresses backed by memory are read directly, without dispatching through
+/// the system bus.
+///
+/// @param ctx The emulator context.
+/// @param addrs The addresses to retrieve bytes from.
+/// @param num_addrs The number of addresses in `addrs`.
+/// @param dst The destination; `dst[i]` receives the byte at `addrs[i]`.
+void agoge_core_bus_gather(struct agoge_core_ctx *ctx, const uint16_t *addrs,
+			   size_t num_addrs, uint8_t *dst);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -40,7 +40,7 @@ struct agoge_core_cart {
 	/// all times if a cartridge is "inserted".
 	uint8_t *data;
 
-	uint8_t (*banked_read_cb)(struct agoge_core_ctx *ctx, uint16_t addr);
+	/// The ROM bank mapped at $4000-$7FFF.
 	unsigned int rom_bank;
 };
 
@@ -0,0 +1,110 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file cheats.h Defines the public interface of cheat codes.
+///
+/// Game Genie codes patch ROM. Each patch is installed as a copy-on-write
+/// override of the affected 8 KiB ROM pages in the page map of the system
+/// bus, so patched ROM is read exactly like unpatched ROM. A compare value is
+/// checked against each ROM bank separately, and a bank is only patched if it
+/// holds the compare value.
+///
+/// GameShark codes write to RAM. They are applied as one batch at each frame
+/// boundary.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// The maximum number of GameShark codes in a cheat set.
+#define AGOGE_CORE_CHEATS_GAMESHARK_MAX (64)
+
+struct agoge_core_ctx;
+struct agoge_core_cheats;
+
+/// Defines the return values of `agoge_core_cheats_add`.
+enum agoge_core_cheats_retval {
+	/// The code is neither a Game Genie nor a GameShark code.
+	AGOGE_CORE_CHEATS_RETVAL_INVALID_CODE,
+
+	/// The cheat set already holds `AGOGE_CORE_CHEATS_GAMESHARK_MAX`
+	/// GameShark codes.
+	AGOGE_CORE_CHEATS_RETVAL_FULL,
+
+	/// Memory for the patched ROM pages could not be allocated.
+	AGOGE_CORE_CHEATS_RETVAL_NO_MEM,
+
+	/// The code was added.
+	AGOGE_CORE_CHEATS_RETVAL_OK
+};
+
+/// Creates an empty cheat set for a ROM.
+///
+/// @param rom The ROM to patch. It must outlive the cheat set, and must be
+/// the same memory passed to `agoge_core_cart_set`.
+/// @param rom_size The size of the ROM in bytes.
+/// @returns The cheat set, or `NULL` if memory could not be allocated.
+struct agoge_core_cheats *agoge_core_cheats_create(const uint8_t *rom,
+						   size_t rom_size);
+
+/// Releases a cheat set. It must not be attached to any context.
+///
+/// @param cheats The cheat set to release. May be `NULL`.
+void agoge_core_cheats_destroy(struct agoge_core_cheats *cheats);
+
+/// Adds a code to a cheat set. Game Genie codes are written as `ABC-DEF` or
+/// `ABC-DEF-GHI`, and GameShark codes as `TTVVLLHH`; dashes are optional.
+///
+/// Contexts the cheat set is attached to only pick up Game Genie codes once
+/// they are attached again.
+///
+/// @param cheats The cheat set.
+/// @param code The code to add.
+/// @returns A value of `enum agoge_core_cheats_retval`.
+enum agoge_core_cheats_retval
+agoge_core_cheats_add(struct agoge_core_cheats *cheats, const char *code);
+
+/// Removes every code from a cheat set. Contexts the cheat set is attached to
+/// read the unpatched ROM right away; the memory of the patched ROM pages is
+/// kept until the cheat set is destroyed.
+///
+/// @param cheats The cheat set.
+void agoge_core_cheats_clear(struct agoge_core_cheats *cheats);
+
+/// Attaches a cheat set to a context, replacing any cheat set previously
+/// attached. Game Genie codes only apply while the cartridge of the context is
+/// the ROM of the cheat set.
+///
+/// A cheat set may be attached to any number of contexts, which only read it;
+/// copies of a context made by `agoge_core_ctx_copy` share it.
+///
+/// @param ctx The emulator context.
+/// @param cheats The cheat set to attach, or `NULL` to detach the current one.
+void agoge_core_cheats_attach(struct agoge_core_ctx *ctx,
+			      struct agoge_core_cheats *cheats);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
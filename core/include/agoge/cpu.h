@@ -24,6 +24,7 @@
 extern "C" {
 #endif // __cplusplus
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #define AGOGE_CORE_REG_PAIR_DEFINE(hi, lo, pair) \
@@ -47,6 +48,28 @@ struct agoge_core_cpu {
 		uint16_t pc;
 		uint16_t sp;
 	} reg;
+
+	/// The number of T-cycles executed since the context was created.
+	uint64_t cycles;
+
+	/// The value of `cycles` at which the interpreter returns control to
+	/// the scheduler.
+	uint64_t run_end;
+
+	/// The interrupt enable (IE) register.
+	uint8_t ie;
+
+	/// The interrupt flag (IF) register.
+	uint8_t ifr;
+
+	/// The interrupt master enable (IME) flag.
+	bool ime;
+
+	/// Set by `EI`; IME is set once the instruction following it completes.
+	bool ime_pending;
+
+	/// Set while the CPU is halted, waiting for an interrupt.
+	bool halted;
 };
 
 #ifdef __cplusplus
@@ -26,34 +26,175 @@
 extern "C" {
 #endif // __cplusplus
 
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "apu.h"
 #include "cpu.h"
 #include "bus.h"
+#include "cheats.h"
 #include "disasm.h"
+#include "joypad.h"
 #include "log.h"
+#include "ppu.h"
 
 /// Defines an agoge context.
 ///
 /// An `agoge_core_ctx` is a full, self-contained and isolated emulator
 /// instance. The majority of functions frontends use will be used through a
-/// given context.
-struct agoge_core_ctx {
-	/// The system bus instance to use for this context.
-	struct agoge_core_bus bus;
+/// given context. Its layout is private to the core, so that it may change
+/// between versions; contexts are created by `agoge_core_ctx_create`.
+struct agoge_core_ctx;
+
+/// The number of T-cycles in a single frame.
+#define AGOGE_CORE_FRAME_CYCLES (70224)
+
+/// The number of T-cycles in a second.
+#define AGOGE_CORE_CYCLES_PER_SEC (4194304)
 
-	/// The logger instance to use for this context.
-	struct agoge_core_log log;
+/// Defines a caller-supplied allocator for contexts.
+struct agoge_core_ctx_allocator {
+	/// Allocates memory for a context.
+	///
+	/// @param udata The user data of this allocator.
+	/// @param size The number of bytes to allocate; always a multiple of
+	/// `align`.
+	/// @param align The required alignment of the memory in bytes; always a
+	/// power of two.
+	/// @returns The allocated memory, or `NULL` on failure.
+	void *(*alloc)(void *udata, size_t size, size_t align);
 
-	/// The CPU instance to use for this context.
-	struct agoge_core_cpu cpu;
+	/// Releases memory previously returned by `alloc`. May be `NULL`, e.g.,
+	/// for arenas which are released in bulk.
+	///
+	/// @param udata The user data of this allocator.
+	/// @param ptr The memory to release.
+	/// @param size The size that was passed to `alloc`.
+	void (*free)(void *udata, void *ptr, size_t size);
 
-	/// The disassembler instance to use for this context.
-	struct agoge_core_disasm disasm;
+	/// User data passed to `alloc` and `free`.
+	void *udata;
 };
 
+/// Defines the alignment of a context created by `agoge_core_ctx_create`.
+enum agoge_core_ctx_align {
+	/// Align the context to a cache line (64 bytes), so that adjacent
+	/// contexts never share a cache line.
+	AGOGE_CORE_CTX_ALIGN_CACHE_LINE = 0,
+
+	/// Align the context to, and pad it to a multiple of, a huge page
+	/// (2 MiB). When the default allocator is used on Linux, the kernel is
+	/// advised to back the context with transparent huge pages.
+	AGOGE_CORE_CTX_ALIGN_HUGEPAGE = 1
+};
+
+/// Retrieves the number of bytes a context occupies, which may grow between
+/// versions. Frontends use it when reserving memory for contexts, e.g., for an
+/// arena allocator.
+///
+/// @param align The alignment the context will be created with.
+/// @returns The number of bytes `agoge_core_ctx_create` requests from an
+/// allocator for a single context.
+size_t agoge_core_ctx_size(enum agoge_core_ctx_align align);
+
+/// Creates a zero-initialized context.
+///
+/// @param allocator The allocator to use, or `NULL` to use the default
+/// allocator. The allocator is copied into the context and used to release
+/// it.
+/// @param align The alignment of the context.
+/// @returns The context, or `NULL` on allocation failure.
+struct agoge_core_ctx *
+agoge_core_ctx_create(const struct agoge_core_ctx_allocator *allocator,
+		      enum agoge_core_ctx_align align);
+
+/// Releases a context created by `agoge_core_ctx_create`.
+///
+/// @param ctx The context to release. May be `NULL`.
+void agoge_core_ctx_destroy(struct agoge_core_ctx *ctx);
+
+/// Clears a context to the state `agoge_core_ctx_create` returned it in, e.g.,
+/// to reuse it for another job. Its allocator is kept.
+///
+/// @param ctx The context to clear.
+void agoge_core_ctx_clear(struct agoge_core_ctx *ctx);
+
 void agoge_core_ctx_reset(struct agoge_core_ctx *ctx);
 
+/// Copies the emulation state of one context into another, e.g., to save or
+/// restore a snapshot. Contexts must not be copied with `memcpy`, as they hold
+/// pointers into themselves. The render level, renderer, video output, audio
+/// buffer and APU level of `dst` are kept.
+///
+/// @param dst The context to copy into.
+/// @param src The context to copy from.
+void agoge_core_ctx_copy(struct agoge_core_ctx *dst,
+			 const struct agoge_core_ctx *src);
+
+/// Retrieves the size of a save state in bytes.
+///
+/// @returns The size of a save state in bytes.
+size_t agoge_core_ctx_state_size(void);
+
+/// Saves the emulation state of a context. The save state holds no host
+/// pointers, and may be loaded into any context running the same cartridge
+/// on a host with the same byte order.
+///
+/// @param ctx The emulator context.
+/// @param dst The destination; `agoge_core_ctx_state_size()` bytes, aligned
+/// as memory returned by `malloc`.
+void agoge_core_ctx_state_save(const struct agoge_core_ctx *ctx, void *dst);
+
+/// Loads a save state created by `agoge_core_ctx_state_save` into a context.
+/// The cartridge, cheats and logger of the context are kept.
+///
+/// @param ctx The emulator context.
+/// @param src The save state; `agoge_core_ctx_state_size()` bytes, aligned as
+/// memory returned by `malloc`.
+/// @returns `true` if the save state was loaded, or `false` if it is not a
+/// save state of this version, in which case the context is unchanged.
+bool agoge_core_ctx_state_load(struct agoge_core_ctx *ctx, const void *src);
+
+/// Runs a context for at least the given number of T-cycles. Instructions are
+/// never split, so the context may run for slightly longer.
+///
+/// @param ctx The emulator context.
+/// @param num_cycles The number of T-cycles to run for; must not be zero.
 void agoge_core_ctx_step(struct agoge_core_ctx *ctx, unsigned int num_cycles);
 
+/// Runs a context until the start of the next VBlank period, or for
+/// `AGOGE_CORE_FRAME_CYCLES` T-cycles while the LCD is off.
+///
+/// @param ctx The emulator context.
+void agoge_core_ctx_run_frame(struct agoge_core_ctx *ctx);
+
+/// Retrieves the logger of a context, so the frontend may set its callback,
+/// level and channels.
+///
+/// @param ctx The emulator context.
+/// @returns The logger.
+struct agoge_core_log *agoge_core_ctx_log(struct agoge_core_ctx *ctx);
+
+/// Retrieves the last rendered frame of a context; see
+/// `agoge_core_ppu_frame_hash` for when it is complete.
+///
+/// @param ctx The emulator context.
+/// @returns The frame of palette indices; `AGOGE_CORE_FRAME_SIZE` bytes.
+const uint8_t *agoge_core_ctx_frame(const struct agoge_core_ctx *ctx);
+
+/// Retrieves the PPU state of a context, e.g., for `agoge_core_delta_encode`.
+///
+/// @param ctx The emulator context.
+/// @returns The PPU state.
+const struct agoge_core_ppu *
+agoge_core_ctx_ppu(const struct agoge_core_ctx *ctx);
+
+/// Retrieves the video output of a context; see `agoge_core_video_set`.
+///
+/// @param ctx The emulator context.
+/// @returns The video output.
+struct agoge_core_video *agoge_core_ctx_video(struct agoge_core_ctx *ctx);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -0,0 +1,137 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file delta.h Defines the public interface of frame-delta encoding.
+///
+/// The PPU hashes every scanline as it completes it, and keeps one bit per
+/// scanline set if the last rendered frame changed it. A delta encoder keeps
+/// the hashes of the scanlines it has emitted, so it only compares 144 hashes
+/// per frame and emits the scanlines that differ from what the viewer has,
+/// however many frames went by since the previous delta. A static screen
+/// costs a two-byte delta and no pixel reads at all.
+///
+/// A delta is a header followed by one record per changed scanline:
+///
+/// | Offset | Size | Field                                     |
+/// |--------|------|-------------------------------------------|
+/// | 0      | 1    | reserved; zero                            |
+/// | 1      | 1    | the number of records                     |
+///
+/// | Offset | Size | Field                                     |
+/// |--------|------|-------------------------------------------|
+/// | 0      | 1    | the scanline, from 0 to 143               |
+/// | 1      | 1    | the encoding; see `agoge_core_delta_enc`  |
+/// | 2      | ...  | the encoded scanline                      |
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "frame.h"
+
+struct agoge_core_ppu;
+
+/// The size of a delta header in bytes.
+#define AGOGE_CORE_DELTA_HDR_SIZE (2)
+
+/// The size of a scanline packed to 2 bits per pixel in bytes.
+#define AGOGE_CORE_DELTA_LINE_2BPP_SIZE (AGOGE_CORE_FRAME_WIDTH / 4)
+
+/// The largest size of the record of a scanline in bytes.
+#define AGOGE_CORE_DELTA_REC_SIZE_MAX (2 + AGOGE_CORE_DELTA_LINE_2BPP_SIZE)
+
+/// The largest size of a delta in bytes; every scanline changed, none of them
+/// compressible.
+#define AGOGE_CORE_DELTA_SIZE_MAX    \
+	(AGOGE_CORE_DELTA_HDR_SIZE + \
+	 (AGOGE_CORE_FRAME_HEIGHT * AGOGE_CORE_DELTA_REC_SIZE_MAX))
+
+/// Defines the encodings of a scanline in a delta.
+enum agoge_core_delta_enc {
+	/// `AGOGE_CORE_DELTA_LINE_2BPP_SIZE` bytes; four shades per byte with
+	/// the leftmost pixel in the least significant bits, as packed by
+	/// `agoge_core_frame_pack_2bpp`.
+	AGOGE_CORE_DELTA_ENC_2BPP = 0,
+
+	/// Runs of equal shades until the scanline is complete; each run is one
+	/// byte, the shade in bits 6-7 and the length minus one in bits 0-5.
+	AGOGE_CORE_DELTA_ENC_RLE = 1
+};
+
+/// Defines the flags of `agoge_core_delta_encode`.
+enum agoge_core_delta_flag {
+	/// Run-length encode a scanline when that makes it smaller.
+	AGOGE_CORE_DELTA_FLAG_RLE = (1 << 0),
+
+	/// Emit every scanline, e.g., for a viewer that just connected.
+	AGOGE_CORE_DELTA_FLAG_KEYFRAME = (1 << 1)
+};
+
+/// Defines a delta encoder; one per stream.
+struct agoge_core_delta {
+	/// The hash of each scanline last emitted.
+	uint64_t line_hash[AGOGE_CORE_FRAME_HEIGHT];
+
+	/// Whether `line_hash` is valid, i.e., a keyframe was emitted.
+	bool valid;
+};
+
+/// Resets a delta encoder; its next delta is a keyframe.
+///
+/// @param delta The delta encoder.
+void agoge_core_delta_reset(struct agoge_core_delta *delta);
+
+/// Encodes the scanlines of the frame of a PPU that changed since the previous
+/// delta. Call it in VBlank, or after `agoge_core_ctx_run_frame`, to encode a
+/// complete frame.
+///
+/// While a renderer is attached to a context with the fast backend, the PPU of
+/// the context renders nothing; encode the PPU returned by
+/// `agoge_core_render_ppu` on the render thread instead.
+///
+/// @param delta The delta encoder.
+/// @param ppu The PPU of a context.
+/// @param flags Any of `agoge_core_delta_flag`.
+/// @param dst The destination; `AGOGE_CORE_DELTA_SIZE_MAX` bytes.
+/// @returns The size of the delta in bytes.
+size_t agoge_core_delta_encode(struct agoge_core_delta *delta,
+			       const struct agoge_core_ppu *ppu,
+			       unsigned int flags, uint8_t *dst);
+
+/// Applies a delta to a frame on the viewer side.
+///
+/// @param src The delta.
+/// @param size The size of `src` in bytes.
+/// @param frame The frame; `AGOGE_CORE_FRAME_SIZE` bytes, one shade per
+/// pixel.
+/// @returns Whether the delta was well-formed. A malformed delta may have
+/// changed part of `frame`.
+bool agoge_core_delta_decode(const uint8_t *src, size_t size,
+			     uint8_t *frame);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
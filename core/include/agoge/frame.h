@@ -0,0 +1,124 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file frame.h Defines the public interface of the frame post-processing
+/// kernels.
+///
+/// These kernels convert a frame of 2-bit palette indices, as produced by the
+/// core, into the compact formats consumed by reinforcement learning and
+/// streaming frontends. Each kernel reads the source frame directly; no
+/// intermediate frames are produced. SSE2 and AVX2 implementations are
+/// selected at runtime when the host supports them.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// The width of a frame in pixels.
+#define AGOGE_CORE_FRAME_WIDTH (160)
+
+/// The height of a frame in pixels.
+#define AGOGE_CORE_FRAME_HEIGHT (144)
+
+/// The size of a frame of palette indices in bytes.
+#define AGOGE_CORE_FRAME_SIZE (AGOGE_CORE_FRAME_WIDTH * AGOGE_CORE_FRAME_HEIGHT)
+
+/// The size of a frame packed by `agoge_core_frame_pack_2bpp` in bytes.
+#define AGOGE_CORE_FRAME_2BPP_SIZE (AGOGE_CORE_FRAME_SIZE / 4)
+
+/// Converts a frame of palette indices to 8-bit luma.
+///
+/// @param src The source frame; `AGOGE_CORE_FRAME_WIDTH` bytes per row, with
+/// only the low two bits of each byte used.
+/// @param lut The luma of each of the four palette indices.
+/// @param dst The destination frame.
+/// @param dst_stride The number of bytes between rows of `dst`.
+void agoge_core_frame_luma(const uint8_t *src, const uint8_t lut[4],
+			   uint8_t *dst, size_t dst_stride);
+
+/// Converts a frame of palette indices to 8-bit luma and downsamples it by
+/// area averaging, e.g., to the 84x84 frames common in reinforcement learning.
+///
+/// @param src The source frame; see `agoge_core_frame_luma`.
+/// @param lut The luma of each of the four palette indices.
+/// @param dst The destination frame.
+/// @param dst_width The width of the destination frame, from 1 to
+/// `AGOGE_CORE_FRAME_WIDTH`.
+/// @param dst_height The height of the destination frame, from 1 to
+/// `AGOGE_CORE_FRAME_HEIGHT`.
+/// @param dst_stride The number of bytes between rows of `dst`.
+void agoge_core_frame_downsample(const uint8_t *src, const uint8_t lut[4],
+				 uint8_t *dst, unsigned int dst_width,
+				 unsigned int dst_height, size_t dst_stride);
+
+/// Converts a frame of palette indices to 32-bit host pixels, e.g., RGBA8888.
+///
+/// @param src The source frame; see `agoge_core_frame_luma`.
+/// @param lut The pixel of each of the four palette indices, already in the
+/// byte order of the destination; the same call serves RGBA8888 and BGRA8888.
+/// @param dst The destination frame.
+/// @param dst_stride The number of bytes between rows of `dst`; a multiple of
+/// 4.
+void agoge_core_frame_rgba8888(const uint8_t *src, const uint32_t lut[4],
+			       void *dst, size_t dst_stride);
+
+/// Converts a frame of palette indices to 16-bit host pixels, e.g., RGB565.
+///
+/// @param src The source frame; see `agoge_core_frame_luma`.
+/// @param lut The pixel of each of the four palette indices.
+/// @param dst The destination frame.
+/// @param dst_stride The number of bytes between rows of `dst`; a multiple of
+/// 2.
+void agoge_core_frame_rgb565(const uint8_t *src, const uint16_t lut[4],
+			     void *dst, size_t dst_stride);
+
+/// Packs a frame of palette indices to 2 bits per pixel, four pixels per byte
+/// with the leftmost pixel in the least significant bits.
+///
+/// @param src The source frame; see `agoge_core_frame_luma`.
+/// @param dst The destination; `AGOGE_CORE_FRAME_2BPP_SIZE` bytes.
+void agoge_core_frame_pack_2bpp(const uint8_t *src, uint8_t *dst);
+
+/// Hashes a frame of palette indices, e.g., a golden screenshot. The PPU
+/// computes the same hash line by line as it renders; see
+/// `agoge_core_ppu_frame_hash`. It detects changes, but is not cryptographic.
+///
+/// @param src The source frame; see `agoge_core_frame_luma`.
+/// @returns The hash.
+uint64_t agoge_core_frame_hash(const uint8_t *src);
+
+/// Pushes an observation onto a frame stack laid out as `depth` consecutive
+/// observations, oldest first. The oldest observation is discarded.
+///
+/// @param stack The frame stack; `depth * obs_size` bytes.
+/// @param obs_size The size of a single observation in bytes.
+/// @param depth The number of observations in the stack; must not be zero.
+/// @param obs The observation to push.
+void agoge_core_frame_stack_push(uint8_t *stack, size_t obs_size,
+				 unsigned int depth, const uint8_t *obs);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,60 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file joypad.h Defines the public interface of the joypad.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdint.h>
+
+struct agoge_core_ctx;
+
+#define AGOGE_CORE_JOYPAD_RIGHT (1 << 0)
+#define AGOGE_CORE_JOYPAD_LEFT (1 << 1)
+#define AGOGE_CORE_JOYPAD_UP (1 << 2)
+#define AGOGE_CORE_JOYPAD_DOWN (1 << 3)
+#define AGOGE_CORE_JOYPAD_A (1 << 4)
+#define AGOGE_CORE_JOYPAD_B (1 << 5)
+#define AGOGE_CORE_JOYPAD_SELECT (1 << 6)
+#define AGOGE_CORE_JOYPAD_START (1 << 7)
+
+/// Defines the joypad contents.
+struct agoge_core_joypad {
+	/// The buttons currently held down; see `AGOGE_CORE_JOYPAD_*`.
+	uint8_t buttons;
+
+	/// The button groups selected through the P1 register, as written by
+	/// the game (bits 4 and 5).
+	uint8_t sel;
+};
+
+/// Sets the buttons currently held down.
+///
+/// @param ctx The emulator context.
+/// @param buttons A bitmask of `AGOGE_CORE_JOYPAD_*` values.
+void agoge_core_joypad_set(struct agoge_core_ctx *ctx, uint8_t buttons);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,90 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file palette.h Defines the public interface of the CGB palette RAM.
+///
+/// The CGB holds eight background and eight sprite palettes of four colors
+/// each, in BGR555, behind the BCPS/BCPD ($FF68-$FF69) and OCPS/OCPD
+/// ($FF6A-$FF6B) registers. Every color is also kept converted to a host
+/// pixel, so that rendering reads converted colors directly; a color is only
+/// converted again when palette RAM is written, with a single load from a
+/// precomputed table covering all 32768 BGR555 colors, optionally corrected to
+/// approximate the colors of the CGB LCD.
+///
+/// The registers only respond to cartridges flagged for the CGB in their
+/// header; for other cartridges they read as $FF and ignore writes, as on the
+/// DMG.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct agoge_core_ctx;
+
+/// The number of palettes of each kind.
+#define AGOGE_CORE_PALETTE_NUM (8)
+
+/// The number of colors of a palette.
+#define AGOGE_CORE_PALETTE_COLORS (4)
+
+/// The size of the palette RAM of each kind in bytes.
+#define AGOGE_CORE_PALETTE_RAM_SIZE \
+	(AGOGE_CORE_PALETTE_NUM * AGOGE_CORE_PALETTE_COLORS * 2)
+
+/// Defines the CGB palette RAM.
+struct agoge_core_palette {
+	/// The BCPS and OCPS registers: the byte of palette RAM accessed
+	/// through BCPD and OCPD in bits 0-5, and whether it is incremented on
+	/// writes in bit 7.
+	uint8_t bcps;
+	uint8_t ocps;
+
+	/// Whether colors are corrected for the CGB LCD. Loading a state keeps
+	/// it.
+	bool correct;
+
+	/// The background and sprite palette RAM; two bytes of BGR555 per
+	/// color, low byte first.
+	uint8_t bg_ram[AGOGE_CORE_PALETTE_RAM_SIZE];
+	uint8_t obj_ram[AGOGE_CORE_PALETTE_RAM_SIZE];
+
+	/// The colors of `bg_ram` and `obj_ram` converted to host pixels, with
+	/// red, green, blue and alpha bytes in memory order, i.e.,
+	/// `AGOGE_CORE_VIDEO_FORMAT_RGBA8888`.
+	uint32_t bg[AGOGE_CORE_PALETTE_NUM][AGOGE_CORE_PALETTE_COLORS];
+	uint32_t obj[AGOGE_CORE_PALETTE_NUM][AGOGE_CORE_PALETTE_COLORS];
+};
+
+/// Selects whether colors are corrected for the CGB LCD, and converts every
+/// color again.
+///
+/// @param ctx The context.
+/// @param correct Whether to correct colors.
+void agoge_core_palette_correction_set(struct agoge_core_ctx *ctx,
+				       bool correct);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
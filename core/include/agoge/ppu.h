@@ -0,0 +1,272 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file ppu.h Defines the public interface of the picture processing unit.
+///
+/// The PPU has two backends, selected per context at reset through a table of
+/// functions. The fast backend renders a whole scanline at a time when the
+/// scanline leaves a fixed-length mode 3. The accurate backend runs the pixel
+/// FIFOs dot by dot, so that mode 3 lasts as long as scrolling, the window and
+/// sprites make it, and register writes in the middle of a scanline take
+/// effect on the following pixels.
+///
+/// Tiles are decoded from 2bpp into palette indices once and kept in a cache;
+/// a write to tile data in VRAM only marks the tile as dirty, and the tile is
+/// decoded again the next time it is fetched, with SIMD kernels where the host
+/// supports them. Background, window and sprite fetches are then plain byte
+/// copies out of the cache.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "frame.h"
+#include "video.h"
+
+struct agoge_core_ctx;
+struct agoge_core_render;
+struct ppu_backend;
+struct ppu_kernels;
+
+/// The number of tiles in VRAM.
+#define AGOGE_CORE_PPU_NUM_TILES (384)
+
+/// The width and height of a tile in pixels.
+#define AGOGE_CORE_PPU_TILE_SIZE (8)
+
+/// Defines the modes of the PPU, as reported in STAT.
+enum agoge_core_ppu_mode {
+	AGOGE_CORE_PPU_MODE_HBLANK = 0,
+	AGOGE_CORE_PPU_MODE_VBLANK = 1,
+	AGOGE_CORE_PPU_MODE_OAM = 2,
+	AGOGE_CORE_PPU_MODE_DRAW = 3
+};
+
+/// The maximum number of sprites on a scanline.
+#define AGOGE_CORE_PPU_LINE_OBJS_MAX (10)
+
+/// Defines the rendering backends of the PPU.
+enum agoge_core_ppu_backend {
+	/// The backend selected at build time: the accurate backend if the
+	/// core was built with `AGOGE_PPU_ACCURATE`, the fast backend
+	/// otherwise.
+	AGOGE_CORE_PPU_BACKEND_DEFAULT = 0,
+
+	/// Renders whole scanlines; mode 3 always lasts 172 T-cycles.
+	AGOGE_CORE_PPU_BACKEND_FAST = 1,
+
+	/// Renders dot by dot through the pixel FIFOs.
+	AGOGE_CORE_PPU_BACKEND_ACCURATE = 2
+};
+
+/// Defines how many frames the PPU renders. Timing, STAT, LY and interrupts do
+/// not depend on it; frames that are not rendered skip all tile decoding and
+/// leave the frame buffer untouched.
+enum agoge_core_ppu_render {
+	/// Every frame is rendered.
+	AGOGE_CORE_PPU_RENDER_ALL = 0,
+
+	/// One frame in every `render_interval` frames is rendered.
+	AGOGE_CORE_PPU_RENDER_NTH = 1,
+
+	/// No frame is rendered.
+	AGOGE_CORE_PPU_RENDER_NONE = 2
+};
+
+/// Defines the state of the pixel FIFOs of the accurate backend during mode 3.
+struct agoge_core_ppu_fifo {
+	/// The value of `cpu.cycles` of the next dot to run.
+	uint64_t cycle;
+
+	/// The value of `cpu.cycles` at which mode 3 started.
+	uint64_t draw_start;
+
+	/// The background FIFO; `bg_len` pixels starting at `bg_pos`.
+	uint8_t bg[AGOGE_CORE_PPU_TILE_SIZE];
+	uint8_t bg_pos;
+	uint8_t bg_len;
+
+	/// The sprite FIFO, indexed by screen X modulo 8. Each pixel is its
+	/// color, ORed with the palette and priority bits of its attributes;
+	/// zero if transparent.
+	uint8_t obj[AGOGE_CORE_PPU_TILE_SIZE];
+
+	/// The row of the tile fetched last.
+	uint8_t row[AGOGE_CORE_PPU_TILE_SIZE];
+
+	/// The number of dots the fetcher spent on the current tile.
+	uint8_t step;
+
+	/// The tile column fetched next, relative to the start of the
+	/// background or window.
+	uint8_t fetch_x;
+
+	/// The screen X of the pixel output next.
+	uint8_t lx;
+
+	/// The number of pixels to discard before output.
+	uint8_t discard;
+
+	/// The number of dots before the fetcher starts.
+	uint8_t delay;
+
+	/// The sprites found on this line by the OAM scan, in OAM order.
+	uint8_t objs[AGOGE_CORE_PPU_LINE_OBJS_MAX];
+	uint8_t num_objs;
+
+	/// One bit per entry of `objs`, set once the sprite was fetched.
+	uint16_t objs_done;
+
+	/// The entry of `objs` being fetched.
+	uint8_t obj_cur;
+
+	/// The number of dots left in the sprite fetch; zero if none is in
+	/// progress.
+	uint8_t obj_dots;
+
+	/// Whether a sprite fetch waits for the background fetcher.
+	bool obj_pending;
+
+	/// Whether the fetcher fetches the window.
+	bool window;
+};
+
+/// Defines the picture processing unit.
+struct agoge_core_ppu {
+	/// The value of `cpu.cycles` at which the PPU next changes mode.
+	uint64_t next_event;
+
+	/// The number of frames completed; incremented on entering VBlank, or
+	/// every `AGOGE_CORE_FRAME_CYCLES` T-cycles while the LCD is off.
+	uint64_t frames;
+
+	uint8_t lcdc;
+	uint8_t stat;
+	uint8_t scy;
+	uint8_t scx;
+	uint8_t ly;
+	uint8_t lyc;
+	uint8_t dma;
+	uint8_t bgp;
+	uint8_t obp0;
+	uint8_t obp1;
+	uint8_t wy;
+	uint8_t wx;
+
+	/// The current mode.
+	uint8_t mode;
+
+	/// The line of the window drawn next.
+	uint8_t window_line;
+
+	/// The state of the STAT interrupt line; STAT interrupts are requested
+	/// on its rising edge.
+	bool stat_line;
+
+	/// The backend to select at reset; a save state restores the backend
+	/// it was saved with.
+	uint8_t backend;
+
+	/// How many frames to render, and the interval of
+	/// `AGOGE_CORE_PPU_RENDER_NTH`. Loading a state keeps them.
+	uint8_t render;
+	uint32_t render_interval;
+
+	/// Whether the current frame is not rendered.
+	bool skip;
+
+	/// The renderer rendering scanlines on another thread, if any; see
+	/// `agoge_core_render_attach`. Loading a state keeps it.
+	struct agoge_core_render *renderer;
+
+	/// The video output; see `agoge_core_video_set`. Loading a state keeps
+	/// it.
+	struct agoge_core_video video;
+
+	/// The functions of the backend, and the kernels for the host; both
+	/// selected at reset. Save states do not include them.
+	const struct ppu_backend *ops;
+	const struct ppu_kernels *kernels;
+
+	/// The state of the accurate backend.
+	struct agoge_core_ppu_fifo fifo;
+
+	/// One bit per tile, set if the tile must be decoded again.
+	uint64_t tiles_dirty[AGOGE_CORE_PPU_NUM_TILES / 64];
+
+	/// The decoded tiles; one palette index per pixel.
+	uint8_t tiles[AGOGE_CORE_PPU_NUM_TILES][AGOGE_CORE_PPU_TILE_SIZE]
+		     [AGOGE_CORE_PPU_TILE_SIZE];
+
+	/// The hash of each line of `frame`, updated as the line is rendered.
+	uint64_t line_hash[AGOGE_CORE_FRAME_HEIGHT];
+
+	/// One bit per line, set if the line differs from the same line of the
+	/// previous rendered frame; complete while in VBlank.
+	uint64_t lines_changed[(AGOGE_CORE_FRAME_HEIGHT + 63) / 64];
+
+	/// The hash of the lines of the current frame rendered so far, and of
+	/// the last complete rendered frame.
+	uint64_t hash;
+	uint64_t frame_hash;
+
+	/// The frame being rendered; one shade (0-3, after the palette) per
+	/// pixel. It holds the last complete frame while in VBlank.
+	uint8_t frame[AGOGE_CORE_FRAME_SIZE];
+};
+
+/// Selects the rendering backend of a context. It takes effect at the next
+/// reset; until the first call, contexts use `AGOGE_CORE_PPU_BACKEND_DEFAULT`.
+///
+/// @param ctx The context.
+/// @param backend The backend.
+void agoge_core_ppu_backend_set(struct agoge_core_ctx *ctx,
+				enum agoge_core_ppu_backend backend);
+
+/// Selects how many frames a context renders, from the next frame on.
+///
+/// @param ctx The context.
+/// @param render How many frames to render.
+/// @param interval With `AGOGE_CORE_PPU_RENDER_NTH`, the interval between
+/// rendered frames; not zero. Frames whose number in `frames` is a multiple
+/// of it are rendered.
+void agoge_core_ppu_render_set(struct agoge_core_ctx *ctx,
+			       enum agoge_core_ppu_render render,
+			       uint32_t interval);
+
+/// Retrieves the hash of the last complete rendered frame of a context. The
+/// PPU computes it line by line while rendering, so it costs no pass over the
+/// frame; it equals `agoge_core_frame_hash` of the frame.
+///
+/// While a renderer is attached with the fast backend, the context renders
+/// nothing; use `agoge_core_render_frame_hash` instead.
+///
+/// @param ctx The context.
+/// @returns The hash.
+uint64_t agoge_core_ppu_frame_hash(const struct agoge_core_ctx *ctx);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
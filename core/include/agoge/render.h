@@ -0,0 +1,128 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file render.h Defines the public interface of off-thread rendering.
+///
+/// A renderer takes pixel rendering off the emulation thread. Once attached to
+/// a context, the PPU no longer renders scanlines itself: at the end of mode 3
+/// it records the registers the scanline depends on, and it records every
+/// write to VRAM and OAM. The records go through a single-producer,
+/// single-consumer lock-free queue to a render thread owned by the frontend,
+/// which replays them into its own copy of VRAM and OAM and renders the
+/// scanlines with the same code as the PPU.
+///
+/// Nothing the emulated system can observe depends on rendering, so timing
+/// and the emulated state are identical with and without a renderer. Only the
+/// fast backend hands scanlines to the renderer; the accurate backend renders
+/// mid-scanline effects that per-scanline records cannot reproduce, and keeps
+/// rendering on the emulation thread.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "video.h"
+
+/// The number of records the queue of a renderer holds. The emulation thread
+/// waits for the render thread while the queue is full, unless the renderer
+/// is stopped.
+#define AGOGE_CORE_RENDER_QUEUE_SIZE (65536)
+
+struct agoge_core_ctx;
+struct agoge_core_ppu;
+struct agoge_core_render;
+
+/// Creates a renderer.
+///
+/// @returns The renderer, or `NULL` if memory could not be allocated.
+struct agoge_core_render *agoge_core_render_create(void);
+
+/// Destroys a renderer. It must be detached first.
+///
+/// @param render The renderer; may be `NULL`.
+void agoge_core_render_destroy(struct agoge_core_render *render);
+
+/// Attaches a renderer to a context, or detaches the current one. Called on
+/// the emulation thread; a renderer must be attached to at most one context.
+/// The current contents of VRAM and OAM are queued first.
+///
+/// @param ctx The context.
+/// @param render The renderer, or `NULL` to render on the emulation thread
+/// again.
+void agoge_core_render_attach(struct agoge_core_ctx *ctx,
+			      struct agoge_core_render *render);
+
+/// Replays queued records on the render thread until a frame is complete or
+/// the queue is empty.
+///
+/// @param render The renderer.
+/// @returns Whether a frame was completed. It stays in the frame returned by
+/// `agoge_core_render_frame` until the next call.
+bool agoge_core_render_run(struct agoge_core_render *render);
+
+/// Stops a renderer, e.g., as its render thread exits. The emulation thread no
+/// longer waits for room in the queue from then on, and drops the records
+/// which do not fit; the renderer must still be detached before it is
+/// destroyed.
+///
+/// @param render The renderer.
+void agoge_core_render_stop(struct agoge_core_render *render);
+
+/// Retrieves the frame of a renderer, laid out as the frame of the PPU.
+///
+/// @param render The renderer.
+/// @returns The frame; `AGOGE_CORE_FRAME_SIZE` bytes.
+const uint8_t *agoge_core_render_frame(const struct agoge_core_render *render);
+
+/// Retrieves the PPU state of a renderer, whose frame, line hashes and changed
+/// lines are kept up to date as the PPU of a context keeps them; e.g., for
+/// `agoge_core_delta_encode`. Only the render thread may read it.
+///
+/// @param render The renderer.
+/// @returns The PPU state.
+const struct agoge_core_ppu *
+agoge_core_render_ppu(const struct agoge_core_render *render);
+
+/// Retrieves the hash of the last frame completed by a renderer; see
+/// `agoge_core_ppu_frame_hash`. Only the render thread may call it.
+///
+/// @param render The renderer.
+/// @returns The hash.
+uint64_t agoge_core_render_frame_hash(const struct agoge_core_render *render);
+
+/// Retrieves the video output of a renderer. While a renderer is attached,
+/// scanlines and frame-complete callbacks of the fast backend go to the video
+/// output of the renderer, on the render thread, instead of to the video
+/// output of the context. It must only be changed on the render thread, or
+/// while the render thread is not running.
+///
+/// @param render The renderer.
+/// @returns The video output; see `agoge_core_video_set`.
+struct agoge_core_video *
+agoge_core_render_video(struct agoge_core_render *render);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,107 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file resampler.h Defines the public interface of the audio resampler.
+///
+/// A resampler converts the samples of an audio buffer, at
+/// `AGOGE_CORE_AUDIO_RATE`, to the rate of the host, through a windowed-sinc
+/// filter of 64 taps whose coefficients are interpolated between 128 phases.
+/// Blocks of frames are filtered at once by SSE2 or AVX2 kernels when the host
+/// supports them.
+///
+/// The ratio between the rates may be skewed slightly at any time, e.g., to
+/// keep the fill level of the host's audio queue steady rather than letting it
+/// drift towards an underrun or an overflow.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stddef.h>
+
+struct agoge_core_audio;
+struct agoge_core_resampler;
+
+/// Defines the formats of the frames written by a resampler; two samples per
+/// frame, left then right.
+enum agoge_core_resampler_format {
+	/// Signed 16-bit samples.
+	AGOGE_CORE_RESAMPLER_FORMAT_S16 = 0,
+
+	/// Single precision samples from -1 to 1.
+	AGOGE_CORE_RESAMPLER_FORMAT_F32 = 1
+};
+
+/// The largest deviation of the skew of a resampler from 1.
+#define AGOGE_CORE_RESAMPLER_SKEW_MAX (0.05F)
+
+/// Creates a resampler.
+///
+/// @param rate The rate of the host in Hz, e.g., 44100 or 48000.
+/// @param format The format of the frames to write.
+/// @returns The resampler, or `NULL` if `rate` is zero or memory could not be
+/// allocated.
+struct agoge_core_resampler *
+agoge_core_resampler_create(unsigned int rate,
+			    enum agoge_core_resampler_format format);
+
+/// Destroys a resampler.
+///
+/// @param rs The resampler; may be `NULL`.
+void agoge_core_resampler_destroy(struct agoge_core_resampler *rs);
+
+/// Discards the samples held by a resampler, e.g., after loading a state.
+///
+/// @param rs The resampler.
+void agoge_core_resampler_reset(struct agoge_core_resampler *rs);
+
+/// Skews the ratio between the rates of a resampler.
+///
+/// @param rs The resampler.
+/// @param skew The number of frames to write per frame at the nominal ratio,
+/// e.g., 1.002 to write 0.2% more frames. It is clamped to within
+/// `AGOGE_CORE_RESAMPLER_SKEW_MAX` of 1.
+void agoge_core_resampler_skew(struct agoge_core_resampler *rs, float skew);
+
+/// Retrieves the number of frames a resampler can write from the samples it
+/// holds and those ready in an audio buffer.
+///
+/// @param rs The resampler.
+/// @param audio The audio buffer.
+/// @returns The number of frames.
+size_t agoge_core_resampler_avail(const struct agoge_core_resampler *rs,
+				  const struct agoge_core_audio *audio);
+
+/// Resamples the samples ready in an audio buffer, reading them from it.
+///
+/// @param rs The resampler.
+/// @param audio The audio buffer.
+/// @param dst The destination; `max_frames` frames in the format of `rs`.
+/// @param max_frames The largest number of frames to write.
+/// @returns The number of frames written.
+size_t agoge_core_resampler_run(struct agoge_core_resampler *rs,
+				struct agoge_core_audio *audio, void *dst,
+				size_t max_frames);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,124 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file search.h Defines the public interface of the memory search engine.
+///
+/// The memory search engine locates game variables by repeatedly filtering
+/// the writable memory of a context (WRAM, HRAM and cartridge RAM) against a
+/// snapshot taken by the previous pass. Candidates are kept as a bitmap with
+/// one bit per byte of memory, and each pass is applied with SSE2 or AVX2
+/// comparisons when the host supports them.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct agoge_core_ctx;
+struct agoge_core_search;
+
+/// Defines how the bytes of a candidate are interpreted.
+enum agoge_core_search_type {
+	/// An unsigned 8-bit value.
+	AGOGE_CORE_SEARCH_TYPE_U8 = 0,
+
+	/// An unsigned little-endian 16-bit value starting at the candidate.
+	AGOGE_CORE_SEARCH_TYPE_U16 = 1,
+
+	/// A packed two-digit binary-coded decimal value. Candidates holding a
+	/// byte which is not valid BCD never match.
+	AGOGE_CORE_SEARCH_TYPE_BCD = 2
+};
+
+/// Defines the comparison applied to each candidate by a filter pass.
+enum agoge_core_search_cmp {
+	/// The value is equal to the value in the previous snapshot.
+	AGOGE_CORE_SEARCH_CMP_EQUAL = 0,
+
+	/// The value differs from the value in the previous snapshot.
+	AGOGE_CORE_SEARCH_CMP_CHANGED = 1,
+
+	/// The value is greater than the value in the previous snapshot.
+	AGOGE_CORE_SEARCH_CMP_INCREASED = 2,
+
+	/// The value is less than the value in the previous snapshot.
+	AGOGE_CORE_SEARCH_CMP_DECREASED = 3,
+
+	/// The value is equal to a given value.
+	AGOGE_CORE_SEARCH_CMP_VALUE = 4
+};
+
+/// Creates a memory search with no candidates.
+///
+/// @returns The memory search, or `NULL` if memory could not be allocated.
+struct agoge_core_search *agoge_core_search_create(void);
+
+/// Releases a memory search.
+///
+/// @param search The memory search to release. May be `NULL`.
+void agoge_core_search_destroy(struct agoge_core_search *search);
+
+/// Starts a new search: every address of the searched memory becomes a
+/// candidate, and a snapshot of the memory is taken.
+///
+/// @param search The memory search.
+/// @param ctx The emulator context to search.
+void agoge_core_search_reset(struct agoge_core_search *search,
+			     const struct agoge_core_ctx *ctx);
+
+/// Takes a snapshot of the memory and discards every candidate not matching
+/// the comparison against the previous snapshot. The new snapshot replaces
+/// the previous one.
+///
+/// @param search The memory search.
+/// @param ctx The emulator context to search.
+/// @param type How the bytes of each candidate are interpreted.
+/// @param cmp The comparison to apply.
+/// @param value The value to compare to if `cmp` is
+/// `AGOGE_CORE_SEARCH_CMP_VALUE`; for `AGOGE_CORE_SEARCH_TYPE_BCD`, this is the
+/// decimal value. Ignored otherwise.
+/// @returns The number of remaining candidates.
+size_t agoge_core_search_filter(struct agoge_core_search *search,
+				const struct agoge_core_ctx *ctx,
+				enum agoge_core_search_type type,
+				enum agoge_core_search_cmp cmp, unsigned int value);
+
+/// Retrieves the number of remaining candidates.
+///
+/// @param search The memory search.
+/// @returns The number of remaining candidates.
+size_t agoge_core_search_count(const struct agoge_core_search *search);
+
+/// Retrieves the addresses of the remaining candidates in ascending order.
+///
+/// @param search The memory search.
+/// @param addrs The destination of the addresses.
+/// @param max_addrs The maximum number of addresses to store.
+/// @returns The number of addresses stored.
+size_t agoge_core_search_results(const struct agoge_core_search *search,
+				 uint16_t *addrs, size_t max_addrs);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
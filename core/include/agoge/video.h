@@ -0,0 +1,119 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file video.h Defines the public interface of video output.
+///
+/// The frontend registers a destination buffer of its own, with a stride and
+/// a pixel format, and the PPU converts each scanline into it as soon as the
+/// scanline is complete; there is no intermediate frame in the frontend's
+/// format, and no copy at the end of the frame. When a frame is complete, the
+/// frame-complete callback receives the buffer and returns the buffer to
+/// render the next frame into, which lets the frontend swap between two or
+/// more buffers without tearing.
+///
+/// Frames that are not rendered, see `agoge_core_ppu_render_set`, neither
+/// touch the buffer nor invoke the callback. While the LCD is off, every frame
+/// is blank, i.e., filled with the color of shade 0.
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// Defines the pixel formats of a destination buffer.
+enum agoge_core_video_format {
+	/// 32 bits per pixel; red, green, blue and alpha bytes in memory
+	/// order.
+	AGOGE_CORE_VIDEO_FORMAT_RGBA8888 = 0,
+
+	/// 32 bits per pixel; blue, green, red and alpha bytes in memory
+	/// order.
+	AGOGE_CORE_VIDEO_FORMAT_BGRA8888 = 1,
+
+	/// 16 bits per pixel in host byte order; red in the 5 most significant
+	/// bits, then 6 bits of green and 5 bits of blue.
+	AGOGE_CORE_VIDEO_FORMAT_RGB565 = 2,
+
+	/// 8 bits per pixel; the shade (0-3, after the palette) of each pixel,
+	/// for frontends that apply their own palette.
+	AGOGE_CORE_VIDEO_FORMAT_INDEX8 = 3
+};
+
+/// Called when a frame is complete.
+///
+/// @param udata The user data registered with the callback.
+/// @param buf The buffer holding the complete frame.
+/// @returns The buffer to render the next frame into, with the same stride
+/// and format; `buf` itself to keep rendering into a single buffer, or `NULL`
+/// to stop video output.
+typedef void *(*agoge_core_video_frame_cb)(void *udata, void *buf);
+
+/// Defines the video output of a context.
+struct agoge_core_video {
+	/// The buffer the current frame is rendered into; `NULL` if there is
+	/// no video output.
+	void *buf;
+
+	/// The number of bytes between rows of `buf`.
+	size_t stride;
+
+	/// The pixel format of `buf`.
+	uint8_t format;
+
+	/// The frame-complete callback and its user data; `frame_cb` may be
+	/// `NULL`.
+	agoge_core_video_frame_cb frame_cb;
+	void *udata;
+
+	/// The pixel of each shade, in the pixel format of `buf`.
+	union {
+		uint32_t rgba8888[4];
+		uint16_t rgb565[4];
+		uint8_t index8[4];
+	} lut;
+};
+
+/// Registers a destination buffer, or stops video output. Video output starts
+/// with the next scanline; the buffer must hold `AGOGE_CORE_FRAME_HEIGHT`
+/// rows of `AGOGE_CORE_FRAME_WIDTH` pixels.
+///
+/// @param video The video output of a context or of a renderer; see
+/// `agoge_core_ctx_video` and `agoge_core_render_video`.
+/// @param buf The buffer, or `NULL` to stop video output.
+/// @param stride The number of bytes between rows of `buf`; a multiple of the
+/// size of a pixel.
+/// @param format The pixel format of `buf`.
+/// @param palette The red, green and blue components of each shade, or `NULL`
+/// for shades of gray from white to black. Ignored by
+/// `AGOGE_CORE_VIDEO_FORMAT_INDEX8`.
+/// @param frame_cb The frame-complete callback, or `NULL`.
+/// @param udata The user data passed to `frame_cb`.
+void agoge_core_video_set(struct agoge_core_video *video, void *buf,
+			  size_t stride, enum agoge_core_video_format format,
+			  const uint8_t palette[4][3],
+			  agoge_core_video_frame_cb frame_cb, void *udata);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
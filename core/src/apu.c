@@ -0,0 +1,859 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file apu.c Defines the implementation of the audio processing unit.
+
+#include <string.h>
+
+#include "apu.h"
+#include "audio.h"
+#include "comp.h"
+#include "defs.h"
+
+/// Defines the channels.
+enum ch {
+	CH_SQUARE1 = 0,
+	CH_SQUARE2 = 1,
+	CH_WAVE = 2,
+	CH_NOISE = 3
+};
+
+/// Defines the sound registers, as offsets from $FF10. The registers of
+/// channel `n` start at `n * NUM_CH_REGS`.
+enum reg {
+	NR10 = 0x00,
+	NR11 = 0x01,
+	NR12 = 0x02,
+	NR13 = 0x03,
+	NR14 = 0x04,
+	NR21 = 0x06,
+	NR22 = 0x07,
+	NR24 = 0x09,
+	NR30 = 0x0A,
+	NR31 = 0x0B,
+	NR32 = 0x0C,
+	NR34 = 0x0E,
+	NR41 = 0x10,
+	NR43 = 0x12,
+	NR44 = 0x13,
+	NR50 = 0x14,
+	NR51 = 0x15,
+	NR52 = 0x16
+};
+
+/// The number of registers of a channel, NRx0-NRx4.
+#define NUM_CH_REGS (5)
+
+/// The address of NR10.
+#define REGS_BASE (0xFF10)
+
+/// The address of wave RAM.
+#define WAVE_BASE (0xFF30)
+
+/// The number of T-cycles between two steps of the frame sequencer (512 Hz).
+#define SEQ_CYCLES (8192)
+
+/// The number of samples in wave RAM.
+#define WAVE_SAMPLES (AGOGE_CORE_APU_WAVE_SIZE * 2)
+
+/// The number of noise clocks searched for a change of the output before
+/// giving up until the next search.
+#define NOISE_LOOKAHEAD (64)
+
+/// The period of the LFSR in 15-bit mode.
+#define LFSR_PERIOD (32767)
+
+/// The period of the LFSR in 7-bit mode, once its upper 8 bits only hold bits
+/// shifted in since it entered the mode, i.e., after `LFSR_NARROW_FILL`
+/// clocks.
+#define LFSR_NARROW_PERIOD (127)
+#define LFSR_NARROW_FILL (8)
+
+/// NR52: Whether the APU is powered on.
+#define NR52_POWER (BIT_7)
+
+/// NRx4: Restart the channel.
+#define NRX4_TRIGGER (BIT_7)
+
+/// NRx4: Turn the channel off when its length counter expires.
+#define NRX4_LENGTH (BIT_6)
+
+/// NR30: Whether the DAC of the wave channel is on.
+#define NR30_DAC (BIT_7)
+
+/// NRx2: Whether the envelope increases the volume.
+#define NRX2_ENV_UP (BIT_3)
+
+/// NR43: Use a 7-bit LFSR.
+#define NR43_NARROW (BIT_3)
+
+/// The bits of every register which always read as 1.
+static const uint8_t read_masks[AGOGE_CORE_APU_NUM_REGS] = {
+	0x80, 0x3F, 0x00, 0xFF, 0xBF, 0xFF, 0x3F, 0x00, 0xFF, 0xBF, 0x7F,
+	0xFF, 0x9F, 0xFF, 0xBF, 0xFF, 0xFF, 0x00, 0x00, 0xBF, 0x00, 0x00,
+	0x70, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+/// The registers as the boot ROM leaves them, having played its chime on
+/// channel 1.
+static const uint8_t boot_regs[AGOGE_CORE_APU_NUM_REGS] = {
+	[NR10] = 0x80, [NR11] = 0xBF, [NR12] = 0xF3, [NR13] = 0xC1,
+	[NR14] = 0x87, [NR21] = 0x3F, [NR24] = 0xBF, [NR30] = 0x7F,
+	[NR31] = 0xFF, [NR32] = 0x9F, [NR34] = 0xBF, [NR41] = 0xFF,
+	[NR44] = 0xBF, [NR50] = 0x77, [NR51] = 0xF3, [NR52] = NR52_POWER
+};
+
+/// The waveforms of the square channels, played from bit 0 to bit 7.
+static const uint8_t duties[4] = { 0x80, 0x81, 0xE1, 0x7E };
+
+static uint8_t ch_reg(const struct agoge_core_apu *const apu,
+		      const unsigned int n, const unsigned int i)
+{
+	return apu->regs[(n * NUM_CH_REGS) + i];
+}
+
+static bool powered(const struct agoge_core_apu *const apu)
+{
+	return apu->regs[NR52] & NR52_POWER;
+}
+
+static bool synthesized(const struct agoge_core_apu *const apu)
+{
+	return apu->level == AGOGE_CORE_APU_LEVEL_FULL;
+}
+
+static bool dac_on(const struct agoge_core_apu *const apu,
+		   const unsigned int n)
+{
+	if (n == CH_WAVE) {
+		return apu->regs[NR30] & NR30_DAC;
+	}
+	return ch_reg(apu, n, 2) & 0xF8;
+}
+
+/// Retrieves the number of T-cycles between two steps of a channel.
+static uint64_t ch_period(const struct agoge_core_apu *const apu,
+			  const unsigned int n)
+{
+	switch (n) {
+	case CH_WAVE:
+		return (2048 - apu->ch[n].freq) * 2;
+
+	case CH_NOISE: {
+		const unsigned int div = apu->regs[NR43] & 7;
+		const uint64_t base = div ? (div * 16) : 8;
+
+		return base << (apu->regs[NR43] >> 4);
+	}
+
+	default:
+		return (2048 - apu->ch[n].freq) * 4;
+	}
+}
+
+/// Whether the noise channel is clocked at all; shifts of 14 and 15 stop it.
+static bool noise_clocked(const struct agoge_core_apu *const apu)
+{
+	return (apu->regs[NR43] >> 4) < 14;
+}
+
+static uint16_t lfsr_step(const uint16_t lfsr, const bool narrow)
+{
+	const uint16_t bit = (lfsr ^ (lfsr >> 1)) & 1;
+	uint16_t ret = (uint16_t)((lfsr >> 1) | (bit << 14));
+
+	if (narrow) {
+		ret = (uint16_t)((ret & ~BIT_6) | (bit << 6));
+	}
+	return ret;
+}
+
+static unsigned int wave_sample(const struct agoge_core_apu *const apu,
+				const unsigned int pos)
+{
+	const uint8_t byte = apu->wave[pos / 2];
+
+	return (pos & 1) ? (byte & 0x0F) : (byte >> 4);
+}
+
+static unsigned int wave_shift(const struct agoge_core_apu *const apu)
+{
+	static const uint8_t shifts[4] = { 4, 0, 1, 2 };
+
+	return shifts[(apu->regs[NR32] >> 5) & 3];
+}
+
+/// Steps the waveform of a channel up to a cycle, without changing its
+/// output; the caller updates it with `ch_schedule`.
+static void ch_advance(struct agoge_core_apu *const apu, const unsigned int n,
+		       const uint64_t t)
+{
+	struct agoge_core_apu_ch *const ch = &apu->ch[n];
+
+	// Nothing reads the waveform of a channel which is not synthesized.
+	if (!ch->on || !synthesized(apu) ||
+	    ((n == CH_NOISE) && !noise_clocked(apu))) {
+		ch->last = t;
+		return;
+	}
+
+	const uint64_t period = ch_period(apu, n);
+	const uint64_t steps = (t - ch->last) / period;
+
+	ch->last += steps * period;
+
+	switch (n) {
+	case CH_WAVE:
+		ch->pos = (uint8_t)((ch->pos + steps) % WAVE_SAMPLES);
+		return;
+
+	case CH_NOISE: {
+		const bool narrow = apu->regs[NR43] & NR43_NARROW;
+		uint64_t num = steps;
+
+		// Whole periods of the LFSR leave it unchanged, so catching up
+		// after a long time costs no more than a period.
+		if (!narrow) {
+			num %= LFSR_PERIOD;
+		} else if (num > LFSR_NARROW_FILL) {
+			num = LFSR_NARROW_FILL +
+			      ((num - LFSR_NARROW_FILL) % LFSR_NARROW_PERIOD);
+		}
+
+		for (uint64_t i = 0; i < num; ++i) {
+			ch->lfsr = lfsr_step(ch->lfsr, narrow);
+		}
+		return;
+	}
+
+	default:
+		ch->pos = (uint8_t)((ch->pos + steps) % 8);
+		return;
+	}
+}
+
+/// Updates the output of a channel, and finds the next cycle at which it
+/// changes.
+static void ch_schedule(struct agoge_core_apu *const apu, const unsigned int n)
+{
+	struct agoge_core_apu_ch *const ch = &apu->ch[n];
+
+	ch->out = 0;
+	ch->next = UINT64_MAX;
+
+	if (!ch->on || !synthesized(apu)) {
+		return;
+	}
+
+	const uint64_t period = ch_period(apu, n);
+
+	switch (n) {
+	case CH_WAVE: {
+		const unsigned int shift = wave_shift(apu);
+
+		ch->out = (uint8_t)(wave_sample(apu, ch->pos) >> shift);
+
+		for (unsigned int k = 1; k < WAVE_SAMPLES; ++k) {
+			const unsigned int pos = (ch->pos + k) % WAVE_SAMPLES;
+
+			if ((wave_sample(apu, pos) >> shift) != ch->out) {
+				ch->next = ch->last + (k * period);
+				return;
+			}
+		}
+		return;
+	}
+
+	case CH_NOISE: {
+		ch->out = (ch->lfsr & 1) ? 0 : ch->volume;
+
+		if ((ch->volume == 0) || !noise_clocked(apu)) {
+			return;
+		}
+
+		const bool narrow = apu->regs[NR43] & NR43_NARROW;
+		uint16_t lfsr = ch->lfsr;
+		unsigned int k;
+
+		for (k = 1; k < NOISE_LOOKAHEAD; ++k) {
+			lfsr = lfsr_step(lfsr, narrow);
+
+			if ((lfsr ^ ch->lfsr) & 1) {
+				break;
+			}
+		}
+		ch->next = ch->last + (k * period);
+		return;
+	}
+
+	default: {
+		const uint8_t duty = duties[ch_reg(apu, n, 1) >> 6];
+		const unsigned int bit = (duty >> ch->pos) & 1;
+
+		ch->out = bit ? ch->volume : 0;
+
+		if (ch->volume == 0) {
+			return;
+		}
+
+		// Every duty cycle holds both levels, so this always finds one.
+		for (unsigned int k = 1; k < 8; ++k) {
+			if (((duty >> ((ch->pos + k) % 8)) & 1) != bit) {
+				ch->next = ch->last + (k * period);
+				return;
+			}
+		}
+		return;
+	}
+	}
+}
+
+/// Mixes the outputs of the channels.
+static void mix_get(const struct agoge_core_apu *const apu, int *const left_out,
+		    int *const right_out)
+{
+	const uint8_t nr50 = apu->regs[NR50];
+	const uint8_t nr51 = apu->regs[NR51];
+	int left = 0;
+	int right = 0;
+
+	for (unsigned int n = 0; n < AGOGE_CORE_APU_NUM_CHS; ++n) {
+		if (nr51 & (BIT_4 << n)) {
+			left += apu->ch[n].out;
+		}
+
+		if (nr51 & (BIT_0 << n)) {
+			right += apu->ch[n].out;
+		}
+	}
+
+	*left_out = left * (((nr50 >> 4) & 7) + 1);
+	*right_out = right * ((nr50 & 7) + 1);
+}
+
+/// Mixes the channels, adding any change of the output to the audio buffer.
+static void mix(struct agoge_core_apu *const apu)
+{
+	int left;
+	int right;
+
+	mix_get(apu, &left, &right);
+
+	if ((left == apu->mix[0]) && (right == apu->mix[1])) {
+		return;
+	}
+
+	if (apu->audio != NULL) {
+		agoge_core_audio_delta(apu->audio, apu->cycles,
+				       left - apu->mix[0], right - apu->mix[1]);
+	}
+	apu->mix[0] = (int16_t)left;
+	apu->mix[1] = (int16_t)right;
+}
+
+static void ch_off(struct agoge_core_apu *const apu, const unsigned int n)
+{
+	ch_advance(apu, n, apu->cycles);
+	apu->ch[n].on = false;
+	ch_schedule(apu, n);
+}
+
+/// Computes the next frequency of the sweep of channel 1.
+static unsigned int sweep_calc(const struct agoge_core_apu *const apu)
+{
+	const unsigned int delta = apu->sweep_freq >> (apu->regs[NR10] & 7);
+
+	if (apu->regs[NR10] & BIT_3) {
+		return apu->sweep_freq - delta;
+	}
+	return apu->sweep_freq + delta;
+}
+
+static void length_clock(struct agoge_core_apu *const apu)
+{
+	for (unsigned int n = 0; n < AGOGE_CORE_APU_NUM_CHS; ++n) {
+		struct agoge_core_apu_ch *const ch = &apu->ch[n];
+
+		if ((ch_reg(apu, n, 4) & NRX4_LENGTH) && (ch->length != 0) &&
+		    (--ch->length == 0)) {
+			ch_off(apu, n);
+		}
+	}
+}
+
+static void sweep_clock(struct agoge_core_apu *const apu)
+{
+	// Triggering channel 1 reloads the timer, so it only matters while the
+	// channel is on.
+	if (!apu->ch[CH_SQUARE1].on) {
+		return;
+	}
+
+	if (apu->sweep_timer != 0) {
+		--apu->sweep_timer;
+	}
+
+	if (apu->sweep_timer != 0) {
+		return;
+	}
+
+	const unsigned int period = (apu->regs[NR10] >> 4) & 7;
+
+	apu->sweep_timer = (uint8_t)(period ? period : 8);
+
+	if (!apu->sweep_enabled || (period == 0)) {
+		return;
+	}
+
+	const unsigned int freq = sweep_calc(apu);
+
+	if (freq > 2047) {
+		ch_off(apu, CH_SQUARE1);
+		return;
+	}
+
+	if ((apu->regs[NR10] & 7) == 0) {
+		return;
+	}
+
+	ch_advance(apu, CH_SQUARE1, apu->cycles);
+	apu->sweep_freq = (uint16_t)freq;
+	apu->ch[CH_SQUARE1].freq = (uint16_t)freq;
+	ch_schedule(apu, CH_SQUARE1);
+
+	if (sweep_calc(apu) > 2047) {
+		ch_off(apu, CH_SQUARE1);
+	}
+}
+
+static void env_clock(struct agoge_core_apu *const apu)
+{
+	static const uint8_t chs[] = { CH_SQUARE1, CH_SQUARE2, CH_NOISE };
+
+	for (unsigned int i = 0; i < sizeof(chs); ++i) {
+		const unsigned int n = chs[i];
+		struct agoge_core_apu_ch *const ch = &apu->ch[n];
+		const uint8_t nrx2 = ch_reg(apu, n, 2);
+
+		// Triggering reloads the volume and the timer.
+		if (!ch->on || ((nrx2 & 7) == 0)) {
+			continue;
+		}
+
+		if (ch->env_timer != 0) {
+			--ch->env_timer;
+		}
+
+		if (ch->env_timer != 0) {
+			continue;
+		}
+		ch->env_timer = nrx2 & 7;
+
+		const bool up = nrx2 & NRX2_ENV_UP;
+
+		if ((up && (ch->volume == 15)) || (!up && (ch->volume == 0))) {
+			continue;
+		}
+
+		ch_advance(apu, n, apu->cycles);
+		ch->volume =
+			(uint8_t)(up ? (ch->volume + 1) : (ch->volume - 1));
+		ch_schedule(apu, n);
+	}
+}
+
+/// Whether frame sequencer steps change nothing: every channel is off, and no
+/// length counter runs.
+static bool seq_idle(const struct agoge_core_apu *const apu)
+{
+	if (!powered(apu)) {
+		return true;
+	}
+
+	for (unsigned int n = 0; n < AGOGE_CORE_APU_NUM_CHS; ++n) {
+		const struct agoge_core_apu_ch *const ch = &apu->ch[n];
+
+		if (ch->on ||
+		    ((ch_reg(apu, n, 4) & NRX4_LENGTH) && (ch->length != 0))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void seq_step(struct agoge_core_apu *const apu)
+{
+	const unsigned int step = apu->seq_step;
+
+	apu->seq_step = (uint8_t)((step + 1) % 8);
+	apu->seq_next += SEQ_CYCLES;
+
+	if (!powered(apu)) {
+		return;
+	}
+
+	if ((step % 2) == 0) {
+		length_clock(apu);
+	}
+
+	if ((step == 2) || (step == 6)) {
+		sweep_clock(apu);
+	}
+
+	if (step == 7) {
+		env_clock(apu);
+	}
+	mix(apu);
+}
+
+static void ch_trigger(struct agoge_core_apu *const apu, const unsigned int n)
+{
+	struct agoge_core_apu_ch *const ch = &apu->ch[n];
+
+	ch->on = dac_on(apu, n);
+	ch->last = apu->cycles;
+
+	if (ch->length == 0) {
+		ch->length = (n == CH_WAVE) ? 256 : 64;
+	}
+
+	switch (n) {
+	case CH_WAVE:
+		ch->pos = 0;
+		return;
+
+	case CH_SQUARE1: {
+		const unsigned int period = (apu->regs[NR10] >> 4) & 7;
+		const unsigned int shift = apu->regs[NR10] & 7;
+
+		apu->sweep_freq = ch->freq;
+		apu->sweep_timer = (uint8_t)(period ? period : 8);
+		apu->sweep_enabled = (period != 0) || (shift != 0);
+
+		if ((shift != 0) && (sweep_calc(apu) > 2047)) {
+			ch->on = false;
+		}
+		break;
+	}
+
+	case CH_NOISE:
+		ch->lfsr = 0x7FFF;
+		break;
+
+	default:
+		break;
+	}
+
+	ch->volume = ch_reg(apu, n, 2) >> 4;
+	ch->env_timer = ch_reg(apu, n, 2) & 7;
+}
+
+/// Writes a register of a channel.
+static void ch_write(struct agoge_core_apu *const apu, const unsigned int r,
+		     const uint8_t data)
+{
+	const unsigned int n = r / NUM_CH_REGS;
+	struct agoge_core_apu_ch *const ch = &apu->ch[n];
+
+	ch_advance(apu, n, apu->cycles);
+	apu->regs[r] = data;
+
+	switch (r % NUM_CH_REGS) {
+	case 0:
+		if ((n == CH_WAVE) && !(data & NR30_DAC)) {
+			ch->on = false;
+		}
+		break;
+
+	case 1:
+		ch->length = (uint16_t)((n == CH_WAVE) ? (256 - data) :
+							 (64 - (data & 0x3F)));
+		break;
+
+	case 2:
+		if ((n != CH_WAVE) && !dac_on(apu, n)) {
+			ch->on = false;
+		}
+		break;
+
+	case 3:
+		ch->freq = (uint16_t)((ch->freq & 0x700) | data);
+		break;
+
+	default:
+		ch->freq = (uint16_t)((ch->freq & 0xFF) | ((data & 7) << 8));
+
+		if (data & NRX4_TRIGGER) {
+			ch_trigger(apu, n);
+		}
+		break;
+	}
+	ch_schedule(apu, n);
+}
+
+static void power_set(struct agoge_core_apu *const apu, const bool on)
+{
+	if (on == powered(apu)) {
+		return;
+	}
+
+	if (on) {
+		// The frame sequencer restarts at step 0.
+		apu->regs[NR52] = NR52_POWER;
+		apu->seq_step = 0;
+
+		return;
+	}
+
+	for (unsigned int n = 0; n < AGOGE_CORE_APU_NUM_CHS; ++n) {
+		ch_off(apu, n);
+		apu->ch[n].freq = 0;
+	}
+
+	// Powering off clears every register but wave RAM.
+	memset(apu->regs, 0, NR52 + 1);
+	mix(apu);
+}
+
+void agoge_core_apu_sync(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_apu *const apu = &ctx->apu;
+	const uint64_t now = ctx->cpu.cycles;
+
+	// Skip the steps of the frame sequencer at once when they have nothing
+	// to clock, e.g., in games that never play sound.
+	if ((apu->seq_next <= now) && seq_idle(apu)) {
+		const uint64_t steps = ((now - apu->seq_next) / SEQ_CYCLES) + 1;
+
+		apu->seq_next += steps * SEQ_CYCLES;
+		apu->seq_step = (uint8_t)((apu->seq_step + steps) % 8);
+	}
+
+	for (;;) {
+		uint64_t t = apu->seq_next;
+		unsigned int next = AGOGE_CORE_APU_NUM_CHS;
+
+		for (unsigned int n = 0; n < AGOGE_CORE_APU_NUM_CHS; ++n) {
+			if (apu->ch[n].next < t) {
+				t = apu->ch[n].next;
+				next = n;
+			}
+		}
+
+		if (t > now) {
+			break;
+		}
+		apu->cycles = t;
+
+		if (next == AGOGE_CORE_APU_NUM_CHS) {
+			seq_step(apu);
+			continue;
+		}
+
+		ch_advance(apu, next, t);
+		ch_schedule(apu, next);
+		mix(apu);
+	}
+	apu->cycles = now;
+
+	if ((apu->audio != NULL) && synthesized(apu)) {
+		agoge_core_audio_end(apu->audio, now);
+	}
+}
+
+void agoge_core_apu_frame_end(struct agoge_core_ctx *const ctx)
+{
+	// Without synthesis, nothing needs the APU until a register is read or
+	// written.
+	if (synthesized(&ctx->apu)) {
+		agoge_core_apu_sync(ctx);
+	}
+}
+
+void agoge_core_apu_rebase(struct agoge_core_ctx *const ctx)
+{
+	const struct agoge_core_apu *const apu = &ctx->apu;
+
+	if (apu->audio != NULL) {
+		agoge_core_audio_rebase(apu->audio, apu->cycles, apu->mix[0],
+					apu->mix[1]);
+	}
+}
+
+void agoge_core_apu_restore(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_apu *const apu = &ctx->apu;
+	int left;
+	int right;
+
+	for (unsigned int n = 0; n < AGOGE_CORE_APU_NUM_CHS; ++n) {
+		ch_advance(apu, n, apu->cycles);
+		ch_schedule(apu, n);
+	}
+
+	mix_get(apu, &left, &right);
+	apu->mix[0] = (int16_t)left;
+	apu->mix[1] = (int16_t)right;
+
+	agoge_core_apu_rebase(ctx);
+}
+
+void agoge_core_apu_level_set(struct agoge_core_ctx *const ctx,
+			      const enum agoge_core_apu_level level)
+{
+	struct agoge_core_apu *const apu = &ctx->apu;
+
+	if (level == apu->level) {
+		return;
+	}
+
+	agoge_core_apu_sync(ctx);
+	apu->level = (uint8_t)level;
+
+	// The waveforms restart from here; an audio buffer picks up the output
+	// from here, or fades out.
+	for (unsigned int n = 0; n < AGOGE_CORE_APU_NUM_CHS; ++n) {
+		apu->ch[n].last = apu->cycles;
+		ch_schedule(apu, n);
+	}
+
+	if (synthesized(apu)) {
+		agoge_core_apu_restore(ctx);
+	} else {
+		mix(apu);
+	}
+}
+
+void agoge_core_apu_reset(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_apu *const apu = &ctx->apu;
+	struct agoge_core_audio *const audio = apu->audio;
+	const uint8_t level = apu->level;
+
+	memset(apu, 0, sizeof(*apu));
+	apu->audio = audio;
+	apu->level = level;
+	apu->cycles = ctx->cpu.cycles;
+	apu->seq_next = (apu->cycles | (SEQ_CYCLES - 1)) + 1;
+	memcpy(apu->regs, boot_regs, sizeof(apu->regs));
+
+	for (unsigned int n = 0; n < AGOGE_CORE_APU_NUM_CHS; ++n) {
+		apu->ch[n].last = apu->cycles;
+		apu->ch[n].next = UINT64_MAX;
+	}
+
+	// The chime has faded out, but channel 1 is still on.
+	apu->ch[CH_SQUARE1].on = true;
+	apu->ch[CH_SQUARE1].freq = 0x7C1;
+	apu->ch[CH_SQUARE1].length = 1;
+
+	for (unsigned int n = 0; n < AGOGE_CORE_APU_NUM_CHS; ++n) {
+		ch_schedule(apu, n);
+	}
+	agoge_core_apu_rebase(ctx);
+}
+
+PURE uint8_t agoge_core_apu_peek(const struct agoge_core_ctx *const ctx,
+				 const uint16_t addr)
+{
+	const struct agoge_core_apu *const apu = &ctx->apu;
+
+	if (addr >= WAVE_BASE) {
+		return apu->wave[addr - WAVE_BASE];
+	}
+
+	const unsigned int r = addr - REGS_BASE;
+	uint8_t ret = apu->regs[r] | read_masks[r];
+
+	if (r == NR52) {
+		for (unsigned int n = 0; n < AGOGE_CORE_APU_NUM_CHS; ++n) {
+			ret |= (uint8_t)(apu->ch[n].on << n);
+		}
+	}
+	return ret;
+}
+
+uint8_t agoge_core_apu_read(struct agoge_core_ctx *const ctx,
+			    const uint16_t addr)
+{
+	agoge_core_apu_sync(ctx);
+	return agoge_core_apu_peek(ctx, addr);
+}
+
+void agoge_core_apu_write(struct agoge_core_ctx *const ctx,
+			  const uint16_t addr, const uint8_t data)
+{
+	struct agoge_core_apu *const apu = &ctx->apu;
+
+	agoge_core_apu_sync(ctx);
+
+	if (addr >= WAVE_BASE) {
+		ch_advance(apu, CH_WAVE, apu->cycles);
+		apu->wave[addr - WAVE_BASE] = data;
+		ch_schedule(apu, CH_WAVE);
+		mix(apu);
+
+		return;
+	}
+
+	const unsigned int r = addr - REGS_BASE;
+
+	if (r == NR52) {
+		power_set(apu, data & NR52_POWER);
+		return;
+	}
+
+	// While powered off, only NR52 and wave RAM may be written.
+	if (!powered(apu) || (r > NR52)) {
+		return;
+	}
+
+	if (r < NR50) {
+		ch_write(apu, r, data);
+	} else {
+		apu->regs[r] = data;
+	}
+	mix(apu);
+}
+
+void agoge_core_apu_poke(struct agoge_core_ctx *const ctx,
+			 const uint16_t addr, const uint8_t data)
+{
+	struct agoge_core_apu *const apu = &ctx->apu;
+
+	agoge_core_apu_sync(ctx);
+
+	for (unsigned int n = 0; n < AGOGE_CORE_APU_NUM_CHS; ++n) {
+		ch_advance(apu, n, apu->cycles);
+	}
+
+	if (addr >= WAVE_BASE) {
+		apu->wave[addr - WAVE_BASE] = data;
+	} else if (addr == (REGS_BASE + NR52)) {
+		apu->regs[NR52] = data & NR52_POWER;
+	} else {
+		apu->regs[addr - REGS_BASE] = data;
+	}
+
+	for (unsigned int n = 0; n < AGOGE_CORE_APU_NUM_CHS; ++n) {
+		ch_schedule(apu, n);
+	}
+	mix(apu);
+}
@@ -0,0 +1,62 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file apu.h Defines the internal interface of the audio processing unit.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "ctx.h"
+
+/// Resets the APU to its state after the boot ROM, keeping the attached audio
+/// buffer and the level.
+void agoge_core_apu_reset(struct agoge_core_ctx *ctx);
+
+/// Brings the APU up to the current cycle, adding its output to the attached
+/// audio buffer, if any.
+void agoge_core_apu_sync(struct agoge_core_ctx *ctx);
+
+/// Brings the APU up to the current cycle at the end of a frame, unless its
+/// level skips it.
+void agoge_core_apu_frame_end(struct agoge_core_ctx *ctx);
+
+/// Reads a sound register or wave RAM ($FF10-$FF3F).
+uint8_t agoge_core_apu_read(struct agoge_core_ctx *ctx, uint16_t addr);
+
+/// Writes a sound register or wave RAM ($FF10-$FF3F).
+void agoge_core_apu_write(struct agoge_core_ctx *ctx, uint16_t addr,
+			  uint8_t data);
+
+/// Reads a sound register or wave RAM ($FF10-$FF3F) without bringing the APU
+/// up to date.
+uint8_t agoge_core_apu_peek(const struct agoge_core_ctx *ctx, uint16_t addr);
+
+/// Writes a sound register or wave RAM ($FF10-$FF3F) without side effects,
+/// i.e., without triggering, enabling or disabling channels.
+void agoge_core_apu_poke(struct agoge_core_ctx *ctx, uint16_t addr,
+			 uint8_t data);
+
+/// Restarts the attached audio buffer, if any, at the current cycle.
+void agoge_core_apu_rebase(struct agoge_core_ctx *ctx);
+
+/// Brings the channels in line with the level of the APU after its state was
+/// replaced, e.g., by loading a state, and restarts the attached audio buffer.
+void agoge_core_apu_restore(struct agoge_core_ctx *ctx);
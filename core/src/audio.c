@@ -0,0 +1,233 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file audio.c Defines the implementation of audio buffers.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "apu.h"
+#include "audio.h"
+#include "comp.h"
+
+/// The number of deltas held.
+#define BUF_SIZE (AGOGE_CORE_AUDIO_FRAMES_MAX + AUDIO_BLEP_TAPS)
+
+/// The number of T-cycles per sub-sample position of a band-limited step.
+#define PHASE_CYCLES \
+	(AGOGE_CORE_AUDIO_CYCLES_PER_SAMPLE / AUDIO_BLEP_PHASES)
+
+/// The shift of the DC blocker; a cutoff of about 10 Hz.
+#define DC_SHIFT (10)
+
+/// The shift converting the output in Q15 to samples; the loudest output of
+/// the APU, 480, comes out at 30720.
+#define OUT_SHIFT (9)
+
+/// The impulse responses of a band-limited step at every sub-sample position,
+/// in Q15; a windowed sinc with a cutoff of 0.45 times the sample rate, under
+/// a Blackman window. Every row sums to 32768, so that a step settles at its
+/// exact height.
+static const int16_t blep[AUDIO_BLEP_PHASES][AUDIO_BLEP_TAPS] = {
+	{ 18, -110, 359, -843, 1561, -2371, 3025, 29490,
+	  3025, -2371, 1561, -843, 359, -110, 18, 0 },
+	{ 17, -108, 347, -795, 1421, -2025, 2117, 29452,
+	  3974, -2714, 1693, -887, 369, -111, 18, 0 },
+	{ 17, -105, 332, -742, 1276, -1679, 1252, 29332,
+	  4960, -3051, 1818, -925, 376, -110, 17, 0 },
+	{ 16, -102, 315, -686, 1128, -1335, 434, 29131,
+	  5981, -3378, 1932, -956, 380, -109, 17, 0 },
+	{ 16, -98, 297, -627, 977, -997, -336, 28853,
+	  7031, -3693, 2036, -982, 381, -106, 16, 0 },
+	{ 15, -93, 277, -566, 824, -665, -1055, 28499,
+	  8106, -3992, 2127, -999, 378, -103, 15, 0 },
+	{ 14, -87, 256, -503, 672, -343, -1721, 28067,
+	  9203, -4273, 2204, -1009, 372, -97, 13, 0 },
+	{ 13, -82, 234, -439, 522, -34, -2334, 27565,
+	  10317, -4531, 2266, -1011, 362, -91, 11, 0 },
+	{ 12, -76, 211, -375, 374, 262, -2891, 26992,
+	  11444, -4765, 2311, -1004, 348, -83, 8, 0 },
+	{ 10, -69, 188, -311, 229, 543, -3394, 26350,
+	  12577, -4970, 2339, -987, 330, -73, 6, 0 },
+	{ 9, -63, 165, -248, 90, 807, -3840, 25646,
+	  13712, -5144, 2348, -962, 308, -62, 2, 0 },
+	{ 8, -56, 142, -186, -44, 1052, -4231, 24877,
+	  14845, -5283, 2338, -926, 282, -50, -1, 1 },
+	{ 7, -50, 119, -126, -171, 1277, -4566, 24057,
+	  15970, -5386, 2307, -881, 251, -36, -5, 1 },
+	{ 6, -44, 96, -68, -291, 1482, -4846, 23182,
+	  17081, -5448, 2255, -825, 217, -21, -10, 2 },
+	{ 5, -37, 74, -12, -403, 1666, -5072, 22257,
+	  18174, -5467, 2182, -760, 178, -4, -15, 2 },
+	{ 4, -31, 53, 41, -506, 1828, -5246, 21289,
+	  19243, -5441, 2086, -685, 136, 14, -20, 3 },
+	{ 3, -25, 33, 90, -600, 1968, -5368, 20283,
+	  20283, -5368, 1968, -600, 90, 33, -25, 3 },
+	{ 3, -20, 14, 136, -685, 2086, -5441, 19243,
+	  21289, -5246, 1828, -506, 41, 53, -31, 4 },
+	{ 2, -15, -4, 178, -760, 2182, -5467, 18174,
+	  22257, -5072, 1666, -403, -12, 74, -37, 5 },
+	{ 2, -10, -21, 217, -825, 2255, -5448, 17081,
+	  23182, -4846, 1482, -291, -68, 96, -44, 6 },
+	{ 1, -5, -36, 251, -881, 2307, -5386, 15970,
+	  24057, -4566, 1277, -171, -126, 119, -50, 7 },
+	{ 1, -1, -50, 282, -926, 2338, -5283, 14845,
+	  24877, -4231, 1052, -44, -186, 142, -56, 8 },
+	{ 0, 2, -62, 308, -962, 2348, -5144, 13712,
+	  25646, -3840, 807, 90, -248, 165, -63, 9 },
+	{ 0, 6, -73, 330, -987, 2339, -4970, 12577,
+	  26350, -3394, 543, 229, -311, 188, -69, 10 },
+	{ 0, 8, -83, 348, -1004, 2311, -4765, 11444,
+	  26992, -2891, 262, 374, -375, 211, -76, 12 },
+	{ 0, 11, -91, 362, -1011, 2266, -4531, 10317,
+	  27565, -2334, -34, 522, -439, 234, -82, 13 },
+	{ 0, 13, -97, 372, -1009, 2204, -4273, 9203,
+	  28067, -1721, -343, 672, -503, 256, -87, 14 },
+	{ 0, 15, -103, 378, -999, 2127, -3992, 8106,
+	  28499, -1055, -665, 824, -566, 277, -93, 15 },
+	{ 0, 16, -106, 381, -982, 2036, -3693, 7031,
+	  28853, -336, -997, 977, -627, 297, -98, 16 },
+	{ 0, 17, -109, 380, -956, 1932, -3378, 5981,
+	  29131, 434, -1335, 1128, -686, 315, -102, 16 },
+	{ 0, 17, -110, 376, -925, 1818, -3051, 4960,
+	  29332, 1252, -1679, 1276, -742, 332, -105, 17 },
+	{ 0, 18, -111, 369, -887, 1693, -2714, 3974,
+	  29452, 2117, -2025, 1421, -795, 347, -108, 17 },
+};
+
+MALLOC struct agoge_core_audio *agoge_core_audio_create(void)
+{
+	return calloc(1, sizeof(struct agoge_core_audio));
+}
+
+void agoge_core_audio_destroy(struct agoge_core_audio *const audio)
+{
+	free(audio);
+}
+
+void agoge_core_audio_attach(struct agoge_core_ctx *const ctx,
+			     struct agoge_core_audio *const audio)
+{
+	// Whatever was due to the previous buffer goes to it.
+	agoge_core_apu_sync(ctx);
+	ctx->apu.audio = audio;
+
+	if (audio != NULL) {
+		agoge_core_audio_rebase(audio, ctx->apu.cycles,
+					ctx->apu.mix[0], ctx->apu.mix[1]);
+	}
+}
+
+PURE size_t agoge_core_audio_avail(const struct agoge_core_audio *const audio)
+{
+	return audio->avail;
+}
+
+void agoge_core_audio_delta(struct agoge_core_audio *const audio,
+			    const uint64_t t, const int dl, const int dr)
+{
+	const uint64_t offset = t - audio->t0;
+	const uint64_t idx = offset / AGOGE_CORE_AUDIO_CYCLES_PER_SAMPLE;
+
+	// Nobody is reading; drop the output until there is room again.
+	if (unlikely(idx > (BUF_SIZE - AUDIO_BLEP_TAPS))) {
+		return;
+	}
+
+	const int16_t *const resp =
+		blep[(offset % AGOGE_CORE_AUDIO_CYCLES_PER_SAMPLE) /
+		     PHASE_CYCLES];
+	int32_t(*const dst)[2] = &audio->buf[idx];
+
+	for (unsigned int i = 0; i < AUDIO_BLEP_TAPS; ++i) {
+		dst[i][0] += resp[i] * dl;
+		dst[i][1] += resp[i] * dr;
+	}
+}
+
+void agoge_core_audio_end(struct agoge_core_audio *const audio,
+			  const uint64_t t)
+{
+	const uint64_t ready =
+		(t - audio->t0) / AGOGE_CORE_AUDIO_CYCLES_PER_SAMPLE;
+
+	audio->avail = (ready < AGOGE_CORE_AUDIO_FRAMES_MAX) ?
+			       (size_t)ready :
+			       AGOGE_CORE_AUDIO_FRAMES_MAX;
+}
+
+void agoge_core_audio_rebase(struct agoge_core_audio *const audio,
+			     const uint64_t t, const int level_l,
+			     const int level_r)
+{
+	audio->t0 = t;
+	audio->avail = 0;
+	audio->integ[0] = level_l * 32768;
+	audio->integ[1] = level_r * 32768;
+
+	// Start with the DC offset settled, so that there is no pop.
+	audio->dc[0] = audio->integ[0];
+	audio->dc[1] = audio->integ[1];
+
+	memset(audio->buf, 0, sizeof(audio->buf));
+}
+
+static int16_t sample_clamp(const int32_t x)
+{
+	if (x > INT16_MAX) {
+		return INT16_MAX;
+	}
+
+	if (x < INT16_MIN) {
+		return INT16_MIN;
+	}
+	return (int16_t)x;
+}
+
+size_t agoge_core_audio_read(struct agoge_core_audio *const audio,
+			     int16_t *const dst, const size_t max_frames)
+{
+	const size_t num = (audio->avail < max_frames) ? audio->avail :
+							 max_frames;
+
+	for (size_t i = 0; i < num; ++i) {
+		for (unsigned int c = 0; c < 2; ++c) {
+			audio->integ[c] += audio->buf[i][c];
+			audio->dc[c] += (audio->integ[c] - audio->dc[c]) >>
+					DC_SHIFT;
+
+			dst[(i * 2) + c] = sample_clamp(
+				(audio->integ[c] - audio->dc[c]) >> OUT_SHIFT);
+		}
+	}
+
+	// Only the ready samples and the tails of the steps past them hold
+	// deltas.
+	const size_t live = audio->avail + AUDIO_BLEP_TAPS;
+
+	memmove(audio->buf, &audio->buf[num],
+		(live - num) * sizeof(audio->buf[0]));
+	memset(&audio->buf[live - num], 0, num * sizeof(audio->buf[0]));
+
+	audio->t0 += (uint64_t)num * AGOGE_CORE_AUDIO_CYCLES_PER_SAMPLE;
+	audio->avail -= num;
+
+	return num;
+}
@@ -0,0 +1,71 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file audio.h Defines the internal interface of audio buffers.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "agoge/audio.h"
+
+/// The number of taps of a band-limited step.
+#define AUDIO_BLEP_TAPS (16)
+
+/// The number of sub-sample positions of a band-limited step.
+#define AUDIO_BLEP_PHASES (32)
+
+/// Defines an audio buffer.
+struct agoge_core_audio {
+	/// The value of `cpu.cycles` at the start of the first sample held.
+	uint64_t t0;
+
+	/// The number of samples per channel ready to be read.
+	size_t avail;
+
+	/// The running sums of the deltas, i.e., the output, in Q15.
+	int32_t integ[2];
+
+	/// The DC offset of the output, in Q15.
+	int32_t dc[2];
+
+	/// The deltas of the output; a band-limited step spreads over
+	/// `AUDIO_BLEP_TAPS` samples past the one it lands in.
+	int32_t buf[AGOGE_CORE_AUDIO_FRAMES_MAX + AUDIO_BLEP_TAPS][2];
+};
+
+/// Adds a change of the output to an audio buffer.
+///
+/// @param audio The audio buffer.
+/// @param t The value of `cpu.cycles` at which the output changed; must not
+/// be before the cycle last passed to `agoge_core_audio_end`.
+/// @param dl The change of the left output.
+/// @param dr The change of the right output.
+void agoge_core_audio_delta(struct agoge_core_audio *audio, uint64_t t,
+			    int dl, int dr);
+
+/// Marks the samples before a cycle as ready to be read; no change of the
+/// output may be added before it afterwards.
+void agoge_core_audio_end(struct agoge_core_audio *audio, uint64_t t);
+
+/// Empties an audio buffer, restarting it at a cycle with the given output,
+/// e.g., after a reset or loading a state.
+void agoge_core_audio_rebase(struct agoge_core_audio *audio, uint64_t t,
+			     int level_l, int level_r);
@@ -20,23 +20,83 @@
 
 #include <string.h>
 
+#include "apu.h"
 #include "bus.h"
 #include "cart.h"
+#include "cheats.h"
+#include "comp.h"
+#include "cpu.h"
+#include "joypad.h"
 #include "log.h"
+#include "palette.h"
+#include "ppu.h"
 
 LOG_CHANNEL(AGOGE_CORE_LOG_CH_BUS);
 
+#define PAGE_MASK (AGOGE_CORE_BUS_PAGE_SIZE - 1)
+
+/// Retrieves the host memory backing a ROM page, honoring Game Genie patches.
+NODISCARD static const uint8_t *rom_page(const struct agoge_core_ctx *const ctx,
+					 const size_t offset)
+{
+	const uint8_t *const patched = agoge_core_cheats_rom_page(ctx, offset);
+	return (patched != NULL) ? patched : &ctx->bus.cart.data[offset];
+}
+
+void agoge_core_bus_map_update(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_bus *const bus = &ctx->bus;
+
+	memset(bus->read_map, 0, sizeof(bus->read_map));
+	memset(bus->write_map, 0, sizeof(bus->write_map));
+
+	if (bus->cart.data != NULL) {
+		const size_t bank = bus->cart.rom_bank * 0x4000;
+
+		bus->read_map[0x0000 >> AGOGE_CORE_BUS_PAGE_SHIFT] =
+			rom_page(ctx, 0x0000);
+		bus->read_map[0x2000 >> AGOGE_CORE_BUS_PAGE_SHIFT] =
+			rom_page(ctx, 0x2000);
+		bus->read_map[0x4000 >> AGOGE_CORE_BUS_PAGE_SHIFT] =
+			rom_page(ctx, bank);
+		bus->read_map[0x6000 >> AGOGE_CORE_BUS_PAGE_SHIFT] =
+			rom_page(ctx, bank + 0x2000);
+	}
+
+	bus->read_map[0x8000 >> AGOGE_CORE_BUS_PAGE_SHIFT] = bus->vram;
+	bus->read_map[0xC000 >> AGOGE_CORE_BUS_PAGE_SHIFT] = bus->wram;
+	bus->write_map[0xC000 >> AGOGE_CORE_BUS_PAGE_SHIFT] = bus->wram;
+}
+
 uint8_t agoge_core_bus_read(struct agoge_core_ctx *const ctx,
 			    const uint16_t addr)
 {
+	const uint8_t *const page =
+		ctx->bus.read_map[addr >> AGOGE_CORE_BUS_PAGE_SHIFT];
+
+	if (likely(page != NULL)) {
+		return page[addr & PAGE_MASK];
+	}
+
 	static const void *jmp_tbl[] = {
 		[0x0000 ... 0x3FFF] = &&unbanked_rom_read,
 		[0x4000 ... 0x7FFF] = &&banked_rom_read,
-		[0x8000 ... 0xBFFF] = &&unknown,
+		[0x8000 ... 0x9FFF] = &&vram,
+		[0xA000 ... 0xBFFF] = &&unknown,
 		[0xC000 ... 0xDFFF] = &&wram,
-		[0xE000 ... 0xFF7F] = &&unknown,
+		[0xE000 ... 0xFDFF] = &&unknown,
+		[0xFE00 ... 0xFE9F] = &&oam,
+		[0xFEA0 ... 0xFEFF] = &&unknown,
+		[0xFF00] = &&joypad,
+		[0xFF01 ... 0xFF0E] = &&unknown,
+		[0xFF0F] = &&intr_flag,
+		[0xFF10 ... 0xFF3F] = &&apu,
+		[0xFF40 ... 0xFF4B] = &&ppu,
+		[0xFF4C ... 0xFF67] = &&unknown,
+		[0xFF68 ... 0xFF6B] = &&palette,
+		[0xFF6C ... 0xFF7F] = &&unknown,
 		[0xFF80 ... 0xFFFE] = &&hram,
-		[0xFFFF] = &&unknown
+		[0xFFFF] = &&intr_enable
 	};
 
 	goto *jmp_tbl[addr];
@@ -45,14 +105,39 @@ unbanked_rom_read:
 	return ctx->bus.cart.data[addr];
 
 banked_rom_read:
-	return ctx->bus.cart.banked_read_cb(ctx, addr);
+	return ctx->bus.cart
+		.data[(addr - 0x4000) + (ctx->bus.cart.rom_bank * 0x4000)];
+
+vram:
+	return ctx->bus.vram[addr - 0x8000];
 
 wram:
 	return ctx->bus.wram[addr - 0xC000];
 
+oam:
+	return ctx->bus.oam[addr - 0xFE00];
+
 hram:
 	return ctx->bus.hram[addr - 0xFF80];
 
+joypad:
+	return agoge_core_joypad_read(ctx);
+
+intr_flag:
+	return ctx->cpu.ifr | 0xE0;
+
+apu:
+	return agoge_core_apu_read(ctx, addr);
+
+ppu:
+	return agoge_core_ppu_read(ctx, addr);
+
+palette:
+	return agoge_core_palette_read(ctx, addr);
+
+intr_enable:
+	return ctx->cpu.ie;
+
 unknown:
 	LOG_WARN(ctx, "Unknown memory read: $%04X, returning $FF", addr);
 	return 0xFF;
@@ -61,13 +146,32 @@ unknown:
 void agoge_core_bus_write(struct agoge_core_ctx *const ctx, const uint16_t addr,
 			  const uint8_t data)
 {
-	static const void *const jmp_tbl[] = { [0x0000 ... 0xBFFF] = &&unknown,
+	uint8_t *const page =
+		ctx->bus.write_map[addr >> AGOGE_CORE_BUS_PAGE_SHIFT];
+
+	if (likely(page != NULL)) {
+		page[addr & PAGE_MASK] = data;
+		return;
+	}
+
+	static const void *const jmp_tbl[] = { [0x0000 ... 0x7FFF] = &&unknown,
+					       [0x8000 ... 0x9FFF] = &&vram,
+					       [0xA000 ... 0xBFFF] = &&unknown,
 					       [0xC000 ... 0xDFFF] = &&wram,
-					       [0xE000 ... 0xFF00] = &&unknown,
+					       [0xE000 ... 0xFDFF] = &&unknown,
+					       [0xFE00 ... 0xFE9F] = &&oam,
+					       [0xFEA0 ... 0xFEFF] = &&unknown,
+					       [0xFF00] = &&joypad,
 					       [0xFF01] = &&serial_write,
-					       [0xFF02 ... 0xFF7F] = &&unknown,
+					       [0xFF02 ... 0xFF0E] = &&unknown,
+					       [0xFF0F] = &&intr_flag,
+					       [0xFF10 ... 0xFF3F] = &&apu,
+					       [0xFF40 ... 0xFF4B] = &&ppu,
+					       [0xFF4C ... 0xFF67] = &&unknown,
+					       [0xFF68 ... 0xFF6B] = &&palette,
+					       [0xFF6C ... 0xFF7F] = &&unknown,
 					       [0xFF80 ... 0xFFFE] = &&hram,
-					       [0xFFFF] = &&unknown };
+					       [0xFFFF] = &&intr_enable };
 
 	goto *jmp_tbl[addr];
 
@@ -76,14 +180,53 @@ unknown:
 		 data);
 	return;
 
+vram:
+	agoge_core_ppu_vram_write(ctx, addr, data);
+	ctx->bus.vram[addr - 0x8000] = data;
+
+	return;
+
 wram:
 	ctx->bus.wram[addr - 0xC000] = data;
 	return;
 
+oam:
+	agoge_core_ppu_oam_write(ctx, addr, data);
+	ctx->bus.oam[addr - 0xFE00] = data;
+	return;
+
 hram:
 	ctx->bus.hram[addr - 0xFF80] = data;
 	return;
 
+joypad:
+	agoge_core_joypad_write(ctx, data);
+	return;
+
+intr_flag:
+	ctx->cpu.ifr = data & 0x1F;
+	agoge_core_cpu_yield(ctx);
+
+	return;
+
+apu:
+	agoge_core_apu_write(ctx, addr, data);
+	return;
+
+ppu:
+	agoge_core_ppu_write(ctx, addr, data);
+	return;
+
+palette:
+	agoge_core_palette_write(ctx, addr, data);
+	return;
+
+intr_enable:
+	ctx->cpu.ie = data;
+	agoge_core_cpu_yield(ctx);
+
+	return;
+
 serial_write:
 	ctx->bus.serial.data[ctx->bus.serial.data_size++] = data;
 
@@ -94,8 +237,229 @@ serial_write:
 	return;
 }
 
+/// Retrieves a byte from an address not backed by the page map, without side
+/// effects.
+NODISCARD static uint8_t peek_slow(struct agoge_core_ctx *const ctx,
+				   const uint16_t addr)
+{
+	switch (addr) {
+	case 0x4000 ... 0x7FFF:
+		if (ctx->bus.cart.data == NULL) {
+			return 0xFF;
+		}
+
+		return ctx->bus.cart.data[(addr - 0x4000) +
+					  (ctx->bus.cart.rom_bank * 0x4000)];
+
+	case 0x8000 ... 0x9FFF:
+		return ctx->bus.vram[addr - 0x8000];
+
+	case 0xC000 ... 0xDFFF:
+		return ctx->bus.wram[addr - 0xC000];
+
+	case 0xFE00 ... 0xFE9F:
+		return ctx->bus.oam[addr - 0xFE00];
+
+	case 0xFF00:
+		return agoge_core_joypad_read(ctx);
+
+	case 0xFF0F:
+		return ctx->cpu.ifr | 0xE0;
+
+	case 0xFF10 ... 0xFF3F:
+		return agoge_core_apu_peek(ctx, addr);
+
+	case 0xFF40 ... 0xFF4B:
+		return agoge_core_ppu_read(ctx, addr);
+
+	case 0xFF68 ... 0xFF6B:
+		return agoge_core_palette_read(ctx, addr);
+
+	case 0xFF80 ... 0xFFFE:
+		return ctx->bus.hram[addr - 0xFF80];
+
+	case 0xFFFF:
+		return ctx->cpu.ie;
+
+	default:
+		if ((addr < 0x4000) && (ctx->bus.cart.data != NULL)) {
+			return ctx->bus.cart.data[addr];
+		}
+
+		return 0xFF;
+	}
+}
+
+/// Stores a byte at an address not backed by the page map, without side
+/// effects.
+static void poke_slow(struct agoge_core_ctx *const ctx, const uint16_t addr,
+		      const uint8_t data)
+{
+	switch (addr) {
+	case 0x8000 ... 0x9FFF:
+		ctx->bus.vram[addr - 0x8000] = data;
+		agoge_core_ppu_vram_changed(ctx, addr - 0x8000, data);
+
+		return;
+
+	case 0xC000 ... 0xDFFF:
+		ctx->bus.wram[addr - 0xC000] = data;
+		return;
+
+	case 0xFE00 ... 0xFE9F:
+		ctx->bus.oam[addr - 0xFE00] = data;
+		agoge_core_ppu_oam_changed(ctx, addr - 0xFE00, data);
+
+		return;
+
+	case 0xFF00:
+		ctx->joypad.sel = data & 0x30;
+		return;
+
+	case 0xFF0F:
+		ctx->cpu.ifr = data & 0x1F;
+		return;
+
+	case 0xFF10 ... 0xFF3F:
+		agoge_core_apu_poke(ctx, addr, data);
+		return;
+
+	case 0xFF40 ... 0xFF4B:
+		agoge_core_ppu_poke(ctx, addr, data);
+		return;
+
+	case 0xFF68 ... 0xFF6B:
+		agoge_core_palette_poke(ctx, addr, data);
+		return;
+
+	case 0xFF80 ... 0xFFFE:
+		ctx->bus.hram[addr - 0xFF80] = data;
+		return;
+
+	case 0xFFFF:
+		ctx->cpu.ie = data;
+		return;
+
+	default:
+		return;
+	}
+}
+
 uint8_t agoge_core_bus_peek(struct agoge_core_ctx *const ctx,
 			    const uint16_t addr)
 {
-	return agoge_core_bus_read(ctx, addr);
+	const uint8_t *const page =
+		ctx->bus.read_map[addr >> AGOGE_CORE_BUS_PAGE_SHIFT];
+
+	if (likely(page != NULL)) {
+		return page[addr & PAGE_MASK];
+	}
+
+	return peek_slow(ctx, addr);
+}
+
+/// Returns the number of bytes from `addr` to the end of its page, clamped to
+/// `size`.
+NODISCARD static size_t run_size(const uint16_t addr, const size_t size)
+{
+	const size_t left = AGOGE_CORE_BUS_PAGE_SIZE - (addr & PAGE_MASK);
+	return (left < size) ? left : size;
+}
+
+void agoge_core_bus_peek_range(struct agoge_core_ctx *const ctx, uint16_t addr,
+			       uint8_t *dst, size_t size)
+{
+	while (size > 0) {
+		const size_t run = run_size(addr, size);
+		const uint8_t *const page =
+			ctx->bus.read_map[addr >> AGOGE_CORE_BUS_PAGE_SHIFT];
+
+		if (likely(page != NULL)) {
+			memcpy(dst, &page[addr & PAGE_MASK], run);
+		} else {
+			for (size_t i = 0; i < run; ++i) {
+				dst[i] = peek_slow(ctx, (uint16_t)(addr + i));
+			}
+		}
+
+		addr = (uint16_t)(addr + run);
+		dst += run;
+		size -= run;
+	}
+}
+
+void agoge_core_bus_poke_range(struct agoge_core_ctx *const ctx, uint16_t addr,
+			       const uint8_t *src, size_t size)
+{
+	while (size > 0) {
+		const size_t run = run_size(addr, size);
+		uint8_t *const page =
+			ctx->bus.write_map[addr >> AGOGE_CORE_BUS_PAGE_SHIFT];
+
+		if (likely(page != NULL)) {
+			memcpy(&page[addr & PAGE_MASK], src, run);
+		} else {
+			for (size_t i = 0; i < run; ++i) {
+				poke_slow(ctx, (uint16_t)(addr + i), src[i]);
+			}
+		}
+
+		addr = (uint16_t)(addr + run);
+		src += run;
+		size -= run;
+	}
+}
+
+CONST struct agoge_core_bus_span
+agoge_core_bus_view(const struct agoge_core_ctx *const ctx,
+		    const enum agoge_core_bus_region region,
+		    const unsigned int bank)
+{
+	(void)bank;
+
+	switch (region) {
+	case AGOGE_CORE_BUS_REGION_WRAM:
+		return (struct agoge_core_bus_span){
+			.data = ctx->bus.wram,
+			.size = sizeof(ctx->bus.wram),
+			.addr = 0xC000
+		};
+
+	case AGOGE_CORE_BUS_REGION_HRAM:
+		return (struct agoge_core_bus_span){
+			.data = ctx->bus.hram,
+			.size = sizeof(ctx->bus.hram),
+			.addr = 0xFF80
+		};
+
+	case AGOGE_CORE_BUS_REGION_VRAM:
+		return (struct agoge_core_bus_span){
+			.data = ctx->bus.vram,
+			.size = sizeof(ctx->bus.vram),
+			.addr = 0x8000
+		};
+
+	case AGOGE_CORE_BUS_REGION_OAM:
+		return (struct agoge_core_bus_span){
+			.data = ctx->bus.oam,
+			.size = sizeof(ctx->bus.oam),
+			.addr = 0xFE00
+		};
+
+	// No supported cartridge type has RAM yet.
+	case AGOGE_CORE_BUS_REGION_CART_RAM:
+	default:
+		return (struct agoge_core_bus_span){ .data = NULL,
+						     .size = 0,
+						     .addr = 0xA000 };
+	}
+}
+
+void agoge_core_bus_gather(struct agoge_core_ctx *const ctx,
+			   const uint16_t *const addrs, const size_t num_addrs,
+			   uint8_t *const dst)
+{
+	for (size_t i = 0; i < num_addrs; ++i) {
+		dst[i] = agoge_core_bus_peek(ctx, addrs[i]);
+	}
 }
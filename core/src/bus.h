@@ -20,9 +20,14 @@
 
 #pragma once
 
-#include "agoge/ctx.h"
+#include "ctx.h"
 
 uint8_t agoge_core_bus_read(struct agoge_core_ctx *ctx, uint16_t addr);
 
 void agoge_core_bus_write(struct agoge_core_ctx *ctx, uint16_t addr,
 			  uint8_t data);
+
+/// Rebuilds the page map of the system bus from the current state of the
+/// context. This must be called whenever memory backing a page is remapped
+/// (e.g., on a ROM bank switch), or the context is moved.
+void agoge_core_bus_map_update(struct agoge_core_ctx *ctx);
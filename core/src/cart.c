@@ -19,6 +19,7 @@
 // SOFTWARE.
 
 #include <stdbool.h>
+#include "bus.h"
 #include "cart.h"
 #include "comp.h"
 #include "log.h"
@@ -30,19 +31,6 @@ LOG_CHANNEL(AGOGE_CORE_LOG_CH_CART);
 #define HDR_ADDR_MASK_ROM_VER_NUM (UINT16_C(0x014C))
 #define HDR_ADDR_CSUM (UINT16_C(0x014D))
 
-NODISCARD static uint8_t
-mbc_banked_read_cb_none(struct agoge_core_ctx *const ctx, const uint16_t addr)
-{
-	return ctx->bus.cart.data[addr];
-}
-
-NODISCARD static uint8_t
-mbc_banked_read_cb_mbc1(struct agoge_core_ctx *const ctx, const uint16_t addr)
-{
-	return ctx->bus.cart
-		.data[(addr - 0x4000) + (ctx->bus.cart.rom_bank * 0x4000)];
-}
-
 NODISCARD static bool valid_csum(const uint8_t *const data)
 {
 	uint8_t csum = 0;
@@ -61,13 +49,8 @@ NODISCARD static bool mbc_set(struct agoge_core_ctx *const ctx,
 
 	switch (type) {
 	case AGOGE_CORE_CART_MBC_ROM_ONLY:
-		ctx->bus.cart.banked_read_cb = &mbc_banked_read_cb_none;
-		return true;
-
 	case AGOGE_CORE_CART_MBC_MBC1:
-		ctx->bus.cart.banked_read_cb = &mbc_banked_read_cb_mbc1;
 		ctx->bus.cart.rom_bank = 1;
-
 		return true;
 
 	default:
@@ -95,5 +78,7 @@ agoge_core_cart_set(struct agoge_core_ctx *const ctx, uint8_t *const data,
 	}
 
 	ctx->bus.cart.data = data;
+	agoge_core_bus_map_update(ctx);
+
 	return AGOGE_CORE_CART_RETVAL_OK;
 }
@@ -20,4 +20,4 @@
 
 #pragma once
 
-#include "agoge/ctx.h"
+#include "ctx.h"
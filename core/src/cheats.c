@@ -0,0 +1,319 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file cheats.c Defines the implementation of cheat codes.
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bus.h"
+#include "cheats.h"
+#include "comp.h"
+
+/// The number of hexadecimal digits in a Game Genie code without a compare
+/// value.
+#define GAME_GENIE_DIGITS (6)
+
+/// The number of hexadecimal digits in a Game Genie code with a compare
+/// value.
+#define GAME_GENIE_CMP_DIGITS (9)
+
+/// The number of hexadecimal digits in a GameShark code.
+#define GAMESHARK_DIGITS (8)
+
+/// The offset of the first banked ROM page.
+#define ROM_BANKED_OFFSET (0x4000)
+
+/// Defines a decoded GameShark code.
+struct gameshark {
+	/// The address to write to.
+	uint16_t addr;
+
+	/// The value to write.
+	uint8_t value;
+};
+
+/// Defines a decoded Game Genie code.
+struct game_genie {
+	/// The address to patch; always in ROM.
+	uint16_t addr;
+
+	/// The value to patch the ROM with.
+	uint8_t value;
+
+	/// The value the ROM must hold to be patched, if `has_cmp` is set.
+	uint8_t cmp;
+	bool has_cmp;
+};
+
+struct agoge_core_cheats {
+	/// The ROM to patch.
+	const uint8_t *rom;
+
+	/// The size of `rom` in bytes.
+	size_t rom_size;
+
+	/// The GameShark codes, in the order they were added.
+	struct gameshark gamesharks[AGOGE_CORE_CHEATS_GAMESHARK_MAX];
+
+	/// The number of GameShark codes.
+	size_t num_gamesharks;
+
+	/// The number of ROM pages.
+	size_t num_pages;
+
+	/// The patched copy of each ROM page, or `NULL` if it is not patched.
+	uint8_t *pages[];
+};
+
+/// Decodes the hexadecimal digits of a code, skipping dashes.
+///
+/// @returns The number of digits decoded, or 0 if the code holds another
+/// character or too many digits.
+NODISCARD static size_t digits_decode(const char *code,
+				      uint8_t digits[GAME_GENIE_CMP_DIGITS])
+{
+	size_t num_digits = 0;
+
+	for (; *code != '\0'; ++code) {
+		unsigned int digit;
+
+		switch (*code) {
+		case '-':
+			continue;
+
+		case '0' ... '9':
+			digit = (unsigned int)(*code - '0');
+			break;
+
+		case 'A' ... 'F':
+			digit = (unsigned int)(*code - 'A' + 10);
+			break;
+
+		case 'a' ... 'f':
+			digit = (unsigned int)(*code - 'a' + 10);
+			break;
+
+		default:
+			return 0;
+		}
+
+		if (num_digits == GAME_GENIE_CMP_DIGITS) {
+			return 0;
+		}
+		digits[num_digits++] = (uint8_t)digit;
+	}
+	return num_digits;
+}
+
+/// Decodes a Game Genie code `ABC-DEF-GHI`: `AB` is the new value, `FCDE` is
+/// the address with `F` inverted, and `GI` is the compare value XORed with $BA
+/// and rotated left by two bits. `H` is unused.
+NODISCARD static bool game_genie_decode(const uint8_t *const d,
+					const size_t num_digits,
+					struct game_genie *const gg)
+{
+	gg->value = (uint8_t)((d[0] << 4) | d[1]);
+	gg->addr = (uint16_t)(((d[5] ^ 0xF) << 12) | (d[2] << 8) | (d[3] << 4) |
+			      d[4]);
+	gg->has_cmp = (num_digits == GAME_GENIE_CMP_DIGITS);
+	gg->cmp = 0;
+
+	if (gg->has_cmp) {
+		const unsigned int cmp = (d[6] << 4) | d[8];
+		gg->cmp = (uint8_t)(((cmp >> 2) | (cmp << 6)) ^ 0xBA);
+	}
+	return gg->addr < 0x8000;
+}
+
+/// Determines if a ROM page is affected by a Game Genie code.
+NODISCARD static bool game_genie_hits(const struct agoge_core_cheats *cheats,
+				      const struct game_genie *const gg,
+				      const size_t page)
+{
+	const size_t offset = page * AGOGE_CORE_BUS_PAGE_SIZE;
+	const size_t addr_page = gg->addr >> AGOGE_CORE_BUS_PAGE_SHIFT;
+
+	if (gg->addr < ROM_BANKED_OFFSET) {
+		if (page != addr_page) {
+			return false;
+		}
+	} else if ((offset < ROM_BANKED_OFFSET) ||
+		   ((page % 2) != (addr_page % 2))) {
+		return false;
+	}
+
+	if (!gg->has_cmp) {
+		return true;
+	}
+
+	const size_t addr_offset = gg->addr & (AGOGE_CORE_BUS_PAGE_SIZE - 1);
+	return cheats->rom[offset + addr_offset] == gg->cmp;
+}
+
+NODISCARD static enum agoge_core_cheats_retval
+game_genie_add(struct agoge_core_cheats *const cheats,
+	       const struct game_genie *const gg)
+{
+	// Allocate every page first so that a failure leaves the cheat set
+	// unchanged.
+	for (size_t page = 0; page < cheats->num_pages; ++page) {
+		if ((cheats->pages[page] != NULL) ||
+		    !game_genie_hits(cheats, gg, page)) {
+			continue;
+		}
+
+		cheats->pages[page] = malloc(AGOGE_CORE_BUS_PAGE_SIZE);
+
+		if (unlikely(cheats->pages[page] == NULL)) {
+			return AGOGE_CORE_CHEATS_RETVAL_NO_MEM;
+		}
+
+		memcpy(cheats->pages[page],
+		       &cheats->rom[page * AGOGE_CORE_BUS_PAGE_SIZE],
+		       AGOGE_CORE_BUS_PAGE_SIZE);
+	}
+
+	for (size_t page = 0; page < cheats->num_pages; ++page) {
+		if (game_genie_hits(cheats, gg, page)) {
+			cheats->pages[page][gg->addr &
+					    (AGOGE_CORE_BUS_PAGE_SIZE - 1)] =
+				gg->value;
+		}
+	}
+	return AGOGE_CORE_CHEATS_RETVAL_OK;
+}
+
+struct agoge_core_cheats *agoge_core_cheats_create(const uint8_t *const rom,
+						   const size_t rom_size)
+{
+	const size_t num_pages = rom_size / AGOGE_CORE_BUS_PAGE_SIZE;
+	struct agoge_core_cheats *const cheats =
+		calloc(1, sizeof(*cheats) + (num_pages * sizeof(uint8_t *)));
+
+	if (cheats == NULL) {
+		return NULL;
+	}
+
+	cheats->rom = rom;
+	cheats->rom_size = rom_size;
+	cheats->num_pages = num_pages;
+
+	return cheats;
+}
+
+void agoge_core_cheats_destroy(struct agoge_core_cheats *const cheats)
+{
+	if (cheats == NULL) {
+		return;
+	}
+
+	for (size_t page = 0; page < cheats->num_pages; ++page) {
+		free(cheats->pages[page]);
+	}
+	free(cheats);
+}
+
+enum agoge_core_cheats_retval
+agoge_core_cheats_add(struct agoge_core_cheats *const cheats,
+		      const char *const code)
+{
+	uint8_t d[GAME_GENIE_CMP_DIGITS];
+	const size_t num_digits = digits_decode(code, d);
+
+	switch (num_digits) {
+	case GAME_GENIE_DIGITS:
+	case GAME_GENIE_CMP_DIGITS: {
+		struct game_genie gg;
+
+		if (!game_genie_decode(d, num_digits, &gg)) {
+			return AGOGE_CORE_CHEATS_RETVAL_INVALID_CODE;
+		}
+		return game_genie_add(cheats, &gg);
+	}
+
+	// The type byte `TT` selects a WRAM bank on the CGB, and is ignored.
+	case GAMESHARK_DIGITS:
+		if (cheats->num_gamesharks == AGOGE_CORE_CHEATS_GAMESHARK_MAX) {
+			return AGOGE_CORE_CHEATS_RETVAL_FULL;
+		}
+
+		cheats->gamesharks[cheats->num_gamesharks++] =
+			(struct gameshark){
+				.value = (uint8_t)((d[2] << 4) | d[3]),
+				.addr = (uint16_t)((d[6] << 12) | (d[7] << 8) |
+						   (d[4] << 4) | d[5])
+			};
+		return AGOGE_CORE_CHEATS_RETVAL_OK;
+
+	default:
+		return AGOGE_CORE_CHEATS_RETVAL_INVALID_CODE;
+	}
+}
+
+void agoge_core_cheats_clear(struct agoge_core_cheats *const cheats)
+{
+	// Attached contexts may still map the patched pages, so they are kept
+	// until the cheat set is destroyed, and unpatched in place.
+	for (size_t page = 0; page < cheats->num_pages; ++page) {
+		if (cheats->pages[page] != NULL) {
+			memcpy(cheats->pages[page],
+			       &cheats->rom[page * AGOGE_CORE_BUS_PAGE_SIZE],
+			       AGOGE_CORE_BUS_PAGE_SIZE);
+		}
+	}
+	cheats->num_gamesharks = 0;
+}
+
+void agoge_core_cheats_attach(struct agoge_core_ctx *const ctx,
+			      struct agoge_core_cheats *const cheats)
+{
+	ctx->cheats = cheats;
+	agoge_core_bus_map_update(ctx);
+}
+
+PURE const uint8_t *
+agoge_core_cheats_rom_page(const struct agoge_core_ctx *const ctx,
+			   const size_t offset)
+{
+	const struct agoge_core_cheats *const cheats = ctx->cheats;
+
+	if ((cheats == NULL) || (cheats->rom != ctx->bus.cart.data)) {
+		return NULL;
+	}
+
+	const size_t page = offset / AGOGE_CORE_BUS_PAGE_SIZE;
+	return (page < cheats->num_pages) ? cheats->pages[page] : NULL;
+}
+
+void agoge_core_cheats_frame_end(struct agoge_core_ctx *const ctx)
+{
+	const struct agoge_core_cheats *const cheats = ctx->cheats;
+
+	if (cheats == NULL) {
+		return;
+	}
+
+	for (size_t i = 0; i < cheats->num_gamesharks; ++i) {
+		agoge_core_bus_poke_range(ctx, cheats->gamesharks[i].addr,
+					  &cheats->gamesharks[i].value, 1);
+	}
+}
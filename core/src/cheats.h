@@ -0,0 +1,42 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "agoge/cheats.h"
+#include "ctx.h"
+
+/// Retrieves the Game Genie override of a ROM page.
+///
+/// @param ctx The emulator context.
+/// @param offset The offset of the page within the ROM.
+/// @returns The patched copy of the page, or `NULL` if the page is not
+/// patched.
+const uint8_t *agoge_core_cheats_rom_page(const struct agoge_core_ctx *ctx,
+					  size_t offset);
+
+/// Applies the GameShark codes of the cheat set attached to a context, if
+/// any. Called at each frame boundary.
+///
+/// @param ctx The emulator context.
+void agoge_core_cheats_frame_end(struct agoge_core_ctx *ctx);
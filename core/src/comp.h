@@ -21,6 +21,9 @@
 #pragma once
 
 #define NODISCARD __attribute__((warn_unused_result))
+#define PURE __attribute__((pure))
+#define CONST __attribute__((const))
+#define MALLOC __attribute__((malloc))
 
 #define likely(x) __builtin_expect(!!(x), 1)
 #define unlikely(x) __builtin_expect(!!(x), 0)
@@ -141,6 +141,7 @@
 #define CPU_OP_LD_MEM_HL_E	(UINT8_C(0x73))
 #define CPU_OP_LD_MEM_HL_H	(UINT8_C(0x74))
 #define CPU_OP_LD_MEM_HL_L	(UINT8_C(0x75))
+#define CPU_OP_HALT		(UINT8_C(0x76))
 #define CPU_OP_LD_MEM_HL_A	(UINT8_C(0x77))
 #define CPU_OP_LD_A_B		(UINT8_C(0x78))
 #define CPU_OP_LD_A_C		(UINT8_C(0x79))
@@ -532,4 +533,9 @@
 #define CPU_FLAG_HALF_CARRY	(BIT_5)
 #define CPU_FLAG_CARRY		(BIT_4)
 
+#define CPU_INTR_MASK		(UINT8_C(0x1F))
+#define CPU_INTR_VEC_BASE	(UINT16_C(0x0040))
+#define CPU_INTR_VEC_SIZE	(8)
+#define CPU_INTR_CYCLES		(20)
+
 // clang-format on
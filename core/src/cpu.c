@@ -395,6 +395,7 @@ static void jp_if(struct agoge_core_ctx *const ctx, const bool cond_met)
 
 	if (cond_met) {
 		ctx->cpu.reg.pc = addr;
+		ctx->cpu.cycles += 4;
 	}
 }
 
@@ -402,6 +403,7 @@ static void ret_if(struct agoge_core_ctx *const ctx, const bool cond_met)
 {
 	if (cond_met) {
 		ctx->cpu.reg.pc = stack_pop(ctx);
+		ctx->cpu.cycles += 12;
 	}
 }
 
@@ -412,6 +414,7 @@ static void call_if(struct agoge_core_ctx *const ctx, const bool cond_met)
 	if (cond_met) {
 		stack_push(ctx, ctx->cpu.reg.pc);
 		ctx->cpu.reg.pc = addr;
+		ctx->cpu.cycles += 12;
 	}
 }
 
@@ -421,6 +424,7 @@ static void jr_if(struct agoge_core_ctx *const ctx, const bool cond_met)
 
 	if (cond_met) {
 		ctx->cpu.reg.pc += off;
+		ctx->cpu.cycles += 4;
 	}
 }
 
@@ -475,6 +479,18 @@ static void op_daa(struct agoge_core_ctx *const ctx)
 	ctx->cpu.reg.f &= ~CPU_FLAG_HALF_CARRY;
 }
 
+/// Retrieves the number of T-cycles taken by a CB-prefixed instruction, not
+/// counting the prefix itself.
+NODISCARD static unsigned int cb_op_cycles(const uint8_t instr)
+{
+	// Only instructions operating on (HL) access memory; of those, BIT only
+	// reads it.
+	if ((instr & 0x07) != 0x06) {
+		return 4;
+	}
+	return ((instr & 0xC0) == 0x40) ? 8 : 12;
+}
+
 static void rst(struct agoge_core_ctx *const ctx, const uint16_t vec)
 {
 	stack_push(ctx, ctx->cpu.reg.pc);
@@ -484,23 +500,103 @@ static void rst(struct agoge_core_ctx *const ctx, const uint16_t vec)
 void agoge_core_cpu_reset(struct agoge_core_ctx *const ctx)
 {
 	ctx->cpu.reg.pc = CPU_PWRUP_REG_PC;
+	ctx->cpu.ie = 0;
+	ctx->cpu.ifr = 0;
+	ctx->cpu.ime = false;
+	ctx->cpu.ime_pending = false;
+	ctx->cpu.halted = false;
+}
+
+void agoge_core_cpu_yield(struct agoge_core_ctx *const ctx)
+{
+	ctx->cpu.run_end = 0;
+}
+
+void agoge_core_cpu_intr_raise(struct agoge_core_ctx *const ctx,
+			       const uint8_t intr)
+{
+	ctx->cpu.ifr |= intr;
+	agoge_core_cpu_yield(ctx);
+}
+
+void agoge_core_cpu_intr_handle(struct agoge_core_ctx *const ctx)
+{
+	// The instruction following `EI` has completed; see `ei`.
+	if (unlikely(ctx->cpu.ime_pending)) {
+		ctx->cpu.ime_pending = false;
+		ctx->cpu.ime = true;
+	}
+
+	const uint8_t pending = ctx->cpu.ie & ctx->cpu.ifr & CPU_INTR_MASK;
+
+	if (likely(pending == 0)) {
+		return;
+	}
+
+	ctx->cpu.halted = false;
+
+	if (!ctx->cpu.ime) {
+		return;
+	}
+
+	const unsigned int idx = (unsigned int)__builtin_ctz(pending);
+
+	ctx->cpu.ime = false;
+	ctx->cpu.ifr &= ~(1 << idx);
+
+	stack_push(ctx, ctx->cpu.reg.pc);
+	ctx->cpu.reg.pc = CPU_INTR_VEC_BASE + (idx * CPU_INTR_VEC_SIZE);
+	ctx->cpu.cycles += CPU_INTR_CYCLES;
 }
 
 void agoge_core_cpu_run(struct agoge_core_ctx *const ctx,
-			unsigned int run_cycles)
+			const unsigned int run_cycles)
 {
 	// The CPU was requested to run for zero cycles; this is nonsense.
 	assert(run_cycles != 0);
 
-#define DISPATCH()                                 \
-	({                                         \
-		if (unlikely(run_cycles-- == 0)) { \
-			return;                    \
-		}                                  \
-		instr = read_u8(ctx);              \
-		goto *op_tbl[instr];               \
+	ctx->cpu.run_end = ctx->cpu.cycles + run_cycles;
+
+#define DISPATCH()                                                   \
+	({                                                           \
+		if (unlikely(ctx->cpu.cycles >= ctx->cpu.run_end)) { \
+			return;                                      \
+		}                                                    \
+		instr = read_u8(ctx);                                \
+		ctx->cpu.cycles += op_cycles[instr];                 \
+		goto *op_tbl[instr];                                 \
 	})
 
+	// The number of T-cycles taken by each instruction. Conditional branches
+	// are listed with their untaken timing, and unconditional branches with
+	// the timing of an untaken conditional branch of the same kind; the
+	// penalty for a taken branch is added by jp_if(), jr_if(), call_if() and
+	// ret_if(). CB-prefixed instructions are listed with the cost of the
+	// prefix only; see cb_op_cycles().
+	static const uint8_t op_cycles[] = {
+		// clang-format off
+
+		//      x0  x1  x2  x3  x4  x5  x6  x7  x8  x9  xA  xB  xC  xD  xE  xF
+		/* 0 */  4, 12,  8,  8,  4,  4,  8,  4, 20,  8,  8,  8,  4,  4,  8,  4,
+		/* 1 */  4, 12,  8,  8,  4,  4,  8,  4,  8,  8,  8,  8,  4,  4,  8,  4,
+		/* 2 */  8, 12,  8,  8,  4,  4,  8,  4,  8,  8,  8,  8,  4,  4,  8,  4,
+		/* 3 */  8, 12,  8,  8, 12, 12, 12,  4,  8,  8,  8,  8,  4,  4,  8,  4,
+		/* 4 */  4,  4,  4,  4,  4,  4,  8,  4,  4,  4,  4,  4,  4,  4,  8,  4,
+		/* 5 */  4,  4,  4,  4,  4,  4,  8,  4,  4,  4,  4,  4,  4,  4,  8,  4,
+		/* 6 */  4,  4,  4,  4,  4,  4,  8,  4,  4,  4,  4,  4,  4,  4,  8,  4,
+		/* 7 */  8,  8,  8,  8,  8,  8,  4,  8,  4,  4,  4,  4,  4,  4,  8,  4,
+		/* 8 */  4,  4,  4,  4,  4,  4,  8,  4,  4,  4,  4,  4,  4,  4,  8,  4,
+		/* 9 */  4,  4,  4,  4,  4,  4,  8,  4,  4,  4,  4,  4,  4,  4,  8,  4,
+		/* A */  4,  4,  4,  4,  4,  4,  8,  4,  4,  4,  4,  4,  4,  4,  8,  4,
+		/* B */  4,  4,  4,  4,  4,  4,  8,  4,  4,  4,  4,  4,  4,  4,  8,  4,
+		/* C */  8, 12, 12, 12, 12, 16,  8, 16,  8,  4, 12,  4, 12, 12,  8, 16,
+		/* D */  8, 12, 12,  0, 12, 16,  8, 16,  8,  4, 12,  0, 12,  0,  8, 16,
+		/* E */ 12, 12,  8,  0,  0, 16,  8, 16, 16,  4, 16,  0,  0,  0,  8, 16,
+		/* F */ 12, 12,  8,  4,  0, 16,  8, 16, 12,  8, 16,  4,  0,  0,  8, 16
+
+		// clang-format on
+	};
+
 	static const void *const op_tbl[] = {
 		// clang-format off
 
@@ -621,6 +717,7 @@ void agoge_core_cpu_run(struct agoge_core_ctx *const ctx,
 		[CPU_OP_LD_MEM_HL_E]		= &&ld_mem_hl_e,
 		[CPU_OP_LD_MEM_HL_H]		= &&ld_mem_hl_h,
 		[CPU_OP_LD_MEM_HL_L]		= &&ld_mem_hl_l,
+		[CPU_OP_HALT]			= &&halt,
 		[CPU_OP_LD_MEM_HL_A]		= &&ld_mem_hl_a,
 		[CPU_OP_LD_A_B]			= &&ld_a_b,
 		[CPU_OP_LD_A_C]			= &&ld_a_c,
@@ -1505,6 +1602,10 @@ ld_mem_hl_l:
 	agoge_core_bus_write(ctx, ctx->cpu.reg.hl, ctx->cpu.reg.l);
 	DISPATCH();
 
+halt:
+	ctx->cpu.halted = true;
+	return;
+
 ld_mem_hl_a:
 	agoge_core_bus_write(ctx, ctx->cpu.reg.hl, ctx->cpu.reg.a);
 	DISPATCH();
@@ -1843,6 +1944,8 @@ jp_z_u16:
 
 prefix_cb:
 	instr = read_u8(ctx);
+	ctx->cpu.cycles += cb_op_cycles(instr);
+
 	goto *cb_tbl[instr];
 
 rlc_b:
@@ -2918,8 +3021,10 @@ ret_c:
 	DISPATCH();
 
 reti:
-	// Handle interrupt stuff here
 	ret_if(ctx, true);
+	ctx->cpu.ime = true;
+	agoge_core_cpu_yield(ctx);
+
 	DISPATCH();
 
 jp_c_u16:
@@ -2995,6 +3100,8 @@ pop_af:
 	DISPATCH();
 
 di:
+	ctx->cpu.ime = false;
+	ctx->cpu.ime_pending = false;
 	DISPATCH();
 
 push_af:
@@ -3022,6 +3129,12 @@ ld_a_mem_u16:
 	DISPATCH();
 
 ei:
+	// IME is only set after the next instruction, so that, e.g., `EI; RET`
+	// returns before an interrupt is taken. Exactly one more instruction
+	// runs before control returns to the scheduler, which sets it.
+	ctx->cpu.ime_pending = true;
+	ctx->cpu.run_end = ctx->cpu.cycles + 1;
+
 	DISPATCH();
 
 cp_a_u8:
@@ -20,8 +20,30 @@
 
 #pragma once
 
-#include "agoge/ctx.h"
+#include "ctx.h"
+
+/// The interrupt sources, as laid out in the IE and IF registers.
+#define AGOGE_CORE_CPU_INTR_VBLANK (1 << 0)
+#define AGOGE_CORE_CPU_INTR_STAT (1 << 1)
+#define AGOGE_CORE_CPU_INTR_TIMER (1 << 2)
+#define AGOGE_CORE_CPU_INTR_SERIAL (1 << 3)
+#define AGOGE_CORE_CPU_INTR_JOYPAD (1 << 4)
 
 void agoge_core_cpu_reset(struct agoge_core_ctx *ctx);
 
 void agoge_core_cpu_run(struct agoge_core_ctx *ctx, unsigned int run_cycles);
+
+/// Makes the current call to `agoge_core_cpu_run` return after the current
+/// instruction, so that the scheduler can react to a change of state (e.g.,
+/// a newly pending interrupt).
+void agoge_core_cpu_yield(struct agoge_core_ctx *ctx);
+
+/// Requests interrupts.
+///
+/// @param ctx The emulator context.
+/// @param intr The `AGOGE_CORE_CPU_INTR_*` bits to request.
+void agoge_core_cpu_intr_raise(struct agoge_core_ctx *ctx, uint8_t intr);
+
+/// Services the highest priority pending interrupt, if any, and wakes the CPU
+/// up from `HALT` if an interrupt is pending.
+void agoge_core_cpu_intr_handle(struct agoge_core_ctx *ctx);
@@ -21,18 +21,244 @@
 /// @file ctx.c Defines the implementation of an agoge context.
 
 #include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
 
-#include "agoge/ctx.h"
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif // defined(__linux__)
+
+#include "apu.h"
 #include "bus.h"
+#include "cheats.h"
 #include "comp.h"
 #include "cpu.h"
+#include "ctx.h"
 #include "log.h"
+#include "palette.h"
+#include "ppu.h"
+#include "render.h"
 
 LOG_CHANNEL(AGOGE_CORE_LOG_CH_CTX);
 
+#define CACHE_LINE_SIZE (64)
+#define HUGEPAGE_SIZE (2097152)
+
+// The interpreter's working set must stay within the first cache line of the
+// context, and debugger state must stay out of the way after the bus.
+static_assert(_Alignof(struct agoge_core_ctx) == CACHE_LINE_SIZE,
+	      "context is not cache line aligned");
+static_assert(offsetof(struct agoge_core_ctx, cpu) == 0,
+	      "CPU registers are not at the start of the context");
+static_assert(offsetof(struct agoge_core_ctx, bus.cart) +
+			      sizeof(struct agoge_core_cart) <=
+		      CACHE_LINE_SIZE,
+	      "cartridge state does not fit in the first cache line");
+static_assert(offsetof(struct agoge_core_ctx, bus.read_map) +
+			      sizeof(((struct agoge_core_bus *)0)->read_map) <=
+		      (2 * CACHE_LINE_SIZE),
+	      "read page map does not fit in the first two cache lines");
+static_assert(offsetof(struct agoge_core_bus, serial) >
+		      offsetof(struct agoge_core_bus, wram),
+	      "serial buffer is not at the end of the bus");
+static_assert(offsetof(struct agoge_core_ctx, log) >=
+		      offsetof(struct agoge_core_ctx, bus) +
+			      sizeof(struct agoge_core_bus),
+	      "logger state is not in the cold tail");
+static_assert(offsetof(struct agoge_core_ctx, disasm) >
+		      offsetof(struct agoge_core_ctx, log),
+	      "disassembler state is not in the cold tail");
+
+/// Identifies a save state: "AGST" in little endian.
+#define STATE_MAGIC (UINT32_C(0x54534741))
+
+/// The version of the save state layout; bump on any change to it.
+#define STATE_VERSION (UINT32_C(9))
+
+/// Defines the layout of a save state.
+struct state {
+	uint32_t magic;
+	uint32_t version;
+
+	struct agoge_core_cpu cpu;
+	struct agoge_core_joypad joypad;
+	struct agoge_core_ppu ppu;
+	struct agoge_core_apu apu;
+	unsigned int rom_bank;
+
+	uint8_t hram[AGOGE_CORE_BUS_HRAM_SIZE];
+	uint8_t wram[AGOGE_CORE_BUS_WRAM_SIZE];
+	uint8_t vram[AGOGE_CORE_BUS_VRAM_SIZE];
+	uint8_t oam[AGOGE_CORE_BUS_OAM_SIZE];
+	struct agoge_core_palette palette;
+};
+
+#define ALIGN_UP(x, align) (((x) + ((align) - 1)) & ~((size_t)(align) - 1))
+
+/// Bookkeeping stored directly after the context in the same allocation. It
+/// lives outside of `struct agoge_core_ctx` so that clearing or copying a
+/// context never clobbers it.
+struct alloc_info {
+	struct agoge_core_ctx_allocator allocator;
+	size_t size;
+};
+
+#define ALLOC_INFO_OFFSET \
+	(ALIGN_UP(sizeof(struct agoge_core_ctx), _Alignof(struct alloc_info)))
+
+static void *default_alloc(void *const udata, const size_t size,
+			   const size_t align)
+{
+	(void)udata;
+
+	void *const ptr = aligned_alloc(align, size);
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	if ((ptr != NULL) && (align == HUGEPAGE_SIZE)) {
+		madvise(ptr, size, MADV_HUGEPAGE);
+	}
+#endif // defined(__linux__) && defined(MADV_HUGEPAGE)
+
+	return ptr;
+}
+
+static void default_free(void *const udata, void *const ptr, const size_t size)
+{
+	(void)udata;
+	(void)size;
+
+	free(ptr);
+}
+
+NODISCARD static size_t align_size(const enum agoge_core_ctx_align align)
+{
+	switch (align) {
+	case AGOGE_CORE_CTX_ALIGN_HUGEPAGE:
+		return HUGEPAGE_SIZE;
+
+	case AGOGE_CORE_CTX_ALIGN_CACHE_LINE:
+	default:
+		return CACHE_LINE_SIZE;
+	}
+}
+
+static struct alloc_info *alloc_info_get(struct agoge_core_ctx *const ctx)
+{
+	return (struct alloc_info *)(void *)((uint8_t *)ctx +
+					     ALLOC_INFO_OFFSET);
+}
+
+CONST size_t agoge_core_ctx_size(const enum agoge_core_ctx_align align)
+{
+	return ALIGN_UP(ALLOC_INFO_OFFSET + sizeof(struct alloc_info),
+			align_size(align));
+}
+
+struct agoge_core_ctx *
+agoge_core_ctx_create(const struct agoge_core_ctx_allocator *allocator,
+		      const enum agoge_core_ctx_align align)
+{
+	static const struct agoge_core_ctx_allocator default_allocator = {
+		.alloc = &default_alloc,
+		.free = &default_free,
+		.udata = NULL
+	};
+
+	if (allocator == NULL) {
+		allocator = &default_allocator;
+	}
+
+	const size_t size = agoge_core_ctx_size(align);
+	struct agoge_core_ctx *const ctx =
+		allocator->alloc(allocator->udata, size, align_size(align));
+
+	if (unlikely(ctx == NULL)) {
+		return NULL;
+	}
+
+	agoge_core_ctx_clear(ctx);
+
+	struct alloc_info *const info = alloc_info_get(ctx);
+
+	info->allocator = *allocator;
+	info->size = size;
+
+	return ctx;
+}
+
+void agoge_core_ctx_destroy(struct agoge_core_ctx *const ctx)
+{
+	if (ctx == NULL) {
+		return;
+	}
+
+	const struct alloc_info info = *alloc_info_get(ctx);
+
+	if (info.allocator.free != NULL) {
+		info.allocator.free(info.allocator.udata, ctx, info.size);
+	}
+}
+
+void agoge_core_ctx_clear(struct agoge_core_ctx *const ctx)
+{
+	memset(ctx, 0, sizeof(*ctx));
+}
+
 void agoge_core_ctx_reset(struct agoge_core_ctx *const ctx)
 {
 	agoge_core_cpu_reset(ctx);
+	agoge_core_ppu_reset(ctx);
+	agoge_core_palette_reset(ctx);
+	agoge_core_apu_reset(ctx);
+	agoge_core_bus_map_update(ctx);
+}
+
+void agoge_core_ctx_copy(struct agoge_core_ctx *const dst,
+			 const struct agoge_core_ctx *const src)
+{
+	// The render settings, a renderer or an audio buffer follow their
+	// context, not the emulation state.
+	const uint8_t render = dst->ppu.render;
+	const uint32_t render_interval = dst->ppu.render_interval;
+	struct agoge_core_render *const renderer = dst->ppu.renderer;
+	const struct agoge_core_video video = dst->ppu.video;
+	struct agoge_core_audio *const audio = dst->apu.audio;
+	const uint8_t apu_level = dst->apu.level;
+
+	memcpy(dst, src, sizeof(*dst));
+	dst->ppu.render = render;
+	dst->ppu.render_interval = render_interval;
+	dst->ppu.renderer = renderer;
+	dst->ppu.video = video;
+	dst->apu.audio = audio;
+	dst->apu.level = apu_level;
+	agoge_core_apu_restore(dst);
+	agoge_core_bus_map_update(dst);
+
+	if (renderer != NULL) {
+		agoge_core_render_resync(dst);
+	}
+}
+
+/// Runs the CPU until the next PPU event or `end`, whichever comes first, and
+/// then brings the PPU up to date. The CPU may return early if it yields.
+static void slice_run(struct agoge_core_ctx *const ctx, const uint64_t end)
+{
+	agoge_core_cpu_intr_handle(ctx);
+
+	const uint64_t slice_end =
+		(ctx->ppu.next_event < end) ? ctx->ppu.next_event : end;
+
+	if (ctx->cpu.cycles < slice_end) {
+		if (ctx->cpu.halted) {
+			ctx->cpu.cycles = slice_end;
+		} else {
+			agoge_core_cpu_run(
+				ctx, (unsigned int)(slice_end - ctx->cpu.cycles));
+		}
+	}
+	agoge_core_ppu_update(ctx);
 }
 
 void agoge_core_ctx_step(struct agoge_core_ctx *const ctx,
@@ -40,5 +266,144 @@ void agoge_core_ctx_step(struct agoge_core_ctx *const ctx,
 {
 	assert(num_cycles > 0);
 
-	agoge_core_cpu_run(ctx, num_cycles);
+	const uint64_t frames = ctx->ppu.frames;
+	const uint64_t end = ctx->cpu.cycles + num_cycles;
+
+	while (ctx->cpu.cycles < end) {
+		slice_run(ctx, end);
+	}
+
+	// The APU catches up at the end of a frame, as in
+	// `agoge_core_ctx_run_frame`, or once it lags a frame behind, so that
+	// short steps, e.g., of single instructions, do not each flush it.
+	if (ctx->ppu.frames != frames) {
+		agoge_core_cheats_frame_end(ctx);
+		agoge_core_apu_frame_end(ctx);
+	} else if ((ctx->cpu.cycles - ctx->apu.cycles) >=
+		   AGOGE_CORE_FRAME_CYCLES) {
+		agoge_core_apu_frame_end(ctx);
+	}
+}
+
+void agoge_core_ctx_run_frame(struct agoge_core_ctx *const ctx)
+{
+	const uint64_t frames = ctx->ppu.frames;
+
+	while (ctx->ppu.frames == frames) {
+		slice_run(ctx, UINT64_MAX);
+	}
+	agoge_core_cheats_frame_end(ctx);
+	agoge_core_apu_frame_end(ctx);
+}
+
+CONST size_t agoge_core_ctx_state_size(void)
+{
+	return sizeof(struct state);
+}
+
+void agoge_core_ctx_state_save(const struct agoge_core_ctx *const ctx,
+			       void *const dst)
+{
+	struct state *const state = dst;
+
+	memset(state, 0, sizeof(*state));
+
+	state->magic = STATE_MAGIC;
+	state->version = STATE_VERSION;
+	state->cpu = ctx->cpu;
+	state->joypad = ctx->joypad;
+	state->ppu = ctx->ppu;
+	state->ppu.ops = NULL;
+	state->ppu.kernels = NULL;
+	state->ppu.renderer = NULL;
+	memset(&state->ppu.video, 0, sizeof(state->ppu.video));
+	state->apu = ctx->apu;
+	state->apu.audio = NULL;
+	state->rom_bank = ctx->bus.cart.rom_bank;
+
+	memcpy(state->hram, ctx->bus.hram, sizeof(state->hram));
+	memcpy(state->wram, ctx->bus.wram, sizeof(state->wram));
+	memcpy(state->vram, ctx->bus.vram, sizeof(state->vram));
+	memcpy(state->oam, ctx->bus.oam, sizeof(state->oam));
+	state->palette = ctx->bus.palette;
+}
+
+bool agoge_core_ctx_state_load(struct agoge_core_ctx *const ctx,
+			       const void *const src)
+{
+	const struct state *const state = src;
+
+	if ((state->magic != STATE_MAGIC) ||
+	    (state->version != STATE_VERSION)) {
+		LOG_ERR(ctx, "failed to load state: bad magic or version");
+		return false;
+	}
+
+	// The render settings belong to the host, not to the state.
+	const uint8_t render = ctx->ppu.render;
+	const uint32_t render_interval = ctx->ppu.render_interval;
+	struct agoge_core_render *const renderer = ctx->ppu.renderer;
+	const struct agoge_core_video video = ctx->ppu.video;
+	struct agoge_core_audio *const audio = ctx->apu.audio;
+	const uint8_t apu_level = ctx->apu.level;
+
+	ctx->cpu = state->cpu;
+	ctx->joypad = state->joypad;
+	ctx->ppu = state->ppu;
+	ctx->ppu.render = render;
+	ctx->ppu.render_interval = render_interval;
+	ctx->ppu.renderer = renderer;
+	ctx->ppu.video = video;
+	ctx->apu = state->apu;
+	ctx->apu.audio = audio;
+	ctx->apu.level = apu_level;
+	ctx->bus.cart.rom_bank = state->rom_bank;
+
+	memcpy(ctx->bus.hram, state->hram, sizeof(state->hram));
+	memcpy(ctx->bus.wram, state->wram, sizeof(state->wram));
+	memcpy(ctx->bus.vram, state->vram, sizeof(state->vram));
+	memcpy(ctx->bus.oam, state->oam, sizeof(state->oam));
+
+	// Color correction belongs to the host; convert the colors with it.
+	const bool correct = ctx->bus.palette.correct;
+
+	ctx->bus.palette = state->palette;
+	ctx->bus.palette.correct = correct;
+
+	// The backend functions and kernels belong to this process, not to the
+	// state.
+	agoge_core_ppu_tables_select(ctx);
+	agoge_core_ppu_vram_invalidate(ctx);
+	agoge_core_palette_refresh(ctx);
+	agoge_core_apu_restore(ctx);
+	agoge_core_bus_map_update(ctx);
+
+	if (renderer != NULL) {
+		agoge_core_render_resync(ctx);
+	}
+	return true;
+}
+
+CONST struct agoge_core_log *
+agoge_core_ctx_log(struct agoge_core_ctx *const ctx)
+{
+	return &ctx->log;
+}
+
+CONST const uint8_t *
+agoge_core_ctx_frame(const struct agoge_core_ctx *const ctx)
+{
+	return ctx->ppu.frame;
+}
+
+CONST const struct agoge_core_ppu *
+agoge_core_ctx_ppu(const struct agoge_core_ctx *const ctx)
+{
+	return &ctx->ppu;
+}
+
+CONST struct agoge_core_video *
+agoge_core_ctx_video(struct agoge_core_ctx *const ctx)
+{
+	return &ctx->ppu.video;
 }
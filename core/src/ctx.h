@@ -0,0 +1,55 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "agoge/ctx.h"
+
+/// Defines the layout of an agoge context; see `agoge/ctx.h`.
+///
+/// The context is split into a hot header, holding the interpreter's working
+/// set (CPU registers and cartridge banking state) within the first cache
+/// line, and a cold tail holding log and debugger state. The layout is
+/// enforced by static assertions in ctx.c.
+struct agoge_core_ctx {
+	/// The CPU instance to use for this context.
+	struct agoge_core_cpu cpu;
+
+	/// The system bus instance to use for this context.
+	struct agoge_core_bus bus;
+
+	/// The joypad instance to use for this context.
+	struct agoge_core_joypad joypad;
+
+	/// The PPU instance to use for this context.
+	struct agoge_core_ppu ppu;
+
+	/// The APU instance to use for this context.
+	struct agoge_core_apu apu;
+
+	/// The cheat set attached to this context, or `NULL` if none is.
+	struct agoge_core_cheats *cheats;
+
+	/// The logger instance to use for this context.
+	struct agoge_core_log log;
+
+	/// The disassembler instance to use for this context.
+	struct agoge_core_disasm disasm;
+} __attribute__((aligned(64)));
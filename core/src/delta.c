@@ -0,0 +1,220 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file delta.c Defines the implementation of frame-delta encoding.
+
+#include <assert.h>
+#include <string.h>
+
+#include "agoge/delta.h"
+#include "agoge/ppu.h"
+#include "ppu.h"
+
+/// The longest run of a run-length encoded scanline.
+#define RUN_MAX (64)
+
+/// Run-length encodes a scanline, unless it does not fit in `size` bytes.
+///
+/// @returns The size of the encoded scanline, or zero if it did not fit.
+static size_t line_rle(const uint8_t *const src, uint8_t *const dst,
+		       const size_t size)
+{
+	size_t len = 0;
+	unsigned int x = 0;
+
+	while (x < AGOGE_CORE_FRAME_WIDTH) {
+		const uint8_t shade = src[x] & 3;
+		unsigned int run = 1;
+
+		while (((x + run) < AGOGE_CORE_FRAME_WIDTH) &&
+		       ((src[x + run] & 3) == shade) && (run < RUN_MAX)) {
+			run++;
+		}
+
+		if (len == size) {
+			return 0;
+		}
+
+		dst[len++] = (uint8_t)((shade << 6) | (run - 1));
+		x += run;
+	}
+	return len;
+}
+
+static void line_pack(const uint8_t *const src, uint8_t *const dst)
+{
+	for (unsigned int i = 0; i < AGOGE_CORE_DELTA_LINE_2BPP_SIZE; ++i) {
+		const uint8_t *const px = &src[i * 4];
+
+		dst[i] = (uint8_t)((px[0] & 3) | ((px[1] & 3) << 2) |
+				   ((px[2] & 3) << 4) | ((px[3] & 3) << 6));
+	}
+}
+
+/// Encodes the record of a scanline.
+///
+/// @returns The size of the record.
+static size_t rec_encode(const uint8_t *const src, const unsigned int ly,
+			 const unsigned int flags, uint8_t *const dst)
+{
+	dst[0] = (uint8_t)ly;
+
+	if (flags & AGOGE_CORE_DELTA_FLAG_RLE) {
+		// Only keep the runs if they are smaller than the packed line.
+		const size_t len =
+			line_rle(src, &dst[2],
+				 AGOGE_CORE_DELTA_LINE_2BPP_SIZE - 1);
+
+		if (len != 0) {
+			dst[1] = AGOGE_CORE_DELTA_ENC_RLE;
+			return 2 + len;
+		}
+	}
+
+	dst[1] = AGOGE_CORE_DELTA_ENC_2BPP;
+	line_pack(src, &dst[2]);
+
+	return 2 + AGOGE_CORE_DELTA_LINE_2BPP_SIZE;
+}
+
+void agoge_core_delta_reset(struct agoge_core_delta *const delta)
+{
+	memset(delta, 0, sizeof(*delta));
+}
+
+size_t agoge_core_delta_encode(struct agoge_core_delta *const delta,
+			       const struct agoge_core_ppu *const ppu,
+			       const unsigned int flags, uint8_t *const dst)
+{
+	const bool all = (flags & AGOGE_CORE_DELTA_FLAG_KEYFRAME) ||
+			 !delta->valid;
+
+	assert(agoge_core_ppu_renders(ppu));
+
+	size_t size = AGOGE_CORE_DELTA_HDR_SIZE;
+	uint8_t num_recs = 0;
+
+	for (unsigned int ly = 0; ly < AGOGE_CORE_FRAME_HEIGHT; ++ly) {
+		const uint64_t hash = ppu->line_hash[ly];
+
+		if (!all && (hash == delta->line_hash[ly])) {
+			continue;
+		}
+
+		size += rec_encode(&ppu->frame[ly * AGOGE_CORE_FRAME_WIDTH], ly,
+				   flags, &dst[size]);
+		delta->line_hash[ly] = hash;
+		num_recs++;
+	}
+
+	dst[0] = 0;
+	dst[1] = num_recs;
+	delta->valid = true;
+
+	return size;
+}
+
+/// Decodes a run-length encoded scanline.
+///
+/// @returns The number of bytes consumed, or zero if the runs are malformed.
+static size_t line_unrle(const uint8_t *const src, const size_t size,
+			 uint8_t *const dst)
+{
+	size_t len = 0;
+	unsigned int x = 0;
+
+	while (x < AGOGE_CORE_FRAME_WIDTH) {
+		if (len == size) {
+			return 0;
+		}
+
+		const uint8_t run = src[len++];
+		const unsigned int run_len = (run & (RUN_MAX - 1)) + 1;
+
+		if ((x + run_len) > AGOGE_CORE_FRAME_WIDTH) {
+			return 0;
+		}
+
+		memset(&dst[x], run >> 6, run_len);
+		x += run_len;
+	}
+	return len;
+}
+
+static void line_unpack(const uint8_t *const src, uint8_t *const dst)
+{
+	for (unsigned int x = 0; x < AGOGE_CORE_FRAME_WIDTH; ++x) {
+		dst[x] = (src[x / 4] >> ((x % 4) * 2)) & 3;
+	}
+}
+
+bool agoge_core_delta_decode(const uint8_t *const src, const size_t size,
+			     uint8_t *const frame)
+{
+	if (size < AGOGE_CORE_DELTA_HDR_SIZE) {
+		return false;
+	}
+
+	size_t pos = AGOGE_CORE_DELTA_HDR_SIZE;
+
+	for (unsigned int i = 0; i < src[1]; ++i) {
+		if ((size - pos) < 2) {
+			return false;
+		}
+
+		const unsigned int ly = src[pos];
+		const uint8_t enc = src[pos + 1];
+
+		if (ly >= AGOGE_CORE_FRAME_HEIGHT) {
+			return false;
+		}
+
+		uint8_t *const dst = &frame[ly * AGOGE_CORE_FRAME_WIDTH];
+		pos += 2;
+
+		switch (enc) {
+		case AGOGE_CORE_DELTA_ENC_2BPP:
+			if ((size - pos) < AGOGE_CORE_DELTA_LINE_2BPP_SIZE) {
+				return false;
+			}
+
+			line_unpack(&src[pos], dst);
+			pos += AGOGE_CORE_DELTA_LINE_2BPP_SIZE;
+
+			break;
+
+		case AGOGE_CORE_DELTA_ENC_RLE: {
+			const size_t len =
+				line_unrle(&src[pos], size - pos, dst);
+
+			if (len == 0) {
+				return false;
+			}
+
+			pos += len;
+			break;
+		}
+
+		default:
+			return false;
+		}
+	}
+	return pos == size;
+}
@@ -21,9 +21,9 @@
 #include <stdio.h>
 #include <string.h>
 
-#include "agoge/ctx.h"
 #include "comp.h"
 #include "cpu-defs.h"
+#include "ctx.h"
 #include "log.h"
 
 LOG_CHANNEL(AGOGE_CORE_LOG_CH_DISASM);
@@ -905,6 +905,13 @@ static const struct agoge_core_disasm_entry op_tbl[] = {
 		.num_traces	= 0
 	},
 
+	[CPU_OP_HALT] = {
+		.fmt		= "HALT",
+		.op		= OP_NONE,
+		.traces		= { TRACE_NONE },
+		.num_traces	= 0
+	},
+
 	[CPU_OP_LD_MEM_HL_A] = {
 		.fmt		= "LD (HL), A",
 		.op		= OP_NONE,
@@ -0,0 +1,398 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file frame-x86.c Defines the SSE2 and AVX2 frame post-processing kernels.
+///
+/// Each function is compiled for its instruction set through a target
+/// attribute, so that the rest of the core does not require it; frame.c only
+/// selects these kernels when the host supports them.
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#include "frame.h"
+
+#define SSE2 __attribute__((target("sse2")))
+#define AVX2 __attribute__((target("avx2")))
+
+SSE2 static __m128i luma_sse2(const __m128i idx, const __m128i lut[4])
+{
+	// SSE2 has no byte shuffle, so select each palette entry by comparison.
+	__m128i res = _mm_and_si128(_mm_cmpeq_epi8(idx, _mm_setzero_si128()),
+				    lut[0]);
+
+	for (int i = 1; i < 4; ++i) {
+		const __m128i mask = _mm_cmpeq_epi8(idx, _mm_set1_epi8((char)i));
+		res = _mm_or_si128(res, _mm_and_si128(mask, lut[i]));
+	}
+	return res;
+}
+
+SSE2 static void lut_load_sse2(const uint8_t lut[4], __m128i dst[4])
+{
+	for (int i = 0; i < 4; ++i) {
+		dst[i] = _mm_set1_epi8((char)lut[i]);
+	}
+}
+
+SSE2 static void luma_row_sse2(const uint8_t *const src, const uint8_t lut[4],
+			       uint8_t *const dst)
+{
+	const __m128i mask = _mm_set1_epi8(3);
+	__m128i lut_v[4];
+
+	lut_load_sse2(lut, lut_v);
+
+	for (size_t x = 0; x < AGOGE_CORE_FRAME_WIDTH; x += 16) {
+		const __m128i idx = _mm_and_si128(
+			_mm_loadu_si128((const __m128i *)(const void *)&src[x]),
+			mask);
+
+		_mm_storeu_si128((__m128i *)(void *)&dst[x],
+				 luma_sse2(idx, lut_v));
+	}
+}
+
+SSE2 static void vsum_sse2(const uint8_t *const src,
+			   const unsigned int num_rows,
+			   const uint8_t *const weights, const uint8_t lut[4],
+			   uint16_t acc[AGOGE_CORE_FRAME_WIDTH])
+{
+	enum { NUM_VECS = AGOGE_CORE_FRAME_WIDTH / 8 };
+
+	const __m128i mask = _mm_set1_epi8(3);
+	const __m128i zero = _mm_setzero_si128();
+
+	__m128i lut_v[4];
+	__m128i sum[NUM_VECS];
+
+	lut_load_sse2(lut, lut_v);
+
+	for (size_t i = 0; i < NUM_VECS; ++i) {
+		sum[i] = zero;
+	}
+
+	for (unsigned int y = 0; y < num_rows; ++y) {
+		const uint8_t *const row = &src[y * AGOGE_CORE_FRAME_WIDTH];
+		const __m128i w = _mm_set1_epi16((short)weights[y]);
+
+		for (size_t x = 0; x < AGOGE_CORE_FRAME_WIDTH; x += 16) {
+			const __m128i idx = _mm_and_si128(
+				_mm_loadu_si128(
+					(const __m128i *)(const void *)&row[x]),
+				mask);
+
+			const __m128i luma = luma_sse2(idx, lut_v);
+
+			__m128i *const dst = &sum[x / 8];
+
+			dst[0] = _mm_add_epi16(
+				dst[0],
+				_mm_mullo_epi16(_mm_unpacklo_epi8(luma, zero),
+						w));
+			dst[1] = _mm_add_epi16(
+				dst[1],
+				_mm_mullo_epi16(_mm_unpackhi_epi8(luma, zero),
+						w));
+		}
+	}
+
+	for (size_t i = 0; i < NUM_VECS; ++i) {
+		_mm_storeu_si128((__m128i *)(void *)&acc[i * 8], sum[i]);
+	}
+}
+
+SSE2 static __m128i pack_2bpp_u32_sse2(__m128i v)
+{
+	// Each 32-bit lane holds four pixels, one per byte. Fold the second and
+	// fourth byte next to the first and third, then fold the result of the
+	// upper half next to the lower half.
+	v = _mm_and_si128(v, _mm_set1_epi8(3));
+	v = _mm_or_si128(v, _mm_srli_epi32(v, 6));
+	v = _mm_or_si128(v, _mm_srli_epi32(v, 12));
+
+	return _mm_and_si128(v, _mm_set1_epi32(0xFF));
+}
+
+SSE2 static void pack_2bpp_sse2(const uint8_t *const src, uint8_t *const dst)
+{
+	for (size_t i = 0; i < AGOGE_CORE_FRAME_SIZE; i += 64) {
+		__m128i v[4];
+
+		for (size_t j = 0; j < 4; ++j) {
+			v[j] = pack_2bpp_u32_sse2(_mm_loadu_si128(
+				(const __m128i *)(const void *)&src[i +
+								    (j * 16)]));
+		}
+
+		const __m128i lo = _mm_packs_epi32(v[0], v[1]);
+		const __m128i hi = _mm_packs_epi32(v[2], v[3]);
+
+		_mm_storeu_si128((__m128i *)(void *)&dst[i / 4],
+				 _mm_packus_epi16(lo, hi));
+	}
+}
+
+/// Selects the 32-bit palette entry of each index, as `luma_sse2` does.
+SSE2 static __m128i select_epi32_sse2(const __m128i idx, const __m128i lut[4])
+{
+	__m128i res = _mm_and_si128(_mm_cmpeq_epi32(idx, _mm_setzero_si128()),
+				    lut[0]);
+
+	for (int i = 1; i < 4; ++i) {
+		const __m128i mask = _mm_cmpeq_epi32(idx, _mm_set1_epi32(i));
+		res = _mm_or_si128(res, _mm_and_si128(mask, lut[i]));
+	}
+	return res;
+}
+
+/// Selects the 16-bit palette entry of each index, as `luma_sse2` does.
+SSE2 static __m128i select_epi16_sse2(const __m128i idx, const __m128i lut[4])
+{
+	__m128i res = _mm_and_si128(_mm_cmpeq_epi16(idx, _mm_setzero_si128()),
+				    lut[0]);
+
+	for (int i = 1; i < 4; ++i) {
+		const __m128i mask =
+			_mm_cmpeq_epi16(idx, _mm_set1_epi16((short)i));
+		res = _mm_or_si128(res, _mm_and_si128(mask, lut[i]));
+	}
+	return res;
+}
+
+SSE2 static void rgba8888_row_sse2(const uint8_t *const src,
+				   const uint32_t lut[4], uint32_t *const dst)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i mask = _mm_set1_epi8(3);
+	__m128i lut_v[4];
+
+	for (int i = 0; i < 4; ++i) {
+		lut_v[i] = _mm_set1_epi32((int)lut[i]);
+	}
+
+	for (size_t x = 0; x < AGOGE_CORE_FRAME_WIDTH; x += 16) {
+		const __m128i idx = _mm_and_si128(
+			_mm_loadu_si128((const __m128i *)(const void *)&src[x]),
+			mask);
+		const __m128i lo = _mm_unpacklo_epi8(idx, zero);
+		const __m128i hi = _mm_unpackhi_epi8(idx, zero);
+		const __m128i idx32[4] = { _mm_unpacklo_epi16(lo, zero),
+					   _mm_unpackhi_epi16(lo, zero),
+					   _mm_unpacklo_epi16(hi, zero),
+					   _mm_unpackhi_epi16(hi, zero) };
+
+		for (size_t j = 0; j < 4; ++j) {
+			_mm_storeu_si128((__m128i *)(void *)&dst[x + (j * 4)],
+					 select_epi32_sse2(idx32[j], lut_v));
+		}
+	}
+}
+
+SSE2 static void rgb565_row_sse2(const uint8_t *const src,
+				 const uint16_t lut[4], uint16_t *const dst)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i mask = _mm_set1_epi8(3);
+	__m128i lut_v[4];
+
+	for (int i = 0; i < 4; ++i) {
+		lut_v[i] = _mm_set1_epi16((short)lut[i]);
+	}
+
+	for (size_t x = 0; x < AGOGE_CORE_FRAME_WIDTH; x += 16) {
+		const __m128i idx = _mm_and_si128(
+			_mm_loadu_si128((const __m128i *)(const void *)&src[x]),
+			mask);
+
+		_mm_storeu_si128(
+			(__m128i *)(void *)&dst[x],
+			select_epi16_sse2(_mm_unpacklo_epi8(idx, zero), lut_v));
+		_mm_storeu_si128(
+			(__m128i *)(void *)&dst[x + 8],
+			select_epi16_sse2(_mm_unpackhi_epi8(idx, zero), lut_v));
+	}
+}
+
+AVX2 static __m256i luma_avx2(const __m256i idx, const __m256i lut)
+{
+	return _mm256_shuffle_epi8(lut, idx);
+}
+
+AVX2 static __m256i lut_load_avx2(const uint8_t lut[4])
+{
+	return _mm256_broadcastsi128_si256(_mm_setr_epi8(
+		(char)lut[0], (char)lut[1], (char)lut[2], (char)lut[3], 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0));
+}
+
+AVX2 static void luma_row_avx2(const uint8_t *const src, const uint8_t lut[4],
+			       uint8_t *const dst)
+{
+	const __m256i mask = _mm256_set1_epi8(3);
+	const __m256i lut_v = lut_load_avx2(lut);
+
+	for (size_t x = 0; x < AGOGE_CORE_FRAME_WIDTH; x += 32) {
+		const __m256i idx = _mm256_and_si256(
+			_mm256_loadu_si256(
+				(const __m256i *)(const void *)&src[x]),
+			mask);
+
+		_mm256_storeu_si256((__m256i *)(void *)&dst[x],
+				    luma_avx2(idx, lut_v));
+	}
+}
+
+AVX2 static void vsum_avx2(const uint8_t *const src,
+			   const unsigned int num_rows,
+			   const uint8_t *const weights, const uint8_t lut[4],
+			   uint16_t acc[AGOGE_CORE_FRAME_WIDTH])
+{
+	enum { NUM_VECS = AGOGE_CORE_FRAME_WIDTH / 16 };
+
+	const __m128i mask = _mm_set1_epi8(3);
+	const __m256i lut_v = lut_load_avx2(lut);
+
+	__m256i sum[NUM_VECS];
+
+	for (size_t i = 0; i < NUM_VECS; ++i) {
+		sum[i] = _mm256_setzero_si256();
+	}
+
+	for (unsigned int y = 0; y < num_rows; ++y) {
+		const uint8_t *const row = &src[y * AGOGE_CORE_FRAME_WIDTH];
+		const __m256i w = _mm256_set1_epi16((short)weights[y]);
+
+		for (size_t x = 0; x < AGOGE_CORE_FRAME_WIDTH; x += 16) {
+			const __m128i idx = _mm_and_si128(
+				_mm_loadu_si128(
+					(const __m128i *)(const void *)&row[x]),
+				mask);
+
+			// Widen the indices first, so that the lookup result
+			// is already in 16-bit lanes; setting bit 7 of the upper
+			// byte of each lane makes the shuffle zero it.
+			const __m256i luma = luma_avx2(
+				_mm256_or_si256(_mm256_cvtepu8_epi16(idx),
+						_mm256_set1_epi16((short)0x8000)),
+				lut_v);
+
+			sum[x / 16] = _mm256_add_epi16(
+				sum[x / 16], _mm256_mullo_epi16(luma, w));
+		}
+	}
+
+	for (size_t i = 0; i < NUM_VECS; ++i) {
+		_mm256_storeu_si256((__m256i *)(void *)&acc[i * 16], sum[i]);
+	}
+}
+
+AVX2 static void rgba8888_row_avx2(const uint8_t *const src,
+				   const uint32_t lut[4], uint32_t *const dst)
+{
+	// The permutation only looks at the low three bits of each index, so
+	// the palette is repeated in both halves.
+	const __m256i lut_v = _mm256_setr_epi32(
+		(int)lut[0], (int)lut[1], (int)lut[2], (int)lut[3],
+		(int)lut[0], (int)lut[1], (int)lut[2], (int)lut[3]);
+	const __m256i mask = _mm256_set1_epi32(3);
+
+	for (size_t x = 0; x < AGOGE_CORE_FRAME_WIDTH; x += 8) {
+		const __m256i idx = _mm256_and_si256(
+			_mm256_cvtepu8_epi32(_mm_loadl_epi64(
+				(const __m128i *)(const void *)&src[x])),
+			mask);
+
+		_mm256_storeu_si256((__m256i *)(void *)&dst[x],
+				    _mm256_permutevar8x32_epi32(lut_v, idx));
+	}
+}
+
+AVX2 static void rgb565_row_avx2(const uint8_t *const src,
+				 const uint16_t lut[4], uint16_t *const dst)
+{
+	// Index `i` selects bytes `2i` and `2i + 1` of the palette.
+	const __m256i lut_v = _mm256_broadcastsi128_si256(_mm_setr_epi16(
+		(short)lut[0], (short)lut[1], (short)lut[2], (short)lut[3], 0,
+		0, 0, 0));
+	const __m128i mask = _mm_set1_epi8(3);
+
+	for (size_t x = 0; x < AGOGE_CORE_FRAME_WIDTH; x += 16) {
+		const __m256i idx = _mm256_cvtepu8_epi16(_mm_and_si128(
+			_mm_loadu_si128((const __m128i *)(const void *)&src[x]),
+			mask));
+		const __m256i idx2 = _mm256_add_epi16(idx, idx);
+		const __m256i ctl = _mm256_add_epi16(
+			_mm256_or_si256(idx2, _mm256_slli_epi16(idx2, 8)),
+			_mm256_set1_epi16(0x0100));
+
+		_mm256_storeu_si256((__m256i *)(void *)&dst[x],
+				    _mm256_shuffle_epi8(lut_v, ctl));
+	}
+}
+
+AVX2 static void pack_2bpp_avx2(const uint8_t *const src, uint8_t *const dst)
+{
+	// Restores the order of the 4-byte groups produced by the in-lane packs
+	// below.
+	const __m256i perm = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+	for (size_t i = 0; i < AGOGE_CORE_FRAME_SIZE; i += 128) {
+		__m256i v[4];
+
+		for (size_t j = 0; j < 4; ++j) {
+			__m256i px = _mm256_loadu_si256(
+				(const __m256i *)(const void *)&src[i +
+								    (j * 32)]);
+
+			px = _mm256_and_si256(px, _mm256_set1_epi8(3));
+			px = _mm256_or_si256(px, _mm256_srli_epi32(px, 6));
+			px = _mm256_or_si256(px, _mm256_srli_epi32(px, 12));
+
+			v[j] = _mm256_and_si256(px, _mm256_set1_epi32(0xFF));
+		}
+
+		const __m256i lo = _mm256_packs_epi32(v[0], v[1]);
+		const __m256i hi = _mm256_packs_epi32(v[2], v[3]);
+		const __m256i res = _mm256_permutevar8x32_epi32(
+			_mm256_packus_epi16(lo, hi), perm);
+
+		_mm256_storeu_si256((__m256i *)(void *)&dst[i / 4], res);
+	}
+}
+
+const struct frame_kernels agoge_core_frame_kernels_sse2 = {
+	.luma_row = &luma_row_sse2,
+	.vsum = &vsum_sse2,
+	.rgba8888_row = &rgba8888_row_sse2,
+	.rgb565_row = &rgb565_row_sse2,
+	.pack_2bpp = &pack_2bpp_sse2
+};
+
+const struct frame_kernels agoge_core_frame_kernels_avx2 = {
+	.luma_row = &luma_row_avx2,
+	.vsum = &vsum_avx2,
+	.rgba8888_row = &rgba8888_row_avx2,
+	.rgb565_row = &rgb565_row_avx2,
+	.pack_2bpp = &pack_2bpp_avx2
+};
+
+#endif // defined(__x86_64__) || defined(__i386__)
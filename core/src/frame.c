@@ -0,0 +1,281 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file frame.c Defines the portable frame post-processing kernels, and
+/// selects the fastest implementation supported by the host.
+
+#include <assert.h>
+#include <string.h>
+
+#include "comp.h"
+#include "frame.h"
+
+static void luma_row_scalar(const uint8_t *const src, const uint8_t lut[4],
+			    uint8_t *const dst)
+{
+	for (size_t x = 0; x < AGOGE_CORE_FRAME_WIDTH; ++x) {
+		dst[x] = lut[src[x] & 3];
+	}
+}
+
+static void vsum_scalar(const uint8_t *const src, const unsigned int num_rows,
+			const uint8_t *const weights, const uint8_t lut[4],
+			uint16_t acc[AGOGE_CORE_FRAME_WIDTH])
+{
+	memset(acc, 0, sizeof(uint16_t) * AGOGE_CORE_FRAME_WIDTH);
+
+	for (unsigned int y = 0; y < num_rows; ++y) {
+		const uint8_t *const row = &src[y * AGOGE_CORE_FRAME_WIDTH];
+
+		for (size_t x = 0; x < AGOGE_CORE_FRAME_WIDTH; ++x) {
+			acc[x] += weights[y] * lut[row[x] & 3];
+		}
+	}
+}
+
+static void pack_2bpp_scalar(const uint8_t *const src, uint8_t *const dst)
+{
+	for (size_t i = 0; i < AGOGE_CORE_FRAME_2BPP_SIZE; ++i) {
+		const uint8_t *const px = &src[i * 4];
+
+		dst[i] = (px[0] & 3) | ((px[1] & 3) << 2) | ((px[2] & 3) << 4) |
+			 ((px[3] & 3) << 6);
+	}
+}
+
+static void rgba8888_row_scalar(const uint8_t *const src,
+				const uint32_t lut[4], uint32_t *const dst)
+{
+	for (size_t x = 0; x < AGOGE_CORE_FRAME_WIDTH; ++x) {
+		dst[x] = lut[src[x] & 3];
+	}
+}
+
+static void rgb565_row_scalar(const uint8_t *const src, const uint16_t lut[4],
+			      uint16_t *const dst)
+{
+	for (size_t x = 0; x < AGOGE_CORE_FRAME_WIDTH; ++x) {
+		dst[x] = lut[src[x] & 3];
+	}
+}
+
+const struct frame_kernels agoge_core_frame_kernels_scalar = {
+	.luma_row = &luma_row_scalar,
+	.vsum = &vsum_scalar,
+	.rgba8888_row = &rgba8888_row_scalar,
+	.rgb565_row = &rgb565_row_scalar,
+	.pack_2bpp = &pack_2bpp_scalar
+};
+
+const struct frame_kernels *agoge_core_frame_kernels_get(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx2")) {
+		return &agoge_core_frame_kernels_avx2;
+	}
+
+	if (__builtin_cpu_supports("sse2")) {
+		return &agoge_core_frame_kernels_sse2;
+	}
+#endif // defined(__x86_64__) || defined(__i386__)
+
+	return &agoge_core_frame_kernels_scalar;
+}
+
+/// Computes the area weights of source samples covering a destination
+/// sample.
+///
+/// Destination sample `dst_idx` covers source samples in a coordinate space
+/// where every source sample is `dst_len` units long and every destination
+/// sample is `src_len` units long, so the weights always sum to `src_len`.
+///
+/// @returns The number of weights, starting at the returned source index.
+static unsigned int area_weights(const unsigned int src_len,
+				 const unsigned int dst_len,
+				 const unsigned int dst_idx,
+				 unsigned int *const src_begin,
+				 uint8_t *const weights)
+{
+	const unsigned int beg = dst_idx * src_len;
+	const unsigned int end = beg + src_len;
+
+	unsigned int num = 0;
+	*src_begin = beg / dst_len;
+
+	for (unsigned int s = *src_begin; (s * dst_len) < end; ++s) {
+		const unsigned int s_beg = s * dst_len;
+		const unsigned int s_end = s_beg + dst_len;
+
+		const unsigned int lo = (s_beg > beg) ? s_beg : beg;
+		const unsigned int hi = (s_end < end) ? s_end : end;
+
+		weights[num++] = (uint8_t)(hi - lo);
+	}
+	return num;
+}
+
+void agoge_core_frame_luma(const uint8_t *const src, const uint8_t lut[4],
+			   uint8_t *const dst, const size_t dst_stride)
+{
+	const struct frame_kernels *const kernels =
+		agoge_core_frame_kernels_get();
+
+	for (size_t y = 0; y < AGOGE_CORE_FRAME_HEIGHT; ++y) {
+		kernels->luma_row(&src[y * AGOGE_CORE_FRAME_WIDTH], lut,
+				  &dst[y * dst_stride]);
+	}
+}
+
+void agoge_core_frame_downsample(const uint8_t *const src, const uint8_t lut[4],
+				 uint8_t *const dst,
+				 const unsigned int dst_width,
+				 const unsigned int dst_height,
+				 const size_t dst_stride)
+{
+	assert((dst_width > 0) && (dst_width <= AGOGE_CORE_FRAME_WIDTH));
+	assert((dst_height > 0) && (dst_height <= AGOGE_CORE_FRAME_HEIGHT));
+
+	// The weights of a destination pixel sum to the source frame size.
+	enum { DIVISOR = AGOGE_CORE_FRAME_WIDTH * AGOGE_CORE_FRAME_HEIGHT };
+
+	const struct frame_kernels *const kernels =
+		agoge_core_frame_kernels_get();
+
+	// The weights of each column are the same for every row, so compute
+	// them once. Adjacent columns share at most one source column, so there
+	// are never more weights than source and destination columns combined.
+	unsigned int col_begin[AGOGE_CORE_FRAME_WIDTH];
+	unsigned int col_taps[AGOGE_CORE_FRAME_WIDTH];
+	uint8_t col_weights[AGOGE_CORE_FRAME_WIDTH * 2];
+
+	for (unsigned int x = 0, pos = 0; x < dst_width; ++x) {
+		col_taps[x] = area_weights(AGOGE_CORE_FRAME_WIDTH, dst_width, x,
+					   &col_begin[x], &col_weights[pos]);
+		pos += col_taps[x];
+	}
+
+	uint16_t acc[AGOGE_CORE_FRAME_WIDTH];
+	uint8_t row_weights[AGOGE_CORE_FRAME_HEIGHT];
+
+	for (unsigned int y = 0; y < dst_height; ++y) {
+		unsigned int row_begin;
+		const unsigned int row_taps =
+			area_weights(AGOGE_CORE_FRAME_HEIGHT, dst_height, y,
+				     &row_begin, row_weights);
+
+		kernels->vsum(&src[row_begin * AGOGE_CORE_FRAME_WIDTH],
+			      row_taps, row_weights, lut, acc);
+
+		uint8_t *const dst_row = &dst[y * dst_stride];
+		const uint8_t *weights = col_weights;
+
+		for (unsigned int x = 0; x < dst_width; ++x) {
+			const uint16_t *const taps = &acc[col_begin[x]];
+			uint32_t sum = 0;
+
+			for (unsigned int i = 0; i < col_taps[x]; ++i) {
+				sum += (uint32_t)weights[i] * taps[i];
+			}
+
+			weights += col_taps[x];
+			dst_row[x] = (uint8_t)((sum + (DIVISOR / 2)) / DIVISOR);
+		}
+	}
+}
+
+void agoge_core_frame_rgba8888(const uint8_t *const src, const uint32_t lut[4],
+			       void *const dst, const size_t dst_stride)
+{
+	assert((dst_stride % sizeof(uint32_t)) == 0);
+
+	const struct frame_kernels *const kernels =
+		agoge_core_frame_kernels_get();
+
+	for (size_t y = 0; y < AGOGE_CORE_FRAME_HEIGHT; ++y) {
+		kernels->rgba8888_row(&src[y * AGOGE_CORE_FRAME_WIDTH], lut,
+				      (uint32_t *)(void *)((uint8_t *)dst +
+							   (y * dst_stride)));
+	}
+}
+
+void agoge_core_frame_rgb565(const uint8_t *const src, const uint16_t lut[4],
+			     void *const dst, const size_t dst_stride)
+{
+	assert((dst_stride % sizeof(uint16_t)) == 0);
+
+	const struct frame_kernels *const kernels =
+		agoge_core_frame_kernels_get();
+
+	for (size_t y = 0; y < AGOGE_CORE_FRAME_HEIGHT; ++y) {
+		kernels->rgb565_row(&src[y * AGOGE_CORE_FRAME_WIDTH], lut,
+				    (uint16_t *)(void *)((uint8_t *)dst +
+							 (y * dst_stride)));
+	}
+}
+
+void agoge_core_frame_pack_2bpp(const uint8_t *const src, uint8_t *const dst)
+{
+	agoge_core_frame_kernels_get()->pack_2bpp(src, dst);
+}
+
+PURE uint64_t agoge_core_frame_line_hash(const uint8_t *const line)
+{
+	uint64_t hash = UINT64_C(0x9E3779B97F4A7C15);
+
+	for (size_t i = 0; i < AGOGE_CORE_FRAME_WIDTH; i += sizeof(uint64_t)) {
+		uint64_t word;
+
+		memcpy(&word, &line[i], sizeof(word));
+		hash = (hash ^ word) * UINT64_C(0xFF51AFD7ED558CCD);
+		hash ^= hash >> 32;
+	}
+	return hash;
+}
+
+CONST uint64_t agoge_core_frame_hash_add(uint64_t hash,
+					 const uint64_t line_hash)
+{
+	hash = (hash ^ line_hash) * UINT64_C(0xC4CEB9FE1A85EC53);
+	return hash ^ (hash >> 29);
+}
+
+PURE uint64_t agoge_core_frame_hash(const uint8_t *const src)
+{
+	uint64_t hash = FRAME_HASH_SEED;
+
+	for (size_t y = 0; y < AGOGE_CORE_FRAME_HEIGHT; ++y) {
+		hash = agoge_core_frame_hash_add(
+			hash, agoge_core_frame_line_hash(
+				      &src[y * AGOGE_CORE_FRAME_WIDTH]));
+	}
+	return hash;
+}
+
+void agoge_core_frame_stack_push(uint8_t *const stack, const size_t obs_size,
+				 const unsigned int depth,
+				 const uint8_t *const obs)
+{
+	assert(depth > 0);
+
+	memmove(stack, &stack[obs_size], obs_size * (depth - 1));
+	memcpy(&stack[obs_size * (depth - 1)], obs, obs_size);
+}
@@ -0,0 +1,69 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "agoge/frame.h"
+
+/// Defines a set of frame kernels implemented for a given instruction set.
+struct frame_kernels {
+	/// Converts `AGOGE_CORE_FRAME_WIDTH` palette indices to luma.
+	void (*luma_row)(const uint8_t *src, const uint8_t lut[4],
+			 uint8_t *dst);
+
+	/// Accumulates `num_rows` consecutive rows of luma, each multiplied by
+	/// its weight, into `acc`.
+	void (*vsum)(const uint8_t *src, unsigned int num_rows,
+		     const uint8_t *weights, const uint8_t lut[4],
+		     uint16_t acc[AGOGE_CORE_FRAME_WIDTH]);
+
+	/// Converts `AGOGE_CORE_FRAME_WIDTH` palette indices to 32-bit pixels.
+	void (*rgba8888_row)(const uint8_t *src, const uint32_t lut[4],
+			     uint32_t *dst);
+
+	/// Converts `AGOGE_CORE_FRAME_WIDTH` palette indices to 16-bit pixels.
+	void (*rgb565_row)(const uint8_t *src, const uint16_t lut[4],
+			   uint16_t *dst);
+
+	/// Packs a whole frame to 2 bits per pixel.
+	void (*pack_2bpp)(const uint8_t *src, uint8_t *dst);
+};
+
+extern const struct frame_kernels agoge_core_frame_kernels_scalar;
+
+#if defined(__x86_64__) || defined(__i386__)
+extern const struct frame_kernels agoge_core_frame_kernels_sse2;
+extern const struct frame_kernels agoge_core_frame_kernels_avx2;
+#endif // defined(__x86_64__) || defined(__i386__)
+
+/// The hash of a frame before its first line is added.
+#define FRAME_HASH_SEED (UINT64_C(0x243F6A8885A308D3))
+
+/// Hashes a line of `AGOGE_CORE_FRAME_WIDTH` palette indices.
+uint64_t agoge_core_frame_line_hash(const uint8_t *line);
+
+/// Adds the hash of the next line to the hash of a frame.
+uint64_t agoge_core_frame_hash_add(uint64_t hash, uint64_t line_hash);
+
+/// Retrieves the fastest frame kernels supported by the host.
+const struct frame_kernels *agoge_core_frame_kernels_get(void);
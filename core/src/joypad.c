@@ -0,0 +1,58 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file joypad.c Defines the implementation of the joypad.
+
+#include "joypad.h"
+#include "comp.h"
+#include "defs.h"
+
+// A group is selected by clearing its bit in P1.
+#define P1_SEL_DIRECTION (BIT_4)
+#define P1_SEL_ACTION (BIT_5)
+#define P1_SEL_MASK (P1_SEL_DIRECTION | P1_SEL_ACTION)
+
+void agoge_core_joypad_set(struct agoge_core_ctx *const ctx,
+			   const uint8_t buttons)
+{
+	ctx->joypad.buttons = buttons;
+}
+
+PURE uint8_t agoge_core_joypad_read(struct agoge_core_ctx *const ctx)
+{
+	uint8_t pressed = 0x00;
+
+	if (!(ctx->joypad.sel & P1_SEL_DIRECTION)) {
+		pressed |= ctx->joypad.buttons & 0x0F;
+	}
+
+	if (!(ctx->joypad.sel & P1_SEL_ACTION)) {
+		pressed |= ctx->joypad.buttons >> 4;
+	}
+
+	// Unused bits read back as set, and pressed buttons read as cleared.
+	return 0xC0 | ctx->joypad.sel | (~pressed & 0x0F);
+}
+
+void agoge_core_joypad_write(struct agoge_core_ctx *const ctx,
+			     const uint8_t data)
+{
+	ctx->joypad.sel = data & P1_SEL_MASK;
+}
@@ -20,7 +20,7 @@
 
 #pragma once
 
-#include "agoge/ctx.h"
+#include "ctx.h"
 
 void agoge_core_log_handle(struct agoge_core_ctx *ctx,
 			   enum agoge_core_log_lvl lvl,
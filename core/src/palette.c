@@ -0,0 +1,250 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file palette.c Defines the implementation of the CGB palette RAM.
+
+#include <stdatomic.h>
+#include <string.h>
+
+#include "comp.h"
+#include "defs.h"
+#include "palette.h"
+
+/// The number of BGR555 colors.
+#define NUM_COLORS (32768)
+
+/// The address of the CGB flag in the cartridge header.
+#define CART_CGB_FLAG (0x0143)
+
+/// Defines the states of the conversion tables.
+enum lut_state { LUT_STATE_NONE, LUT_STATE_BUSY, LUT_STATE_READY };
+
+/// The host pixel of every BGR555 color; uncorrected, and corrected for the
+/// CGB LCD.
+static uint32_t luts[2][NUM_COLORS];
+static atomic_int luts_state = LUT_STATE_NONE;
+
+static uint32_t pixel(const unsigned int r, const unsigned int g,
+		      const unsigned int b)
+{
+	const uint8_t px[4] = { (uint8_t)r, (uint8_t)g, (uint8_t)b, 0xFF };
+	uint32_t ret;
+
+	memcpy(&ret, px, sizeof(ret));
+	return ret;
+}
+
+static unsigned int min_u(const unsigned int a, const unsigned int b)
+{
+	return (a < b) ? a : b;
+}
+
+static void luts_fill(void)
+{
+	for (unsigned int c = 0; c < NUM_COLORS; ++c) {
+		const unsigned int r = c & 0x1F;
+		const unsigned int g = (c >> 5) & 0x1F;
+		const unsigned int b = (c >> 10) & 0x1F;
+
+		luts[0][c] = pixel((r << 3) | (r >> 2), (g << 3) | (g >> 2),
+				   (b << 3) | (b >> 2));
+
+		// The LCD bleeds the channels into each other and never gets
+		// fully saturated.
+		luts[1][c] =
+			pixel(min_u(960, (r * 26) + (g * 4) + (b * 2)) >> 2,
+			      min_u(960, (g * 24) + (b * 8)) >> 2,
+			      min_u(960, (r * 6) + (g * 4) + (b * 22)) >> 2);
+	}
+}
+
+/// Fills the conversion tables on first use. Contexts may be created on any
+/// thread, so the first caller fills them while any other waits.
+static void luts_init(void)
+{
+	if (likely(atomic_load_explicit(&luts_state, memory_order_acquire) ==
+		   LUT_STATE_READY)) {
+		return;
+	}
+
+	int expected = LUT_STATE_NONE;
+
+	if (atomic_compare_exchange_strong(&luts_state, &expected,
+					   LUT_STATE_BUSY)) {
+		luts_fill();
+		atomic_store_explicit(&luts_state, LUT_STATE_READY,
+				      memory_order_release);
+		return;
+	}
+
+	while (atomic_load_explicit(&luts_state, memory_order_acquire) !=
+	       LUT_STATE_READY) {
+	}
+}
+
+static bool cgb(const struct agoge_core_ctx *const ctx)
+{
+	return (ctx->bus.cart.data != NULL) &&
+	       (ctx->bus.cart.data[CART_CGB_FLAG] & BIT_7);
+}
+
+/// Converts the color holding a byte of palette RAM.
+static void color_update(const struct agoge_core_palette *const pal,
+			 const uint8_t *const ram, uint32_t *const colors,
+			 const unsigned int idx)
+{
+	const unsigned int color = idx / 2;
+	const unsigned int bgr555 =
+		(ram[color * 2] | (ram[(color * 2) + 1] << 8)) & 0x7FFF;
+
+	colors[color] = luts[pal->correct][bgr555];
+}
+
+/// Stores a byte of palette RAM through BCPD or OCPD.
+static void data_store(struct agoge_core_palette *const pal,
+		       const uint16_t addr, const uint8_t data)
+{
+	luts_init();
+
+	if (addr == 0xFF69) {
+		const unsigned int idx = pal->bcps & 0x3F;
+
+		pal->bg_ram[idx] = data;
+		color_update(pal, pal->bg_ram, &pal->bg[0][0], idx);
+	} else {
+		const unsigned int idx = pal->ocps & 0x3F;
+
+		pal->obj_ram[idx] = data;
+		color_update(pal, pal->obj_ram, &pal->obj[0][0], idx);
+	}
+}
+
+static uint8_t index_next(const uint8_t spec)
+{
+	if (!(spec & BIT_7)) {
+		return spec;
+	}
+	return (uint8_t)(BIT_7 | ((spec + 1) & 0x3F));
+}
+
+void agoge_core_palette_reset(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_palette *const pal = &ctx->bus.palette;
+
+	pal->bcps = 0;
+	pal->ocps = 0;
+
+	// White.
+	memset(pal->bg_ram, 0xFF, sizeof(pal->bg_ram));
+	memset(pal->obj_ram, 0xFF, sizeof(pal->obj_ram));
+
+	agoge_core_palette_refresh(ctx);
+}
+
+PURE uint8_t agoge_core_palette_read(const struct agoge_core_ctx *const ctx,
+				     const uint16_t addr)
+{
+	const struct agoge_core_palette *const pal = &ctx->bus.palette;
+
+	if (!cgb(ctx)) {
+		return 0xFF;
+	}
+
+	switch (addr) {
+	case 0xFF68:
+		return pal->bcps | BIT_6;
+
+	case 0xFF69:
+		return pal->bg_ram[pal->bcps & 0x3F];
+
+	case 0xFF6A:
+		return pal->ocps | BIT_6;
+
+	case 0xFF6B:
+	default:
+		return pal->obj_ram[pal->ocps & 0x3F];
+	}
+}
+
+void agoge_core_palette_write(struct agoge_core_ctx *const ctx,
+			      const uint16_t addr, const uint8_t data)
+{
+	struct agoge_core_palette *const pal = &ctx->bus.palette;
+
+	if (!cgb(ctx)) {
+		return;
+	}
+
+	agoge_core_palette_poke(ctx, addr, data);
+
+	switch (addr) {
+	case 0xFF69:
+		pal->bcps = index_next(pal->bcps);
+		return;
+
+	case 0xFF6B:
+		pal->ocps = index_next(pal->ocps);
+		return;
+
+	default:
+		return;
+	}
+}
+
+void agoge_core_palette_poke(struct agoge_core_ctx *const ctx,
+			     const uint16_t addr, const uint8_t data)
+{
+	struct agoge_core_palette *const pal = &ctx->bus.palette;
+
+	switch (addr) {
+	case 0xFF68:
+		pal->bcps = data & (BIT_7 | 0x3F);
+		return;
+
+	case 0xFF6A:
+		pal->ocps = data & (BIT_7 | 0x3F);
+		return;
+
+	case 0xFF69:
+	case 0xFF6B:
+	default:
+		data_store(pal, addr, data);
+		return;
+	}
+}
+
+void agoge_core_palette_refresh(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_palette *const pal = &ctx->bus.palette;
+
+	luts_init();
+
+	for (unsigned int i = 0; i < AGOGE_CORE_PALETTE_RAM_SIZE; i += 2) {
+		color_update(pal, pal->bg_ram, &pal->bg[0][0], i);
+		color_update(pal, pal->obj_ram, &pal->obj[0][0], i);
+	}
+}
+
+void agoge_core_palette_correction_set(struct agoge_core_ctx *const ctx,
+				       const bool correct)
+{
+	ctx->bus.palette.correct = correct;
+	agoge_core_palette_refresh(ctx);
+}
@@ -0,0 +1,46 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file palette.h Defines the internal interface of the CGB palette RAM.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "ctx.h"
+
+/// Resets the palette RAM to white, keeping the color correction setting.
+void agoge_core_palette_reset(struct agoge_core_ctx *ctx);
+
+/// Reads a palette register ($FF68-$FF6B) without side effects.
+uint8_t agoge_core_palette_read(const struct agoge_core_ctx *ctx,
+				uint16_t addr);
+
+/// Writes a palette register ($FF68-$FF6B).
+void agoge_core_palette_write(struct agoge_core_ctx *ctx, uint16_t addr,
+			      uint8_t data);
+
+/// Writes a palette register ($FF68-$FF6B) without side effects, i.e.,
+/// without incrementing BCPS or OCPS.
+void agoge_core_palette_poke(struct agoge_core_ctx *ctx, uint16_t addr,
+			     uint8_t data);
+
+/// Converts every color again, e.g., after loading a state.
+void agoge_core_palette_refresh(struct agoge_core_ctx *ctx);
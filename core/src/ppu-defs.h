@@ -0,0 +1,65 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "agoge/ppu.h"
+#include "defs.h"
+
+#define LCDC_BG_ENABLE (BIT_0)
+#define LCDC_OBJ_ENABLE (BIT_1)
+#define LCDC_OBJ_SIZE (BIT_2)
+#define LCDC_BG_MAP (BIT_3)
+#define LCDC_TILE_DATA (BIT_4)
+#define LCDC_WIN_ENABLE (BIT_5)
+#define LCDC_WIN_MAP (BIT_6)
+#define LCDC_LCD_ENABLE (BIT_7)
+
+#define STAT_LYC_EQ (BIT_2)
+#define STAT_INT_HBLANK (BIT_3)
+#define STAT_INT_VBLANK (BIT_4)
+#define STAT_INT_OAM (BIT_5)
+#define STAT_INT_LYC (BIT_6)
+#define STAT_WRITABLE (0x78)
+
+#define OBJ_ATTR_PALETTE (BIT_4)
+#define OBJ_ATTR_X_FLIP (BIT_5)
+#define OBJ_ATTR_Y_FLIP (BIT_6)
+#define OBJ_ATTR_BEHIND_BG (BIT_7)
+
+#define MODE_OAM_CYCLES (80)
+#define MODE_DRAW_CYCLES (172)
+#define MODE_HBLANK_CYCLES (204)
+#define LINE_CYCLES (456)
+
+#define NUM_LINES (154)
+#define OBJS_PER_LINE_MAX (AGOGE_CORE_PPU_LINE_OBJS_MAX)
+#define NUM_OBJS (40)
+
+/// The number of tiles in a row of a tile map.
+#define MAP_WIDTH (32)
+
+/// The offsets of the tile maps within VRAM.
+#define MAP_LO (0x1800)
+#define MAP_HI (0x1C00)
+
+#define TILE_BYTES (16)
+#define TILE_SIZE (AGOGE_CORE_PPU_TILE_SIZE)
+#define WIDTH (AGOGE_CORE_FRAME_WIDTH)
@@ -0,0 +1,363 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file ppu-fifo.c Defines the accurate backend of the PPU.
+///
+/// Mode 3 is run one dot at a time. The background fetcher spends six dots on
+/// a tile and pushes its eight pixels once the background FIFO is empty, and
+/// a pixel leaves the FIFO on every dot. The first fetch of a line is
+/// delayed by six dots and the fine horizontal scroll is discarded from the
+/// FIFO, so that a line without sprites or window lasts 172 dots plus
+/// SCX mod 8. A sprite stalls the output for 6 to 11 dots, as its fetch waits
+/// for the current background fetch; starting the window restarts the
+/// fetcher.
+///
+/// Rendering runs lazily: mode 3 events are scheduled at the earliest dot at
+/// which the line can be complete, and every write to a PPU register, VRAM or
+/// OAM first runs the FIFOs up to the current cycle.
+
+#include <string.h>
+
+#include "ppu-defs.h"
+#include "ppu.h"
+
+/// The number of dots the fetcher spends on a tile.
+#define FETCH_DOTS (6)
+
+/// The number of dots of a sprite fetch, after the background fetch.
+#define OBJ_FETCH_DOTS (6)
+
+/// The number of dots before the first fetch of a line.
+#define START_DELAY (6)
+
+/// The bits of sprite attributes kept in the sprite FIFO.
+#define OBJ_FIFO_ATTRS (OBJ_ATTR_PALETTE | OBJ_ATTR_BEHIND_BG)
+
+/// Fetches the next tile row of the background or window.
+static void tile_fetch(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+	struct agoge_core_ppu_fifo *const fifo = &ppu->fifo;
+
+	// The pixels do not affect timing.
+	if (ppu->skip) {
+		return;
+	}
+
+	unsigned int map;
+	unsigned int col;
+	unsigned int y;
+
+	if (fifo->window) {
+		map = (ppu->lcdc & LCDC_WIN_MAP) ? MAP_HI : MAP_LO;
+		col = fifo->fetch_x;
+		y = ppu->window_line;
+	} else {
+		map = (ppu->lcdc & LCDC_BG_MAP) ? MAP_HI : MAP_LO;
+		col = (ppu->scx / TILE_SIZE) + fifo->fetch_x;
+		y = (ppu->ly + ppu->scy) & UINT8_MAX;
+	}
+
+	const uint8_t num =
+		ctx->bus.vram[map + ((y / TILE_SIZE) * MAP_WIDTH) +
+			      (col % MAP_WIDTH)];
+	const uint8_t *const tile = agoge_core_ppu_tile_get(
+		ctx, agoge_core_ppu_tile_idx(ppu->lcdc, num));
+
+	memcpy(fifo->row, &tile[(y % TILE_SIZE) * TILE_SIZE], TILE_SIZE);
+}
+
+/// Runs the background fetcher for a dot; it does not push while a sprite is
+/// waiting.
+static void fetcher_dot(struct agoge_core_ctx *const ctx, const bool push)
+{
+	struct agoge_core_ppu_fifo *const fifo = &ctx->ppu.fifo;
+
+	if (fifo->step < FETCH_DOTS) {
+		if (fifo->step == 0) {
+			tile_fetch(ctx);
+		}
+		fifo->step++;
+		return;
+	}
+
+	if (push && (fifo->bg_len == 0)) {
+		memcpy(fifo->bg, fifo->row, TILE_SIZE);
+		fifo->bg_pos = 0;
+		fifo->bg_len = TILE_SIZE;
+		fifo->step = 0;
+		fifo->fetch_x++;
+	}
+}
+
+/// Finds the next sprite to fetch at the current X, if any.
+///
+/// @returns Whether a sprite was found; its entry is stored in `obj_cur`.
+static bool obj_find(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_ppu_fifo *const fifo = &ctx->ppu.fifo;
+	unsigned int best = OBJS_PER_LINE_MAX;
+
+	// The sprite with the smallest X is fetched first, then the first one
+	// in OAM.
+	for (unsigned int i = 0; i < fifo->num_objs; ++i) {
+		const uint8_t x = ctx->bus.oam[(fifo->objs[i] * 4) + 1];
+
+		if ((fifo->objs_done & (1U << i)) ||
+		    (x > (fifo->lx + TILE_SIZE))) {
+			continue;
+		}
+
+		if ((best == OBJS_PER_LINE_MAX) ||
+		    (x < ctx->bus.oam[(fifo->objs[best] * 4) + 1])) {
+			best = i;
+		}
+	}
+
+	if (best == OBJS_PER_LINE_MAX) {
+		return false;
+	}
+	fifo->obj_cur = (uint8_t)best;
+	return true;
+}
+
+/// Starts the fetch of the sprite in `obj_cur` once the background fetcher
+/// finished its tile; the current dot is the first of the fetch.
+static void obj_wait(struct agoge_core_ppu_fifo *const fifo)
+{
+	fifo->obj_pending = fifo->step < FETCH_DOTS;
+
+	if (!fifo->obj_pending) {
+		fifo->obj_dots = OBJ_FETCH_DOTS - 1;
+	}
+}
+
+/// Merges the fetched sprite into the sprite FIFO. Opaque pixels already in
+/// the FIFO belong to sprites of higher priority and are kept.
+static void obj_merge(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_ppu_fifo *const fifo = &ctx->ppu.fifo;
+	const uint8_t *const obj = &ctx->bus.oam[fifo->objs[fifo->obj_cur] * 4];
+
+	fifo->objs_done |= (uint16_t)(1U << fifo->obj_cur);
+
+	if (ctx->ppu.skip) {
+		return;
+	}
+
+	const uint8_t *const pixels = agoge_core_ppu_obj_row(ctx, obj);
+
+	for (unsigned int px = 0; px < TILE_SIZE; ++px) {
+		const int x = obj[1] - 8 + (int)px;
+
+		// Pixels left of the current X were already output.
+		if ((x < fifo->lx) || (x >= WIDTH)) {
+			continue;
+		}
+
+		const uint8_t color =
+			pixels[(obj[3] & OBJ_ATTR_X_FLIP) ? (7 - px) : px];
+		uint8_t *const slot = &fifo->obj[x % TILE_SIZE];
+
+		if ((color != 0) && (*slot == 0)) {
+			*slot = color | (obj[3] & OBJ_FIFO_ATTRS);
+		}
+	}
+}
+
+/// Starts the window if it begins at the current X.
+///
+/// @returns Whether the window started.
+static bool window_check(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+	struct agoge_core_ppu_fifo *const fifo = &ppu->fifo;
+
+	if (fifo->window || (fifo->discard != 0) ||
+	    ((ppu->lcdc & (LCDC_BG_ENABLE | LCDC_WIN_ENABLE)) !=
+	     (LCDC_BG_ENABLE | LCDC_WIN_ENABLE)) ||
+	    (ppu->ly < ppu->wy) || (ppu->wx >= (WIDTH + 7)) ||
+	    ((fifo->lx + 7) < ppu->wx)) {
+		return false;
+	}
+
+	fifo->window = true;
+	fifo->bg_len = 0;
+	fifo->step = 0;
+	fifo->fetch_x = 0;
+
+	// The window starts at WX - 7, which may be left of the screen.
+	if (ppu->wx < 7) {
+		fifo->discard = (uint8_t)(7 - ppu->wx);
+	}
+	return true;
+}
+
+/// Outputs the pixel at the head of the FIFOs.
+static void pixel_output(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+	struct agoge_core_ppu_fifo *const fifo = &ppu->fifo;
+
+	if (ppu->skip) {
+		fifo->bg_pos++;
+		fifo->bg_len--;
+		fifo->lx++;
+
+		return;
+	}
+
+	const uint8_t bg = (ppu->lcdc & LCDC_BG_ENABLE) ?
+				   fifo->bg[fifo->bg_pos] :
+				   0;
+	uint8_t *const slot = &fifo->obj[fifo->lx % TILE_SIZE];
+	const uint8_t obj = *slot;
+	const uint8_t color = obj & 3;
+
+	fifo->bg_pos++;
+	fifo->bg_len--;
+	*slot = 0;
+
+	uint8_t shade = (ppu->bgp >> (bg * 2)) & 3;
+
+	if ((color != 0) && (ppu->lcdc & LCDC_OBJ_ENABLE) &&
+	    (!(obj & OBJ_ATTR_BEHIND_BG) || (bg == 0))) {
+		const uint8_t pal =
+			(obj & OBJ_ATTR_PALETTE) ? ppu->obp1 : ppu->obp0;
+		shade = (pal >> (color * 2)) & 3;
+	}
+	ppu->frame[(ppu->ly * WIDTH) + fifo->lx++] = shade;
+
+	if (fifo->lx == WIDTH) {
+		agoge_core_ppu_line_end(ctx);
+	}
+}
+
+/// Runs the FIFOs for a dot.
+static void fifo_dot(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+	struct agoge_core_ppu_fifo *const fifo = &ppu->fifo;
+
+	if (fifo->delay != 0) {
+		fifo->delay--;
+		return;
+	}
+
+	if (fifo->obj_dots != 0) {
+		if (--fifo->obj_dots == 0) {
+			obj_merge(ctx);
+		}
+		return;
+	}
+
+	if (fifo->obj_pending) {
+		fetcher_dot(ctx, false);
+		obj_wait(fifo);
+
+		return;
+	}
+
+	fetcher_dot(ctx, true);
+
+	if (window_check(ctx) || (fifo->bg_len == 0)) {
+		return;
+	}
+
+	if (fifo->discard != 0) {
+		fifo->bg_pos++;
+		fifo->bg_len--;
+		fifo->discard--;
+		return;
+	}
+
+	if ((ppu->lcdc & LCDC_OBJ_ENABLE) && obj_find(ctx)) {
+		obj_wait(fifo);
+		return;
+	}
+	pixel_output(ctx);
+}
+
+/// Runs the FIFOs up to, but not including, the dot at `end`.
+///
+/// @returns Whether the line is complete.
+static bool fifo_run(struct agoge_core_ctx *const ctx, const uint64_t end)
+{
+	struct agoge_core_ppu_fifo *const fifo = &ctx->ppu.fifo;
+
+	while ((fifo->lx < WIDTH) && (fifo->cycle < end)) {
+		fifo_dot(ctx);
+		fifo->cycle++;
+	}
+	return fifo->lx == WIDTH;
+}
+
+static void draw_begin_accurate(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+	struct agoge_core_ppu_fifo *const fifo = &ppu->fifo;
+
+	memset(fifo, 0, sizeof(*fifo));
+
+	fifo->cycle = ppu->next_event;
+	fifo->draw_start = ppu->next_event;
+	fifo->delay = START_DELAY;
+	fifo->discard = ppu->scx % TILE_SIZE;
+	fifo->num_objs = (uint8_t)agoge_core_ppu_oam_scan(ctx, fifo->objs);
+
+	ppu->next_event += MODE_DRAW_CYCLES;
+}
+
+static bool draw_event_accurate(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+	struct agoge_core_ppu_fifo *const fifo = &ppu->fifo;
+
+	if (!fifo_run(ctx, ppu->next_event)) {
+		// Every remaining pixel takes at least a dot.
+		ppu->next_event += (WIDTH - fifo->lx) + fifo->discard;
+		return false;
+	}
+
+	if (fifo->window) {
+		ppu->window_line++;
+	}
+	ppu->next_event =
+		fifo->draw_start + MODE_DRAW_CYCLES + MODE_HBLANK_CYCLES;
+
+	return true;
+}
+
+static void sync_accurate(struct agoge_core_ctx *const ctx)
+{
+	agoge_core_ppu_update(ctx);
+
+	// Mode 3 cannot end before its next event, so this never completes the
+	// line.
+	if (ctx->ppu.mode == AGOGE_CORE_PPU_MODE_DRAW) {
+		fifo_run(ctx, ctx->cpu.cycles);
+	}
+}
+
+const struct ppu_backend agoge_core_ppu_backend_accurate = {
+	.draw_begin = &draw_begin_accurate,
+	.draw_event = &draw_event_accurate,
+	.sync = &sync_accurate
+};
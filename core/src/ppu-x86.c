@@ -0,0 +1,133 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file ppu-x86.c Defines the SSE2 and AVX2 PPU kernels.
+///
+/// A tile row is two bitplanes; pixel `x` is bit `7 - x` of each. Each plane
+/// byte is broadcast across the eight bytes of its row, and a per-byte mask
+/// selects the bit of each pixel, which a comparison turns into 0 or 1.
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#include "ppu.h"
+
+#define SSE2 __attribute__((target("sse2")))
+#define AVX2 __attribute__((target("avx2")))
+
+/// Decodes two rows whose plane bytes are broadcast into `lo` and `hi`.
+SSE2 static __m128i rows_decode_sse2(const __m128i lo, const __m128i hi)
+{
+	const __m128i bits = _mm_set1_epi64x((long long)0x0102040810204080);
+
+	const __m128i lo_set = _mm_cmpeq_epi8(_mm_and_si128(lo, bits), bits);
+	const __m128i hi_set = _mm_cmpeq_epi8(_mm_and_si128(hi, bits), bits);
+
+	return _mm_or_si128(_mm_and_si128(lo_set, _mm_set1_epi8(1)),
+			    _mm_and_si128(hi_set, _mm_set1_epi8(2)));
+}
+
+SSE2 static void tile_decode_sse2(const uint8_t *const src, uint8_t *const dst)
+{
+	const __m128i tile =
+		_mm_loadu_si128((const __m128i *)(const void *)src);
+	const __m128i low_bytes = _mm_set1_epi16(0xFF);
+
+	// Separate the planes: the eight low plane bytes, then the eight high
+	// plane bytes.
+	const __m128i planes =
+		_mm_packus_epi16(_mm_and_si128(tile, low_bytes),
+				 _mm_srli_epi16(tile, 8));
+
+	// Broadcast each byte to eight bytes, two rows per vector.
+	const __m128i x2 = _mm_unpacklo_epi8(planes, planes);
+	const __m128i y2 = _mm_unpackhi_epi8(planes, planes);
+	const __m128i lo4[2] = { _mm_unpacklo_epi16(x2, x2),
+				 _mm_unpackhi_epi16(x2, x2) };
+	const __m128i hi4[2] = { _mm_unpacklo_epi16(y2, y2),
+				 _mm_unpackhi_epi16(y2, y2) };
+
+	for (size_t i = 0; i < 2; ++i) {
+		_mm_storeu_si128(
+			(__m128i *)(void *)&dst[i * 32],
+			rows_decode_sse2(_mm_unpacklo_epi32(lo4[i], lo4[i]),
+					 _mm_unpacklo_epi32(hi4[i], hi4[i])));
+		_mm_storeu_si128(
+			(__m128i *)(void *)&dst[(i * 32) + 16],
+			rows_decode_sse2(_mm_unpackhi_epi32(lo4[i], lo4[i]),
+					 _mm_unpackhi_epi32(hi4[i], hi4[i])));
+	}
+}
+
+/// Decodes four rows whose plane bytes are broadcast into `lo` and `hi`.
+AVX2 static __m256i rows_decode_avx2(const __m256i lo, const __m256i hi)
+{
+	const __m256i bits = _mm256_set1_epi64x((long long)0x0102040810204080);
+
+	const __m256i lo_set =
+		_mm256_cmpeq_epi8(_mm256_and_si256(lo, bits), bits);
+	const __m256i hi_set =
+		_mm256_cmpeq_epi8(_mm256_and_si256(hi, bits), bits);
+
+	return _mm256_or_si256(_mm256_and_si256(lo_set, _mm256_set1_epi8(1)),
+			       _mm256_and_si256(hi_set, _mm256_set1_epi8(2)));
+}
+
+AVX2 static void tile_decode_avx2(const uint8_t *const src, uint8_t *const dst)
+{
+	const __m128i tile =
+		_mm_loadu_si128((const __m128i *)(const void *)src);
+	const __m128i low_bytes = _mm_set1_epi16(0xFF);
+
+	const __m256i planes = _mm256_broadcastsi128_si256(
+		_mm_packus_epi16(_mm_and_si128(tile, low_bytes),
+				 _mm_srli_epi16(tile, 8)));
+
+	// Each shuffle broadcasts the plane bytes of four rows; the low plane
+	// is in bytes 0-7 and the high plane in bytes 8-15 of each lane.
+	const __m256i lo_0 = _mm256_setr_epi64x(0, 0x0101010101010101,
+						0x0202020202020202,
+						0x0303030303030303);
+	const __m256i lo_1 = _mm256_add_epi8(lo_0, _mm256_set1_epi8(4));
+	const __m256i hi_0 = _mm256_add_epi8(lo_0, _mm256_set1_epi8(8));
+	const __m256i hi_1 = _mm256_add_epi8(lo_0, _mm256_set1_epi8(12));
+
+	_mm256_storeu_si256(
+		(__m256i *)(void *)dst,
+		rows_decode_avx2(_mm256_shuffle_epi8(planes, lo_0),
+				 _mm256_shuffle_epi8(planes, hi_0)));
+	_mm256_storeu_si256(
+		(__m256i *)(void *)&dst[32],
+		rows_decode_avx2(_mm256_shuffle_epi8(planes, lo_1),
+				 _mm256_shuffle_epi8(planes, hi_1)));
+}
+
+const struct ppu_kernels agoge_core_ppu_kernels_sse2 = {
+	.tile_decode = &tile_decode_sse2,
+	.frame = &agoge_core_frame_kernels_sse2
+};
+
+const struct ppu_kernels agoge_core_ppu_kernels_avx2 = {
+	.tile_decode = &tile_decode_avx2,
+	.frame = &agoge_core_frame_kernels_avx2
+};
+
+#endif // defined(__x86_64__) || defined(__i386__)
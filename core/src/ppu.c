@@ -0,0 +1,805 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file ppu.c Defines the implementation of the picture processing unit.
+
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "agoge/bus.h"
+#include "comp.h"
+#include "cpu.h"
+#include "defs.h"
+#include "ppu-defs.h"
+#include "ppu.h"
+#include "render.h"
+#include "video.h"
+
+static void tile_decode_scalar(const uint8_t *const src, uint8_t *const dst)
+{
+	for (unsigned int y = 0; y < TILE_SIZE; ++y) {
+		const unsigned int lo = src[y * 2];
+		const unsigned int hi = src[(y * 2) + 1];
+
+		for (unsigned int x = 0; x < TILE_SIZE; ++x) {
+			const unsigned int bit = 7 - x;
+
+			dst[(y * TILE_SIZE) + x] =
+				(uint8_t)(((lo >> bit) & 1) |
+					  (((hi >> bit) & 1) << 1));
+		}
+	}
+}
+
+static const struct ppu_kernels kernels_scalar = {
+	.tile_decode = &tile_decode_scalar,
+	.frame = &agoge_core_frame_kernels_scalar
+};
+
+static const struct ppu_kernels *kernels_get(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx2")) {
+		return &agoge_core_ppu_kernels_avx2;
+	}
+
+	if (__builtin_cpu_supports("sse2")) {
+		return &agoge_core_ppu_kernels_sse2;
+	}
+#endif // defined(__x86_64__) || defined(__i386__)
+
+	return &kernels_scalar;
+}
+
+const uint8_t *agoge_core_ppu_tile_get(struct agoge_core_ctx *const ctx,
+				       const unsigned int idx)
+{
+	uint64_t *const dirty = &ctx->ppu.tiles_dirty[idx / 64];
+	const uint64_t bit = UINT64_C(1) << (idx % 64);
+
+	if (unlikely(*dirty & bit)) {
+		ctx->ppu.kernels->tile_decode(&ctx->bus.vram[idx * TILE_BYTES],
+					      &ctx->ppu.tiles[idx][0][0]);
+		*dirty &= ~bit;
+	}
+	return &ctx->ppu.tiles[idx][0][0];
+}
+
+CONST unsigned int agoge_core_ppu_tile_idx(const uint8_t lcdc,
+					   const uint8_t tile_num)
+{
+	return (lcdc & LCDC_TILE_DATA) ? tile_num :
+					 (unsigned int)(256 + (int8_t)tile_num);
+}
+
+const uint8_t *agoge_core_ppu_obj_row(struct agoge_core_ctx *const ctx,
+				      const uint8_t *const obj)
+{
+	const unsigned int height = (ctx->ppu.lcdc & LCDC_OBJ_SIZE) ? 16 : 8;
+
+	unsigned int row = ctx->ppu.ly + 16 - obj[0];
+	unsigned int tile = obj[2];
+
+	if (obj[3] & OBJ_ATTR_Y_FLIP) {
+		row = height - 1 - row;
+	}
+
+	if (height == 16) {
+		tile = (tile & 0xFE) | (row / TILE_SIZE);
+	}
+	const uint8_t *const pixels = agoge_core_ppu_tile_get(ctx, tile);
+	return &pixels[(row % TILE_SIZE) * TILE_SIZE];
+}
+
+/// Copies `num_tiles` consecutive rows of tiles from a tile map.
+static void map_row_fetch(struct agoge_core_ctx *const ctx,
+			  const unsigned int map, const unsigned int y,
+			  unsigned int col, const unsigned int num_tiles,
+			  uint8_t *dst)
+{
+	const uint8_t *const map_row =
+		&ctx->bus.vram[map + ((y / TILE_SIZE) * MAP_WIDTH)];
+
+	for (unsigned int i = 0; i < num_tiles; ++i) {
+		const unsigned int idx = agoge_core_ppu_tile_idx(
+			ctx->ppu.lcdc, map_row[col++ % MAP_WIDTH]);
+		const uint8_t *const tile = agoge_core_ppu_tile_get(ctx, idx);
+
+		memcpy(dst, &tile[(y % TILE_SIZE) * TILE_SIZE], TILE_SIZE);
+		dst += TILE_SIZE;
+	}
+}
+
+/// Checks whether the window is drawn on the current line.
+static bool window_visible(const struct agoge_core_ppu *const ppu)
+{
+	return ((ppu->lcdc & (LCDC_BG_ENABLE | LCDC_WIN_ENABLE)) ==
+		(LCDC_BG_ENABLE | LCDC_WIN_ENABLE)) &&
+	       (ppu->ly >= ppu->wy) && (ppu->wx < (WIDTH + 7));
+}
+
+/// Renders the background and window of the current line as palette indices.
+static void bg_render(struct agoge_core_ctx *const ctx, uint8_t *const bg)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+
+	// One extra tile absorbs the fine horizontal scroll.
+	uint8_t row[WIDTH + TILE_SIZE];
+
+	if (!(ppu->lcdc & LCDC_BG_ENABLE)) {
+		memset(bg, 0, WIDTH);
+		return;
+	}
+
+	const unsigned int y = (ppu->ly + ppu->scy) & UINT8_MAX;
+
+	map_row_fetch(ctx, (ppu->lcdc & LCDC_BG_MAP) ? MAP_HI : MAP_LO, y,
+		      ppu->scx / TILE_SIZE, (WIDTH / TILE_SIZE) + 1, row);
+	memcpy(bg, &row[ppu->scx % TILE_SIZE], WIDTH);
+
+	if (!window_visible(ppu)) {
+		return;
+	}
+
+	// The window starts at WX - 7, which may be left of the screen.
+	const int win_x = ppu->wx - 7;
+	const unsigned int skip = (win_x < 0) ? (unsigned int)-win_x : 0;
+	const unsigned int start = (win_x < 0) ? 0 : (unsigned int)win_x;
+
+	map_row_fetch(ctx, (ppu->lcdc & LCDC_WIN_MAP) ? MAP_HI : MAP_LO,
+		      ppu->window_line, 0, (WIDTH / TILE_SIZE) + 1, row);
+	memcpy(&bg[start], &row[skip], WIDTH - start);
+
+	ppu->window_line++;
+}
+
+unsigned int agoge_core_ppu_oam_scan(const struct agoge_core_ctx *const ctx,
+				     uint8_t *const objs)
+{
+	const unsigned int height = (ctx->ppu.lcdc & LCDC_OBJ_SIZE) ? 16 : 8;
+	unsigned int num_objs = 0;
+
+	for (unsigned int i = 0;
+	     (i < NUM_OBJS) && (num_objs < OBJS_PER_LINE_MAX); ++i) {
+		const unsigned int row = ctx->ppu.ly + 16 - ctx->bus.oam[i * 4];
+
+		if (row < height) {
+			objs[num_objs++] = (uint8_t)i;
+		}
+	}
+	return num_objs;
+}
+
+/// Renders the sprites of the current line over the background.
+static void objs_render(struct agoge_core_ctx *const ctx,
+			const uint8_t *const bg, uint8_t *const dst)
+{
+	const struct agoge_core_ppu *const ppu = &ctx->ppu;
+
+	uint8_t objs[OBJS_PER_LINE_MAX];
+	const unsigned int num_objs = agoge_core_ppu_oam_scan(ctx, objs);
+
+	// The sprite with the smallest X wins, then the first one in OAM. The
+	// insertion sort keeps OAM order for equal X.
+	for (unsigned int i = 1; i < num_objs; ++i) {
+		const uint8_t obj = objs[i];
+		const uint8_t x = ctx->bus.oam[(obj * 4) + 1];
+		unsigned int j = i;
+
+		for (; (j > 0) && (ctx->bus.oam[(objs[j - 1] * 4) + 1] > x);
+		     --j) {
+			objs[j] = objs[j - 1];
+		}
+		objs[j] = obj;
+	}
+
+	bool taken[WIDTH] = { false };
+
+	for (unsigned int i = 0; i < num_objs; ++i) {
+		const uint8_t *const obj = &ctx->bus.oam[objs[i] * 4];
+		const uint8_t attr = obj[3];
+		const uint8_t pal =
+			(attr & OBJ_ATTR_PALETTE) ? ppu->obp1 : ppu->obp0;
+		const uint8_t *const pixels = agoge_core_ppu_obj_row(ctx, obj);
+
+		for (unsigned int px = 0; px < TILE_SIZE; ++px) {
+			const int x = obj[1] - 8 + (int)px;
+
+			if ((x < 0) || (x >= WIDTH) || taken[x]) {
+				continue;
+			}
+
+			const unsigned int color =
+				pixels[(attr & OBJ_ATTR_X_FLIP) ? (7 - px) :
+								  px];
+
+			if (color == 0) {
+				continue;
+			}
+			taken[x] = true;
+
+			if (!(attr & OBJ_ATTR_BEHIND_BG) || (bg[x] == 0)) {
+				dst[x] = (pal >> (color * 2)) & 3;
+			}
+		}
+	}
+}
+
+/// Records the hash of a line, and whether it changed.
+static void line_hash_update(struct agoge_core_ppu *const ppu,
+			     const unsigned int ly, const uint64_t hash)
+{
+	if (ppu->line_hash[ly] != hash) {
+		ppu->line_hash[ly] = hash;
+		ppu->lines_changed[ly / 64] |= UINT64_C(1) << (ly % 64);
+	}
+}
+
+void agoge_core_ppu_line_end(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+	const uint64_t hash =
+		agoge_core_frame_line_hash(&ppu->frame[ppu->ly * WIDTH]);
+
+	line_hash_update(ppu, ppu->ly, hash);
+
+	ppu->hash = agoge_core_frame_hash_add(
+		(ppu->ly == 0) ? FRAME_HASH_SEED : ppu->hash, hash);
+
+	if (ppu->ly == (AGOGE_CORE_FRAME_HEIGHT - 1)) {
+		ppu->frame_hash = ppu->hash;
+	}
+	agoge_core_video_line(ctx);
+}
+
+void agoge_core_ppu_frame_blank(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+
+	memset(ppu->frame, 0, sizeof(ppu->frame));
+
+	// Every line is the same.
+	const uint64_t hash = agoge_core_frame_line_hash(ppu->frame);
+
+	ppu->frame_hash = FRAME_HASH_SEED;
+
+	for (unsigned int ly = 0; ly < AGOGE_CORE_FRAME_HEIGHT; ++ly) {
+		line_hash_update(ppu, ly, hash);
+		ppu->frame_hash =
+			agoge_core_frame_hash_add(ppu->frame_hash, hash);
+	}
+}
+
+void agoge_core_ppu_line_render(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+	uint8_t *const dst = &ppu->frame[ppu->ly * WIDTH];
+	uint8_t bg[WIDTH];
+
+	bg_render(ctx, bg);
+
+	const uint8_t bgp[4] = { ppu->bgp & 3, (ppu->bgp >> 2) & 3,
+				 (ppu->bgp >> 4) & 3, (ppu->bgp >> 6) & 3 };
+
+	// Applying a palette is a lookup like converting to luma.
+	ppu->kernels->frame->luma_row(bg, bgp, dst);
+
+	if (ppu->lcdc & LCDC_OBJ_ENABLE) {
+		objs_render(ctx, bg, dst);
+	}
+	agoge_core_ppu_line_end(ctx);
+}
+
+static void draw_begin_fast(struct agoge_core_ctx *const ctx)
+{
+	ctx->ppu.next_event += MODE_DRAW_CYCLES;
+}
+
+static bool draw_event_fast(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+
+	if (!ppu->skip && (ppu->renderer == NULL)) {
+		agoge_core_ppu_line_render(ctx);
+	} else {
+		if (!ppu->skip) {
+			agoge_core_render_line(ctx);
+
+			if (ppu->ly == (AGOGE_CORE_FRAME_HEIGHT - 1)) {
+				agoge_core_render_frame_end(ctx);
+			}
+		}
+
+		// The window line advances as if the line was rendered.
+		if (window_visible(ppu)) {
+			ppu->window_line++;
+		}
+	}
+
+	ppu->next_event += MODE_HBLANK_CYCLES;
+	return true;
+}
+
+static void sync_fast(struct agoge_core_ctx *const ctx)
+{
+	(void)ctx;
+}
+
+static const struct ppu_backend backend_fast = {
+	.draw_begin = &draw_begin_fast,
+	.draw_event = &draw_event_fast,
+	.sync = &sync_fast
+};
+
+/// Updates the STAT interrupt line, requesting an interrupt on its rising
+/// edge.
+static void stat_update(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+	bool line = false;
+
+	if (ppu->lcdc & LCDC_LCD_ENABLE) {
+		line = ((ppu->stat & STAT_INT_LYC) && (ppu->ly == ppu->lyc)) ||
+		       ((ppu->stat & STAT_INT_HBLANK) &&
+			(ppu->mode == AGOGE_CORE_PPU_MODE_HBLANK)) ||
+		       ((ppu->stat & STAT_INT_VBLANK) &&
+			(ppu->mode == AGOGE_CORE_PPU_MODE_VBLANK)) ||
+		       ((ppu->stat & STAT_INT_OAM) &&
+			(ppu->mode == AGOGE_CORE_PPU_MODE_OAM));
+	}
+
+	if (line && !ppu->stat_line) {
+		agoge_core_cpu_intr_raise(ctx, AGOGE_CORE_CPU_INTR_STAT);
+	}
+	ppu->stat_line = line;
+}
+
+/// Starts a frame at line 0, and decides whether to render it.
+static void frame_begin(struct agoge_core_ppu *const ppu)
+{
+	ppu->ly = 0;
+	ppu->window_line = 0;
+
+	switch (ppu->render) {
+	case AGOGE_CORE_PPU_RENDER_NTH:
+		ppu->skip = (ppu->frames % ppu->render_interval) != 0;
+		break;
+
+	case AGOGE_CORE_PPU_RENDER_NONE:
+		ppu->skip = true;
+		break;
+
+	case AGOGE_CORE_PPU_RENDER_ALL:
+	default:
+		ppu->skip = false;
+		break;
+	}
+
+	if (!ppu->skip) {
+		memset(ppu->lines_changed, 0, sizeof(ppu->lines_changed));
+	}
+}
+
+PURE bool agoge_core_ppu_renders(const struct agoge_core_ppu *const ppu)
+{
+	return (ppu->renderer == NULL) || (ppu->ops != &backend_fast);
+}
+
+/// Checks whether a frame completed on this context goes to its video output,
+/// rather than being rendered by a renderer.
+static bool video_owned(const struct agoge_core_ppu *const ppu)
+{
+	return !ppu->skip && agoge_core_ppu_renders(ppu);
+}
+
+static void event_handle(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+
+	if (!(ppu->lcdc & LCDC_LCD_ENABLE)) {
+		ppu->frames++;
+		ppu->next_event += AGOGE_CORE_FRAME_CYCLES;
+
+		// The callback may have swapped buffers; blank the new one.
+		if (video_owned(ppu)) {
+			agoge_core_video_blank(ctx);
+			agoge_core_video_frame_end(ctx);
+		} else if (!ppu->skip) {
+			agoge_core_render_blank(ctx, false);
+			agoge_core_render_frame_end(ctx);
+		}
+		return;
+	}
+
+	switch (ppu->mode) {
+	case AGOGE_CORE_PPU_MODE_OAM:
+		ppu->mode = AGOGE_CORE_PPU_MODE_DRAW;
+		ppu->ops->draw_begin(ctx);
+		break;
+
+	case AGOGE_CORE_PPU_MODE_DRAW:
+		if (!ppu->ops->draw_event(ctx)) {
+			return;
+		}
+		ppu->mode = AGOGE_CORE_PPU_MODE_HBLANK;
+		break;
+
+	case AGOGE_CORE_PPU_MODE_HBLANK:
+		if (++ppu->ly == AGOGE_CORE_FRAME_HEIGHT) {
+			ppu->mode = AGOGE_CORE_PPU_MODE_VBLANK;
+			ppu->next_event += LINE_CYCLES;
+			ppu->frames++;
+
+			if (video_owned(ppu)) {
+				agoge_core_video_frame_end(ctx);
+			}
+			agoge_core_cpu_intr_raise(ctx,
+						  AGOGE_CORE_CPU_INTR_VBLANK);
+			break;
+		}
+		ppu->mode = AGOGE_CORE_PPU_MODE_OAM;
+		ppu->next_event += MODE_OAM_CYCLES;
+		break;
+
+	case AGOGE_CORE_PPU_MODE_VBLANK:
+	default:
+		if (++ppu->ly == NUM_LINES) {
+			frame_begin(ppu);
+			ppu->mode = AGOGE_CORE_PPU_MODE_OAM;
+			ppu->next_event += MODE_OAM_CYCLES;
+			break;
+		}
+		ppu->next_event += LINE_CYCLES;
+		break;
+	}
+	stat_update(ctx);
+}
+
+static void lcdc_write(struct agoge_core_ctx *const ctx, const uint8_t data)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+	const bool was_on = ppu->lcdc & LCDC_LCD_ENABLE;
+	const bool on = data & LCDC_LCD_ENABLE;
+
+	ppu->lcdc = data;
+
+	if (was_on == on) {
+		return;
+	}
+
+	frame_begin(ppu);
+
+	if (on) {
+		ppu->mode = AGOGE_CORE_PPU_MODE_OAM;
+		ppu->next_event = ctx->cpu.cycles + MODE_OAM_CYCLES;
+	} else {
+		ppu->mode = AGOGE_CORE_PPU_MODE_HBLANK;
+		ppu->next_event = ctx->cpu.cycles + AGOGE_CORE_FRAME_CYCLES;
+		agoge_core_ppu_frame_blank(ctx);
+
+		if (ppu->renderer != NULL) {
+			agoge_core_render_blank(ctx, !ppu->skip);
+		}
+	}
+
+	// The next event moved; let the scheduler pick it up.
+	stat_update(ctx);
+	agoge_core_cpu_yield(ctx);
+}
+
+void agoge_core_ppu_tables_select(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+
+	switch (ppu->backend) {
+	case AGOGE_CORE_PPU_BACKEND_FAST:
+		ppu->ops = &backend_fast;
+		break;
+
+	case AGOGE_CORE_PPU_BACKEND_ACCURATE:
+		ppu->ops = &agoge_core_ppu_backend_accurate;
+		break;
+
+	case AGOGE_CORE_PPU_BACKEND_DEFAULT:
+	default:
+#ifdef AGOGE_PPU_ACCURATE
+		ppu->ops = &agoge_core_ppu_backend_accurate;
+#else
+		ppu->ops = &backend_fast;
+#endif // AGOGE_PPU_ACCURATE
+		break;
+	}
+	ppu->kernels = kernels_get();
+}
+
+void agoge_core_ppu_reset(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+	const uint8_t backend = ppu->backend;
+	const uint8_t render = ppu->render;
+	const uint32_t render_interval = ppu->render_interval;
+	struct agoge_core_render *const renderer = ppu->renderer;
+	const struct agoge_core_video video = ppu->video;
+
+	memset(ppu, 0, sizeof(*ppu));
+
+	ppu->backend = backend;
+	ppu->render = render;
+	ppu->render_interval = render_interval;
+	ppu->renderer = renderer;
+	ppu->video = video;
+	agoge_core_ppu_tables_select(ctx);
+	frame_begin(ppu);
+
+	ppu->frame_hash = agoge_core_frame_hash(ppu->frame);
+
+	ppu->lcdc = LCDC_LCD_ENABLE | LCDC_TILE_DATA | LCDC_BG_ENABLE;
+	ppu->bgp = 0xFC;
+	ppu->mode = AGOGE_CORE_PPU_MODE_OAM;
+	ppu->next_event = ctx->cpu.cycles + MODE_OAM_CYCLES;
+
+	agoge_core_ppu_vram_invalidate(ctx);
+}
+
+void agoge_core_ppu_backend_set(struct agoge_core_ctx *const ctx,
+				const enum agoge_core_ppu_backend backend)
+{
+	ctx->ppu.backend = (uint8_t)backend;
+}
+
+void agoge_core_ppu_render_set(struct agoge_core_ctx *const ctx,
+			       const enum agoge_core_ppu_render render,
+			       const uint32_t interval)
+{
+	assert((render != AGOGE_CORE_PPU_RENDER_NTH) || (interval != 0));
+
+	ctx->ppu.render = (uint8_t)render;
+	ctx->ppu.render_interval = interval;
+}
+
+PURE uint64_t agoge_core_ppu_frame_hash(const struct agoge_core_ctx *const ctx)
+{
+	assert(agoge_core_ppu_renders(&ctx->ppu));
+	return ctx->ppu.frame_hash;
+}
+
+void agoge_core_ppu_update(struct agoge_core_ctx *const ctx)
+{
+	while (ctx->ppu.next_event <= ctx->cpu.cycles) {
+		event_handle(ctx);
+	}
+}
+
+PURE uint8_t agoge_core_ppu_read(const struct agoge_core_ctx *const ctx,
+				 const uint16_t addr)
+{
+	const struct agoge_core_ppu *const ppu = &ctx->ppu;
+
+	switch (addr) {
+	case 0xFF40:
+		return ppu->lcdc;
+
+	case 0xFF41:
+		return BIT_7 | (ppu->stat & STAT_WRITABLE) |
+		       ((ppu->ly == ppu->lyc) ? STAT_LYC_EQ : 0) | ppu->mode;
+
+	case 0xFF42:
+		return ppu->scy;
+
+	case 0xFF43:
+		return ppu->scx;
+
+	case 0xFF44:
+		return ppu->ly;
+
+	case 0xFF45:
+		return ppu->lyc;
+
+	case 0xFF46:
+		return ppu->dma;
+
+	case 0xFF47:
+		return ppu->bgp;
+
+	case 0xFF48:
+		return ppu->obp0;
+
+	case 0xFF49:
+		return ppu->obp1;
+
+	case 0xFF4A:
+		return ppu->wy;
+
+	case 0xFF4B:
+		return ppu->wx;
+
+	default:
+		return 0xFF;
+	}
+}
+
+void agoge_core_ppu_write(struct agoge_core_ctx *const ctx, const uint16_t addr,
+			  const uint8_t data)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+
+	ppu->ops->sync(ctx);
+
+	switch (addr) {
+	case 0xFF40:
+		lcdc_write(ctx, data);
+		return;
+
+	case 0xFF41:
+		ppu->stat = data & STAT_WRITABLE;
+		stat_update(ctx);
+		return;
+
+	case 0xFF42:
+		ppu->scy = data;
+		return;
+
+	case 0xFF43:
+		ppu->scx = data;
+		return;
+
+	case 0xFF45:
+		ppu->lyc = data;
+		stat_update(ctx);
+		return;
+
+	// OAM DMA completes instantly.
+	case 0xFF46:
+		ppu->dma = data;
+		agoge_core_bus_peek_range(ctx, (uint16_t)(data << 8),
+					  ctx->bus.oam, sizeof(ctx->bus.oam));
+
+		for (uint16_t i = 0; i < sizeof(ctx->bus.oam); ++i) {
+			agoge_core_ppu_oam_changed(ctx, i, ctx->bus.oam[i]);
+		}
+		return;
+
+	case 0xFF47:
+		ppu->bgp = data;
+		return;
+
+	case 0xFF48:
+		ppu->obp0 = data;
+		return;
+
+	case 0xFF49:
+		ppu->obp1 = data;
+		return;
+
+	case 0xFF4A:
+		ppu->wy = data;
+		return;
+
+	case 0xFF4B:
+		ppu->wx = data;
+		return;
+
+	// LY is read-only.
+	default:
+		return;
+	}
+}
+
+void agoge_core_ppu_poke(struct agoge_core_ctx *const ctx, const uint16_t addr,
+			 const uint8_t data)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+
+	ppu->ops->sync(ctx);
+
+	switch (addr) {
+	case 0xFF40:
+		ppu->lcdc = (uint8_t)((data & ~LCDC_LCD_ENABLE) |
+				      (ppu->lcdc & LCDC_LCD_ENABLE));
+		return;
+
+	case 0xFF41:
+		ppu->stat = data & STAT_WRITABLE;
+		return;
+
+	case 0xFF42:
+		ppu->scy = data;
+		return;
+
+	case 0xFF43:
+		ppu->scx = data;
+		return;
+
+	case 0xFF45:
+		ppu->lyc = data;
+		return;
+
+	case 0xFF46:
+		ppu->dma = data;
+		return;
+
+	case 0xFF47:
+		ppu->bgp = data;
+		return;
+
+	case 0xFF48:
+		ppu->obp0 = data;
+		return;
+
+	case 0xFF49:
+		ppu->obp1 = data;
+		return;
+
+	case 0xFF4A:
+		ppu->wy = data;
+		return;
+
+	case 0xFF4B:
+		ppu->wx = data;
+		return;
+
+	default:
+		return;
+	}
+}
+
+void agoge_core_ppu_vram_write(struct agoge_core_ctx *const ctx,
+			       const uint16_t addr, const uint8_t data)
+{
+	ctx->ppu.ops->sync(ctx);
+	agoge_core_ppu_vram_changed(ctx, addr - 0x8000, data);
+}
+
+void agoge_core_ppu_vram_changed(struct agoge_core_ctx *const ctx,
+				 const uint16_t offset, const uint8_t data)
+{
+	const unsigned int idx = offset / TILE_BYTES;
+
+	if (idx < AGOGE_CORE_PPU_NUM_TILES) {
+		ctx->ppu.tiles_dirty[idx / 64] |= UINT64_C(1) << (idx % 64);
+	}
+
+	if (ctx->ppu.renderer != NULL) {
+		agoge_core_render_vram(ctx, offset, data);
+	}
+}
+
+void agoge_core_ppu_oam_write(struct agoge_core_ctx *const ctx,
+			      const uint16_t addr, const uint8_t data)
+{
+	ctx->ppu.ops->sync(ctx);
+	agoge_core_ppu_oam_changed(ctx, addr - 0xFE00, data);
+}
+
+void agoge_core_ppu_oam_changed(struct agoge_core_ctx *const ctx,
+				const uint16_t offset, const uint8_t data)
+{
+	if (ctx->ppu.renderer != NULL) {
+		agoge_core_render_oam(ctx, offset, data);
+	}
+}
+
+void agoge_core_ppu_vram_invalidate(struct agoge_core_ctx *const ctx)
+{
+	memset(ctx->ppu.tiles_dirty, UINT8_MAX, sizeof(ctx->ppu.tiles_dirty));
+}
@@ -0,0 +1,144 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ctx.h"
+#include "frame.h"
+
+/// Defines a set of PPU kernels implemented for a given instruction set.
+struct ppu_kernels {
+	/// Decodes the 16 bytes of a tile in VRAM into 64 palette indices.
+	void (*tile_decode)(const uint8_t *src, uint8_t *dst);
+
+	/// The frame kernels of the same instruction set; their lookups apply
+	/// palettes to scanlines.
+	const struct frame_kernels *frame;
+};
+
+/// Defines the functions of a rendering backend.
+struct ppu_backend {
+	/// Starts mode 3 of the current line, and schedules the next event.
+	void (*draw_begin)(struct agoge_core_ctx *ctx);
+
+	/// Handles an event during mode 3.
+	///
+	/// @returns Whether the line is complete, in which case the end of
+	/// HBlank is scheduled; otherwise, the next event is.
+	bool (*draw_event)(struct agoge_core_ctx *ctx);
+
+	/// Brings rendering up to the current CPU cycle before a write to a PPU
+	/// register, VRAM or OAM.
+	void (*sync)(struct agoge_core_ctx *ctx);
+};
+
+extern const struct ppu_backend agoge_core_ppu_backend_accurate;
+
+#if defined(__x86_64__) || defined(__i386__)
+extern const struct ppu_kernels agoge_core_ppu_kernels_sse2;
+extern const struct ppu_kernels agoge_core_ppu_kernels_avx2;
+#endif // defined(__x86_64__) || defined(__i386__)
+
+void agoge_core_ppu_reset(struct agoge_core_ctx *ctx);
+
+/// Processes every PPU event due at or before the current CPU cycle.
+void agoge_core_ppu_update(struct agoge_core_ctx *ctx);
+
+/// Reads a PPU register ($FF40-$FF4B) without side effects.
+uint8_t agoge_core_ppu_read(const struct agoge_core_ctx *ctx, uint16_t addr);
+
+/// Writes a PPU register ($FF40-$FF4B).
+void agoge_core_ppu_write(struct agoge_core_ctx *ctx, uint16_t addr,
+			  uint8_t data);
+
+/// Writes a PPU register ($FF40-$FF4B) without side effects, i.e., without
+/// turning the LCD on or off, starting OAM DMA or raising interrupts. The LCD
+/// enable bit of LCDC and LY are kept.
+void agoge_core_ppu_poke(struct agoge_core_ctx *ctx, uint16_t addr,
+			 uint8_t data);
+
+/// Renders the current line with the fast renderer.
+void agoge_core_ppu_line_render(struct agoge_core_ctx *ctx);
+
+/// Completes the current line once all of its pixels are in the frame: hashes
+/// it and hands it to the video output.
+void agoge_core_ppu_line_end(struct agoge_core_ctx *ctx);
+
+/// Blanks the frame, as when the LCD is turned off.
+void agoge_core_ppu_frame_blank(struct agoge_core_ctx *ctx);
+
+/// Checks whether a PPU renders its own frames, i.e., keeps its frame, line
+/// hashes and frame hash up to date, rather than handing its scanlines to a
+/// renderer.
+bool agoge_core_ppu_renders(const struct agoge_core_ppu *ppu);
+
+/// Selects the backend functions and kernels of a context; called at reset and
+/// when loading a state.
+void agoge_core_ppu_tables_select(struct agoge_core_ctx *ctx);
+
+/// Retrieves a decoded tile, decoding it first if it is dirty.
+const uint8_t *agoge_core_ppu_tile_get(struct agoge_core_ctx *ctx,
+				       unsigned int idx);
+
+/// Converts a tile number fetched from a tile map into a tile index.
+unsigned int agoge_core_ppu_tile_idx(uint8_t lcdc, uint8_t tile_num);
+
+/// Retrieves the decoded row of a sprite on the current line.
+///
+/// @param obj The attributes of the sprite in OAM.
+const uint8_t *agoge_core_ppu_obj_row(struct agoge_core_ctx *ctx,
+				      const uint8_t *obj);
+
+/// Finds the sprites on the current line, in OAM order.
+///
+/// @param objs The OAM indices of the sprites; `AGOGE_CORE_PPU_LINE_OBJS_MAX`
+/// entries.
+/// @returns The number of sprites found.
+unsigned int agoge_core_ppu_oam_scan(const struct agoge_core_ctx *ctx,
+				     uint8_t *objs);
+
+/// Notifies the PPU of a write to VRAM by the CPU; call it before the write.
+void agoge_core_ppu_vram_write(struct agoge_core_ctx *ctx, uint16_t addr,
+			       uint8_t data);
+
+/// Notifies the PPU of a change to VRAM that is not a CPU write, e.g., from
+/// the debugger.
+///
+/// @param offset The offset of the change within VRAM.
+/// @param data The new byte.
+void agoge_core_ppu_vram_changed(struct agoge_core_ctx *ctx, uint16_t offset,
+				 uint8_t data);
+
+/// Notifies the PPU of a write to OAM by the CPU; call it before the write.
+void agoge_core_ppu_oam_write(struct agoge_core_ctx *ctx, uint16_t addr,
+			      uint8_t data);
+
+/// Notifies the PPU of a change to OAM that is not a CPU write.
+///
+/// @param offset The offset of the change within OAM.
+/// @param data The new byte.
+void agoge_core_ppu_oam_changed(struct agoge_core_ctx *ctx, uint16_t offset,
+				uint8_t data);
+
+/// Marks every tile as dirty, e.g., after VRAM was replaced as a whole.
+void agoge_core_ppu_vram_invalidate(struct agoge_core_ctx *ctx);
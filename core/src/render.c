@@ -0,0 +1,365 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file render.c Defines the implementation of off-thread rendering.
+///
+/// The render thread owns a private context whose VRAM, OAM and PPU registers
+/// are only written by replayed records; its PPU state is otherwise unused.
+
+#include <sched.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif // defined(__x86_64__) || defined(__i386__)
+
+#include "comp.h"
+#include "ppu.h"
+#include "render.h"
+#include "video.h"
+
+/// The number of times the emulation thread polls a full queue, pausing between
+/// polls, before it yields the CPU between polls instead.
+#define PUSH_SPINS_MAX (64)
+
+/// Defines the types of records.
+enum rec_type {
+	/// A scanline to render with the registers of the record.
+	REC_TYPE_LINE,
+
+	/// The end of a rendered frame.
+	REC_TYPE_FRAME,
+
+	/// The frame was blanked, as while the LCD is off.
+	REC_TYPE_BLANK,
+
+	/// A write to VRAM.
+	REC_TYPE_VRAM,
+
+	/// A write to OAM.
+	REC_TYPE_OAM
+};
+
+/// Defines a record of the queue.
+struct rec {
+	uint8_t type;
+
+	/// The byte written by `REC_TYPE_VRAM` and `REC_TYPE_OAM` records, and
+	/// whether a `REC_TYPE_BLANK` record starts a rendered frame.
+	uint8_t data;
+
+	/// The offset written by `REC_TYPE_VRAM` and `REC_TYPE_OAM` records.
+	uint16_t addr;
+
+	/// The registers of `REC_TYPE_LINE` records.
+	uint8_t ly;
+	uint8_t window_line;
+	uint8_t lcdc;
+	uint8_t scy;
+	uint8_t scx;
+	uint8_t bgp;
+	uint8_t obp0;
+	uint8_t obp1;
+	uint8_t wy;
+	uint8_t wx;
+};
+
+struct agoge_core_render {
+	struct rec queue[AGOGE_CORE_RENDER_QUEUE_SIZE];
+
+	/// The number of records consumed; written by the render thread.
+	alignas(64) atomic_size_t head;
+
+	/// The number of records produced; written by the emulation thread.
+	alignas(64) atomic_size_t tail;
+
+	/// The last value of `head` seen by the emulation thread, so that it
+	/// only reads `head` when the queue looks full.
+	size_t head_cache;
+
+	/// Set once the render thread stopped; records which do not fit are
+	/// dropped from then on.
+	atomic_bool stopped;
+
+	/// The context replaying the records.
+	alignas(64) struct agoge_core_ctx *ctx;
+};
+
+/// Lets the render thread run while the emulation thread waits for it.
+static void push_backoff(const unsigned int spins)
+{
+	if (spins < PUSH_SPINS_MAX) {
+#if defined(__x86_64__) || defined(__i386__)
+		_mm_pause();
+#endif // defined(__x86_64__) || defined(__i386__)
+	} else {
+		sched_yield();
+	}
+}
+
+static void push(struct agoge_core_render *const render,
+		 const struct rec *const rec)
+{
+	const size_t tail =
+		atomic_load_explicit(&render->tail, memory_order_relaxed);
+
+	// Wait for the render thread to make room, unless it stopped.
+	for (unsigned int spins = 0;
+	     unlikely((tail - render->head_cache) ==
+		      AGOGE_CORE_RENDER_QUEUE_SIZE);
+	     ++spins) {
+		if (atomic_load_explicit(&render->stopped,
+					 memory_order_acquire)) {
+			return;
+		}
+
+		push_backoff(spins);
+		render->head_cache = atomic_load_explicit(&render->head,
+							  memory_order_acquire);
+	}
+
+	render->queue[tail % AGOGE_CORE_RENDER_QUEUE_SIZE] = *rec;
+	atomic_store_explicit(&render->tail, tail + 1, memory_order_release);
+}
+
+static void push_write(struct agoge_core_ctx *const ctx,
+		       const enum rec_type type, const uint16_t addr,
+		       const uint8_t data)
+{
+	const struct rec rec = { .type = (uint8_t)type,
+				 .data = data,
+				 .addr = addr };
+
+	push(ctx->ppu.renderer, &rec);
+}
+
+void agoge_core_render_line(struct agoge_core_ctx *const ctx)
+{
+	const struct agoge_core_ppu *const ppu = &ctx->ppu;
+	const struct rec rec = { .type = REC_TYPE_LINE,
+				 .ly = ppu->ly,
+				 .window_line = ppu->window_line,
+				 .lcdc = ppu->lcdc,
+				 .scy = ppu->scy,
+				 .scx = ppu->scx,
+				 .bgp = ppu->bgp,
+				 .obp0 = ppu->obp0,
+				 .obp1 = ppu->obp1,
+				 .wy = ppu->wy,
+				 .wx = ppu->wx };
+
+	push(ctx->ppu.renderer, &rec);
+}
+
+void agoge_core_render_frame_end(struct agoge_core_ctx *const ctx)
+{
+	const struct rec rec = { .type = REC_TYPE_FRAME };
+	push(ctx->ppu.renderer, &rec);
+}
+
+void agoge_core_render_blank(struct agoge_core_ctx *const ctx,
+			     const bool frame_begin)
+{
+	const struct rec rec = { .type = REC_TYPE_BLANK,
+				 .data = frame_begin };
+
+	push(ctx->ppu.renderer, &rec);
+}
+
+void agoge_core_render_vram(struct agoge_core_ctx *const ctx,
+			    const uint16_t addr, const uint8_t data)
+{
+	push_write(ctx, REC_TYPE_VRAM, addr, data);
+}
+
+void agoge_core_render_oam(struct agoge_core_ctx *const ctx,
+			   const uint16_t addr, const uint8_t data)
+{
+	push_write(ctx, REC_TYPE_OAM, addr, data);
+}
+
+void agoge_core_render_resync(struct agoge_core_ctx *const ctx)
+{
+	for (uint16_t i = 0; i < sizeof(ctx->bus.vram); ++i) {
+		push_write(ctx, REC_TYPE_VRAM, i, ctx->bus.vram[i]);
+	}
+
+	for (uint16_t i = 0; i < sizeof(ctx->bus.oam); ++i) {
+		push_write(ctx, REC_TYPE_OAM, i, ctx->bus.oam[i]);
+	}
+}
+
+struct agoge_core_render *agoge_core_render_create(void)
+{
+	// aligned_alloc() requires a multiple of the alignment.
+	const size_t size =
+		(sizeof(struct agoge_core_render) + 63) & ~(size_t)63;
+	struct agoge_core_render *const render = aligned_alloc(64, size);
+
+	if (unlikely(render == NULL)) {
+		return NULL;
+	}
+
+	render->ctx = agoge_core_ctx_create(NULL,
+					    AGOGE_CORE_CTX_ALIGN_CACHE_LINE);
+
+	if (unlikely(render->ctx == NULL)) {
+		free(render);
+		return NULL;
+	}
+
+	atomic_init(&render->head, 0);
+	atomic_init(&render->tail, 0);
+	atomic_init(&render->stopped, false);
+	render->head_cache = 0;
+
+	// Only the kernels and the tile cache of the PPU are used.
+	agoge_core_ppu_reset(render->ctx);
+	return render;
+}
+
+void agoge_core_render_destroy(struct agoge_core_render *const render)
+{
+	if (render == NULL) {
+		return;
+	}
+
+	agoge_core_ctx_destroy(render->ctx);
+	free(render);
+}
+
+void agoge_core_render_attach(struct agoge_core_ctx *const ctx,
+			      struct agoge_core_render *const render)
+{
+	ctx->ppu.renderer = render;
+
+	if (render != NULL) {
+		agoge_core_render_resync(ctx);
+	}
+}
+
+void agoge_core_render_stop(struct agoge_core_render *const render)
+{
+	atomic_store_explicit(&render->stopped, true, memory_order_release);
+}
+
+/// Replays a record into the context of the renderer.
+///
+/// @returns Whether the record completes a frame.
+static bool rec_replay(struct agoge_core_ctx *const ctx,
+		       const struct rec *const rec)
+{
+	struct agoge_core_ppu *const ppu = &ctx->ppu;
+
+	switch (rec->type) {
+	case REC_TYPE_LINE:
+		// A rendered frame starts; track its changes from scratch.
+		if (rec->ly == 0) {
+			memset(ppu->lines_changed, 0,
+			       sizeof(ppu->lines_changed));
+		}
+
+		ppu->ly = rec->ly;
+		ppu->window_line = rec->window_line;
+		ppu->lcdc = rec->lcdc;
+		ppu->scy = rec->scy;
+		ppu->scx = rec->scx;
+		ppu->bgp = rec->bgp;
+		ppu->obp0 = rec->obp0;
+		ppu->obp1 = rec->obp1;
+		ppu->wy = rec->wy;
+		ppu->wx = rec->wx;
+
+		agoge_core_ppu_line_render(ctx);
+		return false;
+
+	case REC_TYPE_FRAME:
+		agoge_core_video_frame_end(ctx);
+		return true;
+
+	case REC_TYPE_BLANK:
+		if (rec->data) {
+			memset(ppu->lines_changed, 0,
+			       sizeof(ppu->lines_changed));
+		}
+
+		agoge_core_ppu_frame_blank(ctx);
+		agoge_core_video_blank(ctx);
+
+		return false;
+
+	case REC_TYPE_VRAM:
+		ctx->bus.vram[rec->addr] = rec->data;
+		agoge_core_ppu_vram_changed(ctx, rec->addr, rec->data);
+
+		return false;
+
+	case REC_TYPE_OAM:
+	default:
+		ctx->bus.oam[rec->addr] = rec->data;
+		return false;
+	}
+}
+
+bool agoge_core_render_run(struct agoge_core_render *const render)
+{
+	size_t head = atomic_load_explicit(&render->head, memory_order_relaxed);
+	const size_t tail =
+		atomic_load_explicit(&render->tail, memory_order_acquire);
+
+	bool done = false;
+
+	while ((head != tail) && !done) {
+		done = rec_replay(
+			render->ctx,
+			&render->queue[head % AGOGE_CORE_RENDER_QUEUE_SIZE]);
+		head++;
+	}
+
+	atomic_store_explicit(&render->head, head, memory_order_release);
+	return done;
+}
+
+PURE const uint8_t *
+agoge_core_render_frame(const struct agoge_core_render *const render)
+{
+	return render->ctx->ppu.frame;
+}
+
+PURE const struct agoge_core_ppu *
+agoge_core_render_ppu(const struct agoge_core_render *const render)
+{
+	return &render->ctx->ppu;
+}
+
+PURE uint64_t
+agoge_core_render_frame_hash(const struct agoge_core_render *const render)
+{
+	return render->ctx->ppu.frame_hash;
+}
+
+PURE struct agoge_core_video *
+agoge_core_render_video(struct agoge_core_render *const render)
+{
+	return &render->ctx->ppu.video;
+}
@@ -0,0 +1,55 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "agoge/render.h"
+#include "ctx.h"
+
+/// Records the registers of the current line; it is rendered by the renderer.
+void agoge_core_render_line(struct agoge_core_ctx *ctx);
+
+/// Records the end of a rendered frame.
+void agoge_core_render_frame_end(struct agoge_core_ctx *ctx);
+
+/// Records that the frame was blanked, as while the LCD is off.
+///
+/// @param frame_begin Whether a rendered frame starts, i.e., the LCD was just
+/// turned off and the changed lines are tracked from scratch.
+void agoge_core_render_blank(struct agoge_core_ctx *ctx, bool frame_begin);
+
+/// Records a write to VRAM.
+///
+/// @param addr The offset of the write within VRAM.
+/// @param data The byte written.
+void agoge_core_render_vram(struct agoge_core_ctx *ctx, uint16_t addr,
+			    uint8_t data);
+
+/// Records a write to OAM.
+///
+/// @param addr The offset of the write within OAM.
+/// @param data The byte written.
+void agoge_core_render_oam(struct agoge_core_ctx *ctx, uint16_t addr,
+			   uint8_t data);
+
+/// Records the whole of VRAM and OAM, e.g., after loading a state.
+void agoge_core_render_resync(struct agoge_core_ctx *ctx);
@@ -0,0 +1,229 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file resampler-x86.c Defines the SSE2 and AVX2 resampler kernels.
+///
+/// The coefficients of an output frame are interpolated between two phases
+/// a vector of taps at a time, and multiplied with the left and right inputs
+/// in the same pass; the lanes are summed once per frame.
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+#include <string.h>
+
+#include "resampler.h"
+
+#define SSE2 __attribute__((target("sse2")))
+#define AVX2 __attribute__((target("avx2")))
+
+/// Sums the lanes of the left and right sums of a frame, and stores the
+/// frame.
+SSE2 static void frame_store_sse2(const __m128 sum_l, const __m128 sum_r,
+				  float *const dst)
+{
+	const __m128 lo = _mm_unpacklo_ps(sum_l, sum_r);
+	const __m128 hi = _mm_unpackhi_ps(sum_l, sum_r);
+	const __m128 sum = _mm_add_ps(lo, hi);
+
+	_mm_storel_pi((__m64 *)(void *)dst,
+		      _mm_add_ps(sum, _mm_movehl_ps(sum, sum)));
+}
+
+SSE2 static __m128 tap_sse2(const float *const c0, const float *const c1,
+			    const __m128 t)
+{
+	const __m128 a = _mm_load_ps(c0);
+
+	return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(c1), a), t));
+}
+
+SSE2 static void filter_sse2(const struct agoge_core_resampler *const rs,
+			     uint64_t pos, const uint64_t step,
+			     float *const dst, const size_t num)
+{
+	for (size_t n = 0; n < num; ++n, pos += step) {
+		const float *const c0 = rs->coefs[RESAMPLER_PHASE(pos)];
+		const float *const c1 = rs->coefs[RESAMPLER_PHASE(pos) + 1];
+		const float *const l = &rs->in[0][pos >> 32];
+		const float *const r = &rs->in[1][pos >> 32];
+		const __m128 t = _mm_set1_ps(RESAMPLER_PHASE_FRAC(pos));
+
+		// Two sums per side, so that the additions do not wait on each
+		// other.
+		__m128 sum_l0 = _mm_setzero_ps();
+		__m128 sum_l1 = _mm_setzero_ps();
+		__m128 sum_r0 = _mm_setzero_ps();
+		__m128 sum_r1 = _mm_setzero_ps();
+
+		for (size_t k = 0; k < RESAMPLER_TAPS; k += 8) {
+			const __m128 ca = tap_sse2(&c0[k], &c1[k], t);
+			const __m128 cb = tap_sse2(&c0[k + 4], &c1[k + 4], t);
+
+			const __m128 la = _mm_loadu_ps(&l[k]);
+			const __m128 lb = _mm_loadu_ps(&l[k + 4]);
+			const __m128 ra = _mm_loadu_ps(&r[k]);
+			const __m128 rb = _mm_loadu_ps(&r[k + 4]);
+
+			sum_l0 = _mm_add_ps(sum_l0, _mm_mul_ps(ca, la));
+			sum_l1 = _mm_add_ps(sum_l1, _mm_mul_ps(cb, lb));
+			sum_r0 = _mm_add_ps(sum_r0, _mm_mul_ps(ca, ra));
+			sum_r1 = _mm_add_ps(sum_r1, _mm_mul_ps(cb, rb));
+		}
+		frame_store_sse2(_mm_add_ps(sum_l0, sum_l1),
+				 _mm_add_ps(sum_r0, sum_r1), &dst[n * 2]);
+	}
+}
+
+/// Scales samples to 16-bit, and clamps them; out of range conversions yield
+/// INT32_MIN.
+SSE2 static __m128i s32_sse2(const float *const src)
+{
+	const __m128 x = _mm_mul_ps(_mm_loadu_ps(src), _mm_set1_ps(32768.0F));
+
+	return _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-32768.0F)),
+					  _mm_set1_ps(32767.0F)));
+}
+
+/// Converts 8 samples to signed 16-bit.
+SSE2 static __m128i s16_sse2(const float *const src)
+{
+	return _mm_packs_epi32(s32_sse2(src), s32_sse2(&src[4]));
+}
+
+SSE2 static void to_s16_sse2(const float *const src, int16_t *const dst,
+			     const size_t num)
+{
+	size_t i = 0;
+
+	for (; (i + 8) <= num; i += 8) {
+		_mm_storeu_si128((__m128i *)(void *)&dst[i], s16_sse2(&src[i]));
+	}
+
+	if (i < num) {
+		float in[8] = { 0.0F };
+		int16_t out[8];
+
+		memcpy(in, &src[i], (num - i) * sizeof(in[0]));
+		_mm_storeu_si128((__m128i *)(void *)out, s16_sse2(in));
+		memcpy(&dst[i], out, (num - i) * sizeof(out[0]));
+	}
+}
+
+AVX2 static __m256 tap_avx2(const float *const c0, const float *const c1,
+			    const __m256 t)
+{
+	const __m256 a = _mm256_load_ps(c0);
+
+	return _mm256_add_ps(
+		a, _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(c1), a), t));
+}
+
+AVX2 static void filter_avx2(const struct agoge_core_resampler *const rs,
+			     uint64_t pos, const uint64_t step,
+			     float *const dst, const size_t num)
+{
+	for (size_t n = 0; n < num; ++n, pos += step) {
+		const float *const c0 = rs->coefs[RESAMPLER_PHASE(pos)];
+		const float *const c1 = rs->coefs[RESAMPLER_PHASE(pos) + 1];
+		const float *const l = &rs->in[0][pos >> 32];
+		const float *const r = &rs->in[1][pos >> 32];
+		const __m256 t = _mm256_set1_ps(RESAMPLER_PHASE_FRAC(pos));
+
+		__m256 sum_l0 = _mm256_setzero_ps();
+		__m256 sum_l1 = _mm256_setzero_ps();
+		__m256 sum_r0 = _mm256_setzero_ps();
+		__m256 sum_r1 = _mm256_setzero_ps();
+
+		for (size_t k = 0; k < RESAMPLER_TAPS; k += 16) {
+			const __m256 ca = tap_avx2(&c0[k], &c1[k], t);
+			const __m256 cb = tap_avx2(&c0[k + 8], &c1[k + 8], t);
+
+			const __m256 la = _mm256_loadu_ps(&l[k]);
+			const __m256 lb = _mm256_loadu_ps(&l[k + 8]);
+			const __m256 ra = _mm256_loadu_ps(&r[k]);
+			const __m256 rb = _mm256_loadu_ps(&r[k + 8]);
+
+			sum_l0 = _mm256_add_ps(sum_l0, _mm256_mul_ps(ca, la));
+			sum_l1 = _mm256_add_ps(sum_l1, _mm256_mul_ps(cb, lb));
+			sum_r0 = _mm256_add_ps(sum_r0, _mm256_mul_ps(ca, ra));
+			sum_r1 = _mm256_add_ps(sum_r1, _mm256_mul_ps(cb, rb));
+		}
+
+		const __m256 all_l = _mm256_add_ps(sum_l0, sum_l1);
+		const __m256 all_r = _mm256_add_ps(sum_r0, sum_r1);
+
+		frame_store_sse2(_mm_add_ps(_mm256_castps256_ps128(all_l),
+					    _mm256_extractf128_ps(all_l, 1)),
+				 _mm_add_ps(_mm256_castps256_ps128(all_r),
+					    _mm256_extractf128_ps(all_r, 1)),
+				 &dst[n * 2]);
+	}
+}
+
+AVX2 static __m256i s32_avx2(const float *const src)
+{
+	const __m256 x =
+		_mm256_mul_ps(_mm256_loadu_ps(src), _mm256_set1_ps(32768.0F));
+
+	return _mm256_cvtps_epi32(
+		_mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-32768.0F)),
+			      _mm256_set1_ps(32767.0F)));
+}
+
+/// Converts 16 samples to signed 16-bit.
+AVX2 static __m256i s16_avx2(const float *const src)
+{
+	// Packing works within 128-bit lanes; put the quadwords back in order.
+	return _mm256_permute4x64_epi64(
+		_mm256_packs_epi32(s32_avx2(src), s32_avx2(&src[8])), 0xD8);
+}
+
+AVX2 static void to_s16_avx2(const float *const src, int16_t *const dst,
+			     const size_t num)
+{
+	size_t i = 0;
+
+	for (; (i + 16) <= num; i += 16) {
+		_mm256_storeu_si256((__m256i *)(void *)&dst[i],
+				    s16_avx2(&src[i]));
+	}
+
+	if (i < num) {
+		float in[16] = { 0.0F };
+		int16_t out[16];
+
+		memcpy(in, &src[i], (num - i) * sizeof(in[0]));
+		_mm256_storeu_si256((__m256i *)(void *)out, s16_avx2(in));
+		memcpy(&dst[i], out, (num - i) * sizeof(out[0]));
+	}
+}
+
+const struct resampler_kernels agoge_core_resampler_kernels_sse2 = {
+	.filter = &filter_sse2,
+	.to_s16 = &to_s16_sse2
+};
+
+const struct resampler_kernels agoge_core_resampler_kernels_avx2 = {
+	.filter = &filter_avx2,
+	.to_s16 = &to_s16_avx2
+};
+
+#endif // defined(__x86_64__) || defined(__i386__)
@@ -0,0 +1,320 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file resampler.c Defines the implementation of the audio resampler, its
+/// portable kernels, and selects the fastest kernels supported by the host.
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "agoge/audio.h"
+#include "comp.h"
+#include "resampler.h"
+
+#define PI (3.14159265F)
+
+/// The cutoff of the filter, as a fraction of the lower of the two Nyquist
+/// frequencies; 19.8 kHz at 44.1 kHz.
+#define CUTOFF (0.9F)
+
+/// The shape parameter of the Kaiser window; about 80 dB of stopband
+/// attenuation.
+#define KAISER_BETA (8.0F)
+
+/// The number of output frames filtered at once.
+#define CHUNK_SIZE (256)
+
+/// The number of input frames read from an audio buffer at once.
+#define READ_SIZE (512)
+
+/// The alignment of a resampler, so that the coefficients may be loaded
+/// aligned.
+#define ALIGN (64)
+
+static int16_t s16_clamp(const float x)
+{
+	const float v = x * 32768.0F;
+
+	if (v >= 32767.0F) {
+		return INT16_MAX;
+	}
+
+	if (v <= -32768.0F) {
+		return INT16_MIN;
+	}
+
+	const long ret = lrintf(v);
+
+	return (int16_t)ret;
+}
+
+static void filter_scalar(const struct agoge_core_resampler *const rs,
+			  uint64_t pos, const uint64_t step, float *const dst,
+			  const size_t num)
+{
+	for (size_t n = 0; n < num; ++n, pos += step) {
+		const float *const c0 = rs->coefs[RESAMPLER_PHASE(pos)];
+		const float *const c1 = rs->coefs[RESAMPLER_PHASE(pos) + 1];
+		const float *const l = &rs->in[0][pos >> 32];
+		const float *const r = &rs->in[1][pos >> 32];
+		const float t = RESAMPLER_PHASE_FRAC(pos);
+
+		float sum_l = 0.0F;
+		float sum_r = 0.0F;
+
+		for (size_t k = 0; k < RESAMPLER_TAPS; ++k) {
+			const float c = c0[k] + ((c1[k] - c0[k]) * t);
+
+			sum_l += c * l[k];
+			sum_r += c * r[k];
+		}
+		dst[n * 2] = sum_l;
+		dst[(n * 2) + 1] = sum_r;
+	}
+}
+
+static void to_s16_scalar(const float *const src, int16_t *const dst,
+			  const size_t num)
+{
+	for (size_t i = 0; i < num; ++i) {
+		dst[i] = s16_clamp(src[i]);
+	}
+}
+
+static const struct resampler_kernels kernels_scalar = {
+	.filter = &filter_scalar,
+	.to_s16 = &to_s16_scalar
+};
+
+static const struct resampler_kernels *kernels_get(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx2")) {
+		return &agoge_core_resampler_kernels_avx2;
+	}
+
+	if (__builtin_cpu_supports("sse2")) {
+		return &agoge_core_resampler_kernels_sse2;
+	}
+#endif // defined(__x86_64__) || defined(__i386__)
+
+	return &kernels_scalar;
+}
+
+/// Computes the modified Bessel function of the first kind of order zero.
+static float bessel_i0(const float x)
+{
+	const float q = (x * x) / 4.0F;
+	float term = 1.0F;
+	float sum = 1.0F;
+
+	for (unsigned int k = 1; k < 32; ++k) {
+		term *= q / (float)(k * k);
+		sum += term;
+	}
+	return sum;
+}
+
+/// Computes the coefficients of a Kaiser-windowed sinc low-pass filter for
+/// the given output rate. Every phase is normalized to unity gain at DC.
+static void coefs_fill(struct agoge_core_resampler *const rs,
+		       const unsigned int rate)
+{
+	const float ratio = (float)rate / (float)AGOGE_CORE_AUDIO_RATE;
+	const float fc = 0.5F * CUTOFF * ((ratio < 1.0F) ? ratio : 1.0F);
+	const float i0_beta = bessel_i0(KAISER_BETA);
+
+	for (unsigned int p = 0; p <= RESAMPLER_PHASES; ++p) {
+		float *const row = rs->coefs[p];
+		float sum = 0.0F;
+
+		for (unsigned int k = 0; k < RESAMPLER_TAPS; ++k) {
+			// The distance of the tap from the output frame, which
+			// lies between the two middle taps.
+			const float x = (float)k - ((RESAMPLER_TAPS / 2) - 1) -
+					((float)p / RESAMPLER_PHASES);
+			const float w = x / (RESAMPLER_TAPS / 2);
+			const float win =
+				bessel_i0(KAISER_BETA *
+					  sqrtf(fmaxf(0.0F, 1.0F - (w * w)))) /
+				i0_beta;
+			const float sinc = (fabsf(x) < 1e-6F) ?
+						   (2.0F * fc) :
+						   (sinf(2.0F * PI * fc * x) /
+						    (PI * x));
+
+			row[k] = sinc * win;
+			sum += row[k];
+		}
+
+		for (unsigned int k = 0; k < RESAMPLER_TAPS; ++k) {
+			row[k] /= sum;
+		}
+	}
+}
+
+struct agoge_core_resampler *
+agoge_core_resampler_create(const unsigned int rate,
+			    const enum agoge_core_resampler_format format)
+{
+	if (rate == 0) {
+		return NULL;
+	}
+
+	const size_t size = (sizeof(struct agoge_core_resampler) + ALIGN - 1) &
+			    ~(size_t)(ALIGN - 1);
+	struct agoge_core_resampler *const rs = aligned_alloc(ALIGN, size);
+
+	if (unlikely(rs == NULL)) {
+		return NULL;
+	}
+
+	memset(rs, 0, sizeof(*rs));
+	rs->format = format;
+	rs->step_nominal = ((uint64_t)AGOGE_CORE_AUDIO_RATE << 32) / rate;
+	rs->step = rs->step_nominal;
+	rs->kernels = kernels_get();
+	coefs_fill(rs, rate);
+
+	return rs;
+}
+
+void agoge_core_resampler_destroy(struct agoge_core_resampler *const rs)
+{
+	free(rs);
+}
+
+void agoge_core_resampler_reset(struct agoge_core_resampler *const rs)
+{
+	rs->in_len = 0;
+	rs->pos = 0;
+}
+
+void agoge_core_resampler_skew(struct agoge_core_resampler *const rs,
+			       float skew)
+{
+	if (skew < (1.0F - AGOGE_CORE_RESAMPLER_SKEW_MAX)) {
+		skew = 1.0F - AGOGE_CORE_RESAMPLER_SKEW_MAX;
+	} else if (skew > (1.0F + AGOGE_CORE_RESAMPLER_SKEW_MAX)) {
+		skew = 1.0F + AGOGE_CORE_RESAMPLER_SKEW_MAX;
+	}
+	rs->step = (uint64_t)((double)rs->step_nominal / (double)skew);
+}
+
+/// Retrieves the number of frames which can be written from a number of
+/// input frames.
+static size_t frames_ready(const struct agoge_core_resampler *const rs,
+			   const size_t in_len)
+{
+	if (in_len < RESAMPLER_TAPS) {
+		return 0;
+	}
+
+	// Every output frame starting before this position has all its taps.
+	const uint64_t end = (uint64_t)(in_len - RESAMPLER_TAPS + 1) << 32;
+
+	if (end <= rs->pos) {
+		return 0;
+	}
+	return (size_t)((end - rs->pos + rs->step - 1) / rs->step);
+}
+
+size_t agoge_core_resampler_avail(const struct agoge_core_resampler *const rs,
+				  const struct agoge_core_audio *const audio)
+{
+	return frames_ready(rs, rs->in_len + agoge_core_audio_avail(audio));
+}
+
+/// Drops the input frames no longer needed, and reads more from an audio
+/// buffer.
+///
+/// @returns The number of frames read.
+static size_t refill(struct agoge_core_resampler *const rs,
+		     struct agoge_core_audio *const audio)
+{
+	size_t used = (size_t)(rs->pos >> 32);
+
+	if (used > rs->in_len) {
+		used = rs->in_len;
+	}
+
+	for (unsigned int c = 0; c < 2; ++c) {
+		memmove(rs->in[c], &rs->in[c][used],
+			(rs->in_len - used) * sizeof(rs->in[c][0]));
+	}
+	rs->in_len -= used;
+	rs->pos -= (uint64_t)used << 32;
+
+	const size_t space = RESAMPLER_IN_SIZE - rs->in_len;
+	int16_t buf[READ_SIZE * 2];
+	const size_t num = agoge_core_audio_read(
+		audio, buf, (space < READ_SIZE) ? space : READ_SIZE);
+
+	for (size_t i = 0; i < num; ++i) {
+		rs->in[0][rs->in_len + i] = (float)buf[i * 2] / 32768.0F;
+		rs->in[1][rs->in_len + i] = (float)buf[(i * 2) + 1] / 32768.0F;
+	}
+	rs->in_len += num;
+
+	return num;
+}
+
+size_t agoge_core_resampler_run(struct agoge_core_resampler *const rs,
+				struct agoge_core_audio *const audio,
+				void *const dst, const size_t max_frames)
+{
+	size_t done = 0;
+
+	while (done < max_frames) {
+		size_t num = frames_ready(rs, rs->in_len);
+
+		if (num == 0) {
+			if (refill(rs, audio) == 0) {
+				break;
+			}
+			continue;
+		}
+
+		if (num > (max_frames - done)) {
+			num = max_frames - done;
+		}
+
+		if (num > CHUNK_SIZE) {
+			num = CHUNK_SIZE;
+		}
+
+		if (rs->format == AGOGE_CORE_RESAMPLER_FORMAT_F32) {
+			rs->kernels->filter(rs, rs->pos, rs->step,
+					    &((float *)dst)[done * 2], num);
+		} else {
+			float buf[CHUNK_SIZE * 2];
+
+			rs->kernels->filter(rs, rs->pos, rs->step, buf, num);
+			rs->kernels->to_s16(buf, &((int16_t *)dst)[done * 2],
+					    num * 2);
+		}
+		rs->pos += num * rs->step;
+		done += num;
+	}
+	return done;
+}
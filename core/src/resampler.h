@@ -0,0 +1,91 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file resampler.h Defines the internal interface of the audio resampler.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "agoge/resampler.h"
+
+/// The number of taps of the filter.
+#define RESAMPLER_TAPS (64)
+
+/// The number of phases of the filter, as a power of two.
+#define RESAMPLER_PHASE_BITS (7)
+#define RESAMPLER_PHASES (1 << RESAMPLER_PHASE_BITS)
+
+/// Retrieves the phase of a position.
+#define RESAMPLER_PHASE(pos) ((uint32_t)(pos) >> (32 - RESAMPLER_PHASE_BITS))
+
+/// Retrieves the weight of the next phase at a position, from 0 to 1.
+#define RESAMPLER_PHASE_FRAC(pos)                                  \
+	((float)(((uint32_t)(pos) << RESAMPLER_PHASE_BITS) >> 8) * \
+	 (1.0F / 16777216.0F))
+
+/// The number of input frames a resampler holds.
+#define RESAMPLER_IN_SIZE (2048)
+
+/// Defines a resampler.
+struct agoge_core_resampler {
+	/// The coefficients of every phase, and of the first phase shifted by
+	/// one tap, so that any phase may be interpolated with the next.
+	float coefs[RESAMPLER_PHASES + 1][RESAMPLER_TAPS];
+
+	/// The input frames, left and right apart.
+	float in[2][RESAMPLER_IN_SIZE];
+
+	/// The number of input frames held.
+	size_t in_len;
+
+	/// The position of the next output frame in the input, in 32.32 fixed
+	/// point; the frame filters the taps starting at its integer part.
+	uint64_t pos;
+
+	/// The distance between two output frames in the input at the nominal
+	/// ratio, and with the skew applied, in 32.32 fixed point.
+	uint64_t step_nominal;
+	uint64_t step;
+
+	enum agoge_core_resampler_format format;
+
+	/// The kernels used to filter frames.
+	const struct resampler_kernels *kernels;
+};
+
+/// Defines a set of resampler kernels implemented for a given instruction
+/// set.
+struct resampler_kernels {
+	/// Filters `num` output frames, starting at the position `pos` and
+	/// advancing by `step`, into `dst`; two samples per frame, left then
+	/// right. Every tap of every frame must be held.
+	void (*filter)(const struct agoge_core_resampler *rs, uint64_t pos,
+		       uint64_t step, float *dst, size_t num);
+
+	/// Converts `num` samples to signed 16-bit, with saturation.
+	void (*to_s16)(const float *src, int16_t *dst, size_t num);
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+extern const struct resampler_kernels agoge_core_resampler_kernels_sse2;
+extern const struct resampler_kernels agoge_core_resampler_kernels_avx2;
+#endif // defined(__x86_64__) || defined(__i386__)
@@ -0,0 +1,252 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file search-x86.c Defines the SSE2 and AVX2 memory search kernels.
+///
+/// Each candidate is compared against the previous snapshot with unsigned
+/// byte comparisons; 16-bit values combine the comparisons of two adjacent
+/// bytes, and packed BCD sorts like its binary encoding once validated.
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#include "search.h"
+
+#define SSE2 __attribute__((target("sse2")))
+#define AVX2 __attribute__((target("avx2")))
+
+SSE2 static __m128i gt_u8_sse2(const __m128i a, const __m128i b)
+{
+	const __m128i bias = _mm_set1_epi8((char)0x80);
+	return _mm_cmpgt_epi8(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+}
+
+SSE2 static __m128i bcd_invalid_sse2(const __m128i x)
+{
+	const __m128i nibble = _mm_set1_epi8(0x0F);
+	const __m128i nine = _mm_set1_epi8(9);
+
+	const __m128i lo = _mm_and_si128(x, nibble);
+	const __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), nibble);
+
+	return _mm_or_si128(_mm_cmpgt_epi8(lo, nine), _mm_cmpgt_epi8(hi, nine));
+}
+
+SSE2 static __m128i match_sse2(const uint8_t *const cur,
+			       const uint8_t *const prev,
+			       const struct search_filter *const filter)
+{
+	const __m128i ones = _mm_set1_epi8(-1);
+	const __m128i a0 = _mm_loadu_si128((const __m128i *)cur);
+	const __m128i b0 = _mm_loadu_si128((const __m128i *)prev);
+
+	__m128i eq = _mm_cmpeq_epi8(a0, b0);
+	__m128i gt = gt_u8_sse2(a0, b0);
+	__m128i lt = gt_u8_sse2(b0, a0);
+	__m128i val = _mm_cmpeq_epi8(a0, _mm_set1_epi8((char)filter->value));
+	__m128i valid = ones;
+
+	switch (filter->type) {
+	case AGOGE_CORE_SEARCH_TYPE_U16: {
+		const __m128i a1 = _mm_loadu_si128((const __m128i *)&cur[1]);
+		const __m128i b1 = _mm_loadu_si128((const __m128i *)&prev[1]);
+		const __m128i eq1 = _mm_cmpeq_epi8(a1, b1);
+
+		gt = _mm_or_si128(gt_u8_sse2(a1, b1), _mm_and_si128(eq1, gt));
+		lt = _mm_or_si128(gt_u8_sse2(b1, a1), _mm_and_si128(eq1, lt));
+		eq = _mm_and_si128(eq, eq1);
+		val = _mm_and_si128(
+			val, _mm_cmpeq_epi8(a1, _mm_set1_epi8((char)(
+							filter->value >> 8))));
+		break;
+	}
+
+	case AGOGE_CORE_SEARCH_TYPE_BCD:
+		valid = _mm_andnot_si128(bcd_invalid_sse2(a0), valid);
+
+		if (filter->cmp != AGOGE_CORE_SEARCH_CMP_VALUE) {
+			valid = _mm_andnot_si128(bcd_invalid_sse2(b0), valid);
+		}
+		break;
+
+	case AGOGE_CORE_SEARCH_TYPE_U8:
+	default:
+		break;
+	}
+
+	switch (filter->cmp) {
+	case AGOGE_CORE_SEARCH_CMP_EQUAL:
+		return _mm_and_si128(eq, valid);
+
+	case AGOGE_CORE_SEARCH_CMP_CHANGED:
+		return _mm_andnot_si128(eq, valid);
+
+	case AGOGE_CORE_SEARCH_CMP_INCREASED:
+		return _mm_and_si128(gt, valid);
+
+	case AGOGE_CORE_SEARCH_CMP_DECREASED:
+		return _mm_and_si128(lt, valid);
+
+	case AGOGE_CORE_SEARCH_CMP_VALUE:
+	default:
+		return _mm_and_si128(val, valid);
+	}
+}
+
+SSE2 static void filter_sse2(const struct search_filter *const filter)
+{
+	for (size_t blk = 0; blk < filter->num_blocks; ++blk) {
+		const uint64_t mask = filter->candidates[blk];
+
+		if (mask == 0) {
+			continue;
+		}
+
+		uint64_t match = 0;
+
+		for (size_t i = 0; i < SEARCH_BLOCK_SIZE; i += 16) {
+			const size_t off = (blk * SEARCH_BLOCK_SIZE) + i;
+			const __m128i res = match_sse2(&filter->cur[off],
+						       &filter->prev[off], filter);
+
+			match |= (uint64_t)(uint16_t)_mm_movemask_epi8(res) << i;
+		}
+		filter->candidates[blk] = mask & match;
+	}
+}
+
+AVX2 static __m256i gt_u8_avx2(const __m256i a, const __m256i b)
+{
+	const __m256i bias = _mm256_set1_epi8((char)0x80);
+	return _mm256_cmpgt_epi8(_mm256_xor_si256(a, bias),
+				 _mm256_xor_si256(b, bias));
+}
+
+AVX2 static __m256i bcd_invalid_avx2(const __m256i x)
+{
+	const __m256i nibble = _mm256_set1_epi8(0x0F);
+	const __m256i nine = _mm256_set1_epi8(9);
+
+	const __m256i lo = _mm256_and_si256(x, nibble);
+	const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble);
+
+	return _mm256_or_si256(_mm256_cmpgt_epi8(lo, nine),
+			       _mm256_cmpgt_epi8(hi, nine));
+}
+
+AVX2 static __m256i match_avx2(const uint8_t *const cur,
+			       const uint8_t *const prev,
+			       const struct search_filter *const filter)
+{
+	const __m256i ones = _mm256_set1_epi8(-1);
+	const __m256i a0 = _mm256_loadu_si256((const __m256i *)cur);
+	const __m256i b0 = _mm256_loadu_si256((const __m256i *)prev);
+
+	__m256i eq = _mm256_cmpeq_epi8(a0, b0);
+	__m256i gt = gt_u8_avx2(a0, b0);
+	__m256i lt = gt_u8_avx2(b0, a0);
+	__m256i val =
+		_mm256_cmpeq_epi8(a0, _mm256_set1_epi8((char)filter->value));
+	__m256i valid = ones;
+
+	switch (filter->type) {
+	case AGOGE_CORE_SEARCH_TYPE_U16: {
+		const __m256i a1 = _mm256_loadu_si256((const __m256i *)&cur[1]);
+		const __m256i b1 =
+			_mm256_loadu_si256((const __m256i *)&prev[1]);
+		const __m256i eq1 = _mm256_cmpeq_epi8(a1, b1);
+
+		gt = _mm256_or_si256(gt_u8_avx2(a1, b1),
+				     _mm256_and_si256(eq1, gt));
+		lt = _mm256_or_si256(gt_u8_avx2(b1, a1),
+				     _mm256_and_si256(eq1, lt));
+		eq = _mm256_and_si256(eq, eq1);
+		val = _mm256_and_si256(
+			val, _mm256_cmpeq_epi8(a1, _mm256_set1_epi8((char)(
+							   filter->value >> 8))));
+		break;
+	}
+
+	case AGOGE_CORE_SEARCH_TYPE_BCD:
+		valid = _mm256_andnot_si256(bcd_invalid_avx2(a0), valid);
+
+		if (filter->cmp != AGOGE_CORE_SEARCH_CMP_VALUE) {
+			valid = _mm256_andnot_si256(bcd_invalid_avx2(b0),
+						    valid);
+		}
+		break;
+
+	case AGOGE_CORE_SEARCH_TYPE_U8:
+	default:
+		break;
+	}
+
+	switch (filter->cmp) {
+	case AGOGE_CORE_SEARCH_CMP_EQUAL:
+		return _mm256_and_si256(eq, valid);
+
+	case AGOGE_CORE_SEARCH_CMP_CHANGED:
+		return _mm256_andnot_si256(eq, valid);
+
+	case AGOGE_CORE_SEARCH_CMP_INCREASED:
+		return _mm256_and_si256(gt, valid);
+
+	case AGOGE_CORE_SEARCH_CMP_DECREASED:
+		return _mm256_and_si256(lt, valid);
+
+	case AGOGE_CORE_SEARCH_CMP_VALUE:
+	default:
+		return _mm256_and_si256(val, valid);
+	}
+}
+
+AVX2 static void filter_avx2(const struct search_filter *const filter)
+{
+	for (size_t blk = 0; blk < filter->num_blocks; ++blk) {
+		const uint64_t mask = filter->candidates[blk];
+
+		if (mask == 0) {
+			continue;
+		}
+
+		uint64_t match = 0;
+
+		for (size_t i = 0; i < SEARCH_BLOCK_SIZE; i += 32) {
+			const size_t off = (blk * SEARCH_BLOCK_SIZE) + i;
+			const __m256i res = match_avx2(&filter->cur[off],
+						       &filter->prev[off], filter);
+
+			match |= (uint64_t)(uint32_t)_mm256_movemask_epi8(res)
+				 << i;
+		}
+		filter->candidates[blk] = mask & match;
+	}
+}
+
+const struct search_kernels agoge_core_search_kernels_sse2 = {
+	.filter = &filter_sse2
+};
+
+const struct search_kernels agoge_core_search_kernels_avx2 = {
+	.filter = &filter_avx2
+};
+
+#endif // defined(__x86_64__) || defined(__i386__)
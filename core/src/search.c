@@ -0,0 +1,337 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file search.c Defines the memory search engine, and the portable
+/// implementation of its kernels.
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "agoge/bus.h"
+#include "comp.h"
+#include "ctx.h"
+#include "search.h"
+
+/// The largest amount of cartridge RAM searched in bytes; only the bank mapped
+/// at $A000-$BFFF is searched.
+#define CART_RAM_SIZE_MAX (8192)
+
+/// The number of blocks covering every searched byte.
+#define NUM_BLOCKS                                                        \
+	((AGOGE_CORE_BUS_WRAM_SIZE + AGOGE_CORE_BUS_HRAM_SIZE +           \
+	  CART_RAM_SIZE_MAX + (SEARCH_BLOCK_SIZE - 1)) /                  \
+	 SEARCH_BLOCK_SIZE)
+
+/// The size of a snapshot in bytes. The extra block keeps 16-bit loads past
+/// the last candidate in bounds.
+#define SNAPSHOT_SIZE ((NUM_BLOCKS + 1) * SEARCH_BLOCK_SIZE)
+
+/// The searched memory regions, in snapshot and address order.
+static const enum agoge_core_bus_region regions[] = {
+	AGOGE_CORE_BUS_REGION_CART_RAM,
+	AGOGE_CORE_BUS_REGION_WRAM,
+	AGOGE_CORE_BUS_REGION_HRAM
+};
+
+#define NUM_REGIONS (sizeof(regions) / sizeof(regions[0]))
+
+struct agoge_core_search {
+	/// The snapshots; `snapshots[cur]` is the most recent one.
+	_Alignas(64) uint8_t snapshots[2][SNAPSHOT_SIZE];
+
+	/// The candidate bitmap; bit `n` of word `n / 64` is set if the byte at
+	/// offset `n` of a snapshot is a candidate.
+	uint64_t candidates[NUM_BLOCKS];
+
+	/// The view of each region taken by the last snapshot.
+	struct agoge_core_bus_span spans[NUM_REGIONS];
+
+	/// The offset of each region within a snapshot.
+	size_t offsets[NUM_REGIONS];
+
+	/// The index of the most recent snapshot.
+	unsigned int cur;
+};
+
+NODISCARD static bool match_scalar(const uint8_t *const cur,
+				   const uint8_t *const prev,
+				   const enum agoge_core_search_type type,
+				   const enum agoge_core_search_cmp cmp,
+				   const uint16_t value)
+{
+	unsigned int a = cur[0];
+	unsigned int b = prev[0];
+
+	switch (type) {
+	case AGOGE_CORE_SEARCH_TYPE_U16:
+		a |= cur[1] << 8;
+		b |= prev[1] << 8;
+		break;
+
+	case AGOGE_CORE_SEARCH_TYPE_BCD:
+		// Valid packed BCD sorts like its binary encoding.
+		if (((a & 0x0F) > 9) || ((a >> 4) > 9)) {
+			return false;
+		}
+
+		if ((cmp != AGOGE_CORE_SEARCH_CMP_VALUE) &&
+		    (((b & 0x0F) > 9) || ((b >> 4) > 9))) {
+			return false;
+		}
+		break;
+
+	case AGOGE_CORE_SEARCH_TYPE_U8:
+	default:
+		break;
+	}
+
+	switch (cmp) {
+	case AGOGE_CORE_SEARCH_CMP_EQUAL:
+		return a == b;
+
+	case AGOGE_CORE_SEARCH_CMP_CHANGED:
+		return a != b;
+
+	case AGOGE_CORE_SEARCH_CMP_INCREASED:
+		return a > b;
+
+	case AGOGE_CORE_SEARCH_CMP_DECREASED:
+		return a < b;
+
+	case AGOGE_CORE_SEARCH_CMP_VALUE:
+	default:
+		return a == value;
+	}
+}
+
+static void filter_scalar(const struct search_filter *const filter)
+{
+	for (size_t blk = 0; blk < filter->num_blocks; ++blk) {
+		uint64_t mask = filter->candidates[blk];
+
+		for (uint64_t bits = mask; bits != 0; bits &= bits - 1) {
+			const size_t i = (blk * SEARCH_BLOCK_SIZE) +
+					 (size_t)__builtin_ctzll(bits);
+
+			if (!match_scalar(&filter->cur[i], &filter->prev[i],
+					  filter->type, filter->cmp,
+					  filter->value)) {
+				mask &= ~(UINT64_C(1) << (i % SEARCH_BLOCK_SIZE));
+			}
+		}
+		filter->candidates[blk] = mask;
+	}
+}
+
+static const struct search_kernels kernels_scalar = {
+	.filter = &filter_scalar
+};
+
+static const struct search_kernels *kernels_get(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx2")) {
+		return &agoge_core_search_kernels_avx2;
+	}
+
+	if (__builtin_cpu_supports("sse2")) {
+		return &agoge_core_search_kernels_sse2;
+	}
+#endif // defined(__x86_64__) || defined(__i386__)
+
+	return &kernels_scalar;
+}
+
+/// Sets or clears the candidate bits of `size` bytes starting at `offset`.
+static void candidates_set(struct agoge_core_search *const search,
+			   const size_t offset, const size_t size,
+			   const bool set)
+{
+	for (size_t i = offset; i < (offset + size); ++i) {
+		const uint64_t bit = UINT64_C(1) << (i % SEARCH_BLOCK_SIZE);
+
+		if (set) {
+			search->candidates[i / SEARCH_BLOCK_SIZE] |= bit;
+		} else {
+			search->candidates[i / SEARCH_BLOCK_SIZE] &= ~bit;
+		}
+	}
+}
+
+/// Takes a snapshot of the searched memory into the snapshot not holding the
+/// most recent one, and makes it the most recent one.
+static void snapshot_take(struct agoge_core_search *const search,
+			  const struct agoge_core_ctx *const ctx)
+{
+	search->cur ^= 1;
+	uint8_t *const dst = search->snapshots[search->cur];
+
+	for (size_t i = 0; i < NUM_REGIONS; ++i) {
+		const struct agoge_core_bus_span span =
+			agoge_core_bus_view(ctx, regions[i], 0);
+		size_t size = span.size;
+
+		if ((regions[i] == AGOGE_CORE_BUS_REGION_CART_RAM) &&
+		    (size > CART_RAM_SIZE_MAX)) {
+			size = CART_RAM_SIZE_MAX;
+		}
+
+		// Cartridge RAM which disappeared since the last snapshot
+		// stops being searched.
+		if (size < search->spans[i].size) {
+			candidates_set(search, search->offsets[i] + size,
+				       search->spans[i].size - size, false);
+		}
+
+		if (size != 0) {
+			memcpy(&dst[search->offsets[i]], span.data, size);
+		}
+		search->spans[i] = span;
+		search->spans[i].size = size;
+	}
+}
+
+struct agoge_core_search *agoge_core_search_create(void)
+{
+	struct agoge_core_search *const search =
+		aligned_alloc(64, sizeof(*search));
+
+	if (search == NULL) {
+		return NULL;
+	}
+
+	memset(search, 0, sizeof(*search));
+
+	search->offsets[0] = 0;
+	search->offsets[1] = CART_RAM_SIZE_MAX;
+	search->offsets[2] = CART_RAM_SIZE_MAX + AGOGE_CORE_BUS_WRAM_SIZE;
+
+	return search;
+}
+
+void agoge_core_search_destroy(struct agoge_core_search *const search)
+{
+	free(search);
+}
+
+void agoge_core_search_reset(struct agoge_core_search *const search,
+			     const struct agoge_core_ctx *const ctx)
+{
+	memset(search->candidates, 0, sizeof(search->candidates));
+	memset(search->spans, 0, sizeof(search->spans));
+
+	snapshot_take(search, ctx);
+
+	for (size_t i = 0; i < NUM_REGIONS; ++i) {
+		candidates_set(search, search->offsets[i], search->spans[i].size,
+			       true);
+	}
+}
+
+size_t agoge_core_search_filter(struct agoge_core_search *const search,
+				const struct agoge_core_ctx *const ctx,
+				const enum agoge_core_search_type type,
+				const enum agoge_core_search_cmp cmp,
+				unsigned int value)
+{
+	snapshot_take(search, ctx);
+
+	if (cmp == AGOGE_CORE_SEARCH_CMP_VALUE) {
+		const unsigned int max =
+			(type == AGOGE_CORE_SEARCH_TYPE_U8)  ? 0xFF :
+			(type == AGOGE_CORE_SEARCH_TYPE_U16) ? 0xFFFF :
+							       99;
+
+		if (value > max) {
+			memset(search->candidates, 0,
+			       sizeof(search->candidates));
+			return 0;
+		}
+
+		if (type == AGOGE_CORE_SEARCH_TYPE_BCD) {
+			value = ((value / 10) << 4) | (value % 10);
+		}
+	}
+
+	// A 16-bit value cannot start at the last byte of a region.
+	if (type == AGOGE_CORE_SEARCH_TYPE_U16) {
+		for (size_t i = 0; i < NUM_REGIONS; ++i) {
+			if (search->spans[i].size != 0) {
+				candidates_set(search,
+					       search->offsets[i] +
+						       search->spans[i].size - 1,
+					       1, false);
+			}
+		}
+	}
+
+	const struct search_filter filter = {
+		.cur = search->snapshots[search->cur],
+		.prev = search->snapshots[search->cur ^ 1],
+		.candidates = search->candidates,
+		.num_blocks = NUM_BLOCKS,
+		.type = type,
+		.cmp = cmp,
+		.value = (uint16_t)value
+	};
+
+	kernels_get()->filter(&filter);
+	return agoge_core_search_count(search);
+}
+
+PURE size_t
+agoge_core_search_count(const struct agoge_core_search *const search)
+{
+	size_t count = 0;
+
+	for (size_t blk = 0; blk < NUM_BLOCKS; ++blk) {
+		count += (size_t)__builtin_popcountll(search->candidates[blk]);
+	}
+	return count;
+}
+
+size_t agoge_core_search_results(const struct agoge_core_search *const search,
+				 uint16_t *const addrs, const size_t max_addrs)
+{
+	size_t num_addrs = 0;
+
+	for (size_t i = 0; i < NUM_REGIONS; ++i) {
+		const size_t offset = search->offsets[i];
+
+		for (size_t n = 0; n < search->spans[i].size; ++n) {
+			const size_t bit = offset + n;
+
+			if (!(search->candidates[bit / SEARCH_BLOCK_SIZE] &
+			      (UINT64_C(1) << (bit % SEARCH_BLOCK_SIZE)))) {
+				continue;
+			}
+
+			if (num_addrs == max_addrs) {
+				return num_addrs;
+			}
+			addrs[num_addrs++] =
+				(uint16_t)(search->spans[i].addr + n);
+		}
+	}
+	return num_addrs;
+}
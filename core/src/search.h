@@ -0,0 +1,63 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "agoge/search.h"
+
+/// The number of candidates covered by a single word of the bitmap.
+#define SEARCH_BLOCK_SIZE (64)
+
+/// Defines the arguments of a filter pass.
+struct search_filter {
+	/// The current snapshot. At least one byte past the last block must be
+	/// readable.
+	const uint8_t *cur;
+
+	/// The previous snapshot, laid out as `cur`.
+	const uint8_t *prev;
+
+	/// The candidate bitmap; one word per block.
+	uint64_t *candidates;
+
+	/// The number of blocks to filter.
+	size_t num_blocks;
+
+	enum agoge_core_search_type type;
+	enum agoge_core_search_cmp cmp;
+
+	/// The value to compare to, already encoded for `type`.
+	uint16_t value;
+};
+
+/// Defines a set of memory search kernels implemented for a given instruction
+/// set.
+struct search_kernels {
+	/// Clears every candidate not matching a filter.
+	void (*filter)(const struct search_filter *filter);
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+extern const struct search_kernels agoge_core_search_kernels_sse2;
+extern const struct search_kernels agoge_core_search_kernels_avx2;
+#endif // defined(__x86_64__) || defined(__i386__)
@@ -0,0 +1,145 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file video.c Defines the implementation of video output.
+
+#include <string.h>
+
+#include "frame.h"
+#include "ppu-defs.h"
+#include "ppu.h"
+#include "video.h"
+
+/// The shades of gray used when no palette is given.
+static const uint8_t palette_gray[4][3] = { { 0xFF, 0xFF, 0xFF },
+					    { 0xAA, 0xAA, 0xAA },
+					    { 0x55, 0x55, 0x55 },
+					    { 0x00, 0x00, 0x00 } };
+
+/// Converts a row of shades into a row of the destination buffer.
+static void row_convert(const struct agoge_core_video *const video,
+			const struct frame_kernels *const kernels,
+			const uint8_t *const src, const unsigned int y)
+{
+	uint8_t *const dst = (uint8_t *)video->buf + (y * video->stride);
+
+	switch (video->format) {
+	case AGOGE_CORE_VIDEO_FORMAT_RGBA8888:
+	case AGOGE_CORE_VIDEO_FORMAT_BGRA8888:
+		kernels->rgba8888_row(src, video->lut.rgba8888,
+				      (uint32_t *)dst);
+		break;
+
+	case AGOGE_CORE_VIDEO_FORMAT_RGB565:
+		kernels->rgb565_row(src, video->lut.rgb565, (uint16_t *)dst);
+		break;
+
+	case AGOGE_CORE_VIDEO_FORMAT_INDEX8:
+	default:
+		kernels->luma_row(src, video->lut.index8, dst);
+		break;
+	}
+}
+
+void agoge_core_video_set(struct agoge_core_video *const video,
+			  void *const buf, const size_t stride,
+			  const enum agoge_core_video_format format,
+			  const uint8_t palette[4][3],
+			  const agoge_core_video_frame_cb frame_cb,
+			  void *const udata)
+{
+	const uint8_t(*const pal)[3] = (palette != NULL) ? palette :
+							   palette_gray;
+
+	video->buf = buf;
+	video->stride = stride;
+	video->format = (uint8_t)format;
+	video->frame_cb = frame_cb;
+	video->udata = udata;
+
+	for (unsigned int i = 0; i < 4; ++i) {
+		const uint8_t r = pal[i][0];
+		const uint8_t g = pal[i][1];
+		const uint8_t b = pal[i][2];
+
+		switch (format) {
+		case AGOGE_CORE_VIDEO_FORMAT_RGBA8888: {
+			const uint8_t px[4] = { r, g, b, 0xFF };
+
+			memcpy(&video->lut.rgba8888[i], px, sizeof(px));
+			break;
+		}
+
+		case AGOGE_CORE_VIDEO_FORMAT_BGRA8888: {
+			const uint8_t px[4] = { b, g, r, 0xFF };
+
+			memcpy(&video->lut.rgba8888[i], px, sizeof(px));
+			break;
+		}
+
+		case AGOGE_CORE_VIDEO_FORMAT_RGB565:
+			video->lut.rgb565[i] = (uint16_t)(((r >> 3) << 11) |
+							  ((g >> 2) << 5) |
+							  (b >> 3));
+			break;
+
+		case AGOGE_CORE_VIDEO_FORMAT_INDEX8:
+		default:
+			video->lut.index8[i] = (uint8_t)i;
+			break;
+		}
+	}
+}
+
+void agoge_core_video_line(struct agoge_core_ctx *const ctx)
+{
+	const struct agoge_core_ppu *const ppu = &ctx->ppu;
+
+	if (ppu->video.buf == NULL) {
+		return;
+	}
+
+	row_convert(&ppu->video, ppu->kernels->frame,
+		    &ppu->frame[ppu->ly * WIDTH], ppu->ly);
+}
+
+void agoge_core_video_blank(struct agoge_core_ctx *const ctx)
+{
+	const struct agoge_core_ppu *const ppu = &ctx->ppu;
+	const uint8_t blank[WIDTH] = { 0 };
+
+	if (ppu->video.buf == NULL) {
+		return;
+	}
+
+	for (unsigned int y = 0; y < AGOGE_CORE_FRAME_HEIGHT; ++y) {
+		row_convert(&ppu->video, ppu->kernels->frame, blank, y);
+	}
+}
+
+void agoge_core_video_frame_end(struct agoge_core_ctx *const ctx)
+{
+	struct agoge_core_video *const video = &ctx->ppu.video;
+
+	if ((video->buf == NULL) || (video->frame_cb == NULL)) {
+		return;
+	}
+	video->buf = video->frame_cb(video->udata, video->buf);
+}
@@ -0,0 +1,37 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file video.h Defines the internal interface of video output.
+
+#pragma once
+
+#include "agoge/video.h"
+#include "ctx.h"
+
+/// Converts the current line of the frame into the destination buffer, if
+/// any.
+void agoge_core_video_line(struct agoge_core_ctx *ctx);
+
+/// Fills the destination buffer, if any, with shade 0.
+void agoge_core_video_blank(struct agoge_core_ctx *ctx);
+
+/// Hands the complete frame to the frame-complete callback, if any, and
+/// switches to the buffer it returns.
+void agoge_core_video_frame_end(struct agoge_core_ctx *ctx);
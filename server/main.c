@@ -0,0 +1,951 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file main.c Defines `agoge_server`, which runs many emulator instances in
+/// one process on behalf of clients connected to a Unix domain socket.
+///
+/// The main thread multiplexes every client with `poll`. Each round, it
+/// gathers at most one complete request per client, runs instance creation and
+/// destruction itself, runs every other request across the thread pool, and
+/// writes back the responses. Two requests for the same instance never run in
+/// the same round, and a step which runs over several rounds keeps its
+/// instance to itself until it completes. Responses are queued per client and
+/// written as the sockets drain, so a client which stops reading holds up no
+/// one else.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "agoge/cart.h"
+#include "agoge/ctx.h"
+#include "agoge/delta.h"
+#include "agoge/pool.h"
+#include "protocol.h"
+
+#define INSTANCES_MAX_DEFAULT (4096)
+#define LISTEN_BACKLOG (128)
+
+/// The largest number of frames a `AGOGE_SERVER_CMD_STEP` request runs per
+/// round; the rest run in the next rounds, so that long steps do not hold up
+/// the requests of other clients.
+#define STEP_FRAMES_ROUND (60)
+
+/// Defines an emulator instance.
+struct instance {
+	/// The emulator context, or `NULL` if the instance does not exist.
+	struct agoge_core_ctx *ctx;
+
+	/// The ROM loaded into the context, or `NULL` if none is.
+	uint8_t *rom;
+
+	/// The size of `rom` in bytes.
+	size_t rom_size;
+
+	/// The number of instances created before this one; unlike `id`, never
+	/// reused.
+	uint64_t serial;
+
+	/// The client whose `AGOGE_SERVER_CMD_STEP` request runs on this instance
+	/// over several rounds, or `NULL` if none does. Requests of other
+	/// clients for this instance are deferred until it completes.
+	struct client *owner;
+
+	/// Set if a request for this instance runs in the current round.
+	bool claimed;
+};
+
+/// Defines the `AGOGE_SERVER_CMD_GET_FRAME_DELTA` encoder of a client for an
+/// instance. Each client has its own, as a delta is only valid against the
+/// frames which the same client received.
+struct delta_slot {
+	/// The serial of the instance.
+	uint64_t serial;
+
+	struct agoge_core_delta delta;
+};
+
+/// Defines a decoded request header.
+struct req {
+	enum agoge_server_cmd cmd;
+	uint32_t id;
+	uint32_t arg0;
+	uint32_t arg1;
+	uint32_t payload_size;
+};
+
+/// Defines a connected client.
+struct client {
+	int fd;
+
+	/// The request header being received.
+	uint8_t hdr[AGOGE_SERVER_REQ_SIZE];
+
+	/// The number of bytes of `hdr` received.
+	size_t hdr_len;
+
+	/// The decoded request header; valid once `hdr` is complete.
+	struct req req;
+
+	/// The request payload; `payload_cap` bytes.
+	uint8_t *payload;
+	size_t payload_cap;
+
+	/// The number of bytes of payload received.
+	size_t payload_len;
+
+	/// Set once a complete request has been received.
+	bool ready;
+
+	/// Set if the request is handled in the current round.
+	bool handled;
+
+	/// Set if the request has more to run in the next rounds before it is
+	/// responded to.
+	bool partial;
+
+	/// The status of the response.
+	enum agoge_server_status status;
+
+	/// The response payload; `out_cap` bytes.
+	uint8_t *out;
+	size_t out_cap;
+
+	/// The size of the response payload in bytes.
+	size_t out_size;
+
+	/// The response header.
+	uint8_t resp[AGOGE_SERVER_RESP_SIZE];
+
+	/// The delta encoders of the instances whose frame deltas the client
+	/// requested; `num_deltas` entries.
+	struct delta_slot *deltas;
+	size_t num_deltas;
+
+	/// The number of bytes of the response, header then payload, sent; the
+	/// response is queued while it is less than the size of both. No other
+	/// request of the client is handled until its response is sent.
+	size_t sent;
+	bool sending;
+};
+
+static struct {
+	struct agoge_pool *pool;
+	int listen_fd;
+
+	struct instance *instances;
+	size_t num_instances;
+
+	/// The number of instances created so far.
+	uint64_t num_created;
+
+	/// The connected clients; `clients_cap` entries.
+	struct client **clients;
+	size_t num_clients;
+	size_t clients_cap;
+
+	/// The clients whose requests run in the thread pool in the current
+	/// round; `clients_cap` entries.
+	struct client **tasks;
+	size_t num_tasks;
+
+	/// The descriptors polled each round, the listening socket then every
+	/// client; `clients_cap + 1` entries.
+	struct pollfd *pfds;
+} server;
+
+static volatile sig_atomic_t quit;
+
+static void signal_handler(const int sig)
+{
+	(void)sig;
+	quit = 1;
+}
+
+static uint32_t le32_get(const uint8_t *const src)
+{
+	return (uint32_t)src[0] | ((uint32_t)src[1] << 8) |
+	       ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+static void le32_put(uint8_t *const dst, const uint32_t val)
+{
+	dst[0] = (uint8_t)val;
+	dst[1] = (uint8_t)(val >> 8);
+	dst[2] = (uint8_t)(val >> 16);
+	dst[3] = (uint8_t)(val >> 24);
+}
+
+/// Grows a buffer to hold at least `size` bytes.
+static bool buf_reserve(uint8_t **const buf, size_t *const cap,
+			const size_t size)
+{
+	if (size <= *cap) {
+		return true;
+	}
+
+	uint8_t *const new_buf = realloc(*buf, size);
+
+	if (new_buf == NULL) {
+		return false;
+	}
+
+	*buf = new_buf;
+	*cap = size;
+
+	return true;
+}
+
+/// Prepares the response payload of a client.
+///
+/// @returns The response payload, or `NULL` if memory could not be
+/// allocated.
+static uint8_t *out_reserve(struct client *const client, const size_t size)
+{
+	if (!buf_reserve(&client->out, &client->out_cap, size)) {
+		client->status = AGOGE_SERVER_STATUS_NO_MEM;
+		return NULL;
+	}
+
+	client->out_size = size;
+	return client->out;
+}
+
+static struct instance *instance_get(const uint32_t id)
+{
+	if ((id >= server.num_instances) ||
+	    (server.instances[id].ctx == NULL)) {
+		return NULL;
+	}
+	return &server.instances[id];
+}
+
+static void instance_destroy(struct instance *const inst)
+{
+	agoge_core_ctx_destroy(inst->ctx);
+	free(inst->rom);
+
+	memset(inst, 0, sizeof(*inst));
+}
+
+static void cmd_create(struct client *const client)
+{
+	for (size_t id = 0; id < server.num_instances; ++id) {
+		struct instance *const inst = &server.instances[id];
+
+		if (inst->ctx != NULL) {
+			continue;
+		}
+
+		inst->ctx = agoge_core_ctx_create(
+			NULL, AGOGE_CORE_CTX_ALIGN_CACHE_LINE);
+
+		if (inst->ctx == NULL) {
+			break;
+		}
+
+		uint8_t *const out = out_reserve(client, sizeof(uint32_t));
+
+		if (out == NULL) {
+			instance_destroy(inst);
+			return;
+		}
+
+		agoge_core_ctx_reset(inst->ctx);
+		inst->serial = server.num_created++;
+		le32_put(out, (uint32_t)id);
+
+		return;
+	}
+	client->status = AGOGE_SERVER_STATUS_NO_MEM;
+}
+
+static void cmd_load_rom(struct client *const client,
+			 struct instance *const inst)
+{
+	const struct req *const req = &client->req;
+	uint8_t *const rom = malloc(req->payload_size);
+
+	if (rom == NULL) {
+		client->status = AGOGE_SERVER_STATUS_NO_MEM;
+		return;
+	}
+
+	memcpy(rom, client->payload, req->payload_size);
+	agoge_core_ctx_clear(inst->ctx);
+	agoge_core_ctx_reset(inst->ctx);
+
+	if (agoge_core_cart_set(inst->ctx, rom, req->payload_size) !=
+	    AGOGE_CORE_CART_RETVAL_OK) {
+		free(rom);
+		free(inst->rom);
+
+		inst->rom = NULL;
+		inst->rom_size = 0;
+		client->status = AGOGE_SERVER_STATUS_BAD_ROM;
+
+		return;
+	}
+
+	free(inst->rom);
+	inst->rom = rom;
+	inst->rom_size = req->payload_size;
+}
+
+static void cmd_load_state(struct client *const client,
+			   struct instance *const inst)
+{
+	if (client->req.payload_size != agoge_core_ctx_state_size()) {
+		client->status = AGOGE_SERVER_STATUS_BAD_STATE;
+		return;
+	}
+
+	if (!agoge_core_ctx_state_load(inst->ctx, client->payload)) {
+		client->status = AGOGE_SERVER_STATUS_BAD_STATE;
+	}
+}
+
+static void cmd_save_state(struct client *const client,
+			   const struct instance *const inst)
+{
+	uint8_t *const out = out_reserve(client, agoge_core_ctx_state_size());
+
+	if (out != NULL) {
+		agoge_core_ctx_state_save(inst->ctx, out);
+	}
+}
+
+static void cmd_step(struct client *const client, struct instance *const inst)
+{
+	const struct req *const req = &client->req;
+
+	if (inst->rom == NULL) {
+		client->status = AGOGE_SERVER_STATUS_BAD_ROM;
+		return;
+	}
+
+	agoge_core_joypad_set(inst->ctx, (uint8_t)req->arg1);
+
+	const uint32_t num = (req->arg0 < STEP_FRAMES_ROUND) ?
+				     req->arg0 :
+				     STEP_FRAMES_ROUND;
+
+	for (uint32_t i = 0; i < num; ++i) {
+		agoge_core_ctx_run_frame(inst->ctx);
+	}
+
+	client->req.arg0 -= num;
+	client->partial = (client->req.arg0 != 0);
+}
+
+static void cmd_read_memory(struct client *const client,
+			    struct instance *const inst)
+{
+	const struct req *const req = &client->req;
+
+	if ((req->arg0 > UINT16_MAX) || (req->arg1 > 65536)) {
+		client->status = AGOGE_SERVER_STATUS_BAD_ARG;
+		return;
+	}
+
+	uint8_t *const out = out_reserve(client, req->arg1);
+
+	if (out != NULL) {
+		agoge_core_bus_peek_range(inst->ctx, (uint16_t)req->arg0, out,
+					  req->arg1);
+	}
+}
+
+static void cmd_get_framebuffer(struct client *const client,
+				const struct instance *const inst)
+{
+	uint8_t *const out = out_reserve(client, AGOGE_CORE_FRAME_SIZE);
+
+	if (out != NULL) {
+		memcpy(out, agoge_core_ctx_frame(inst->ctx),
+		       AGOGE_CORE_FRAME_SIZE);
+	}
+}
+
+/// Retrieves the delta encoder of a client for an instance, adding one whose
+/// next delta is a keyframe if the client has none yet.
+///
+/// @returns The delta encoder, or `NULL` if memory could not be allocated.
+static struct agoge_core_delta *delta_get(struct client *const client,
+					  const struct instance *const inst)
+{
+	for (size_t i = 0; i < client->num_deltas; ++i) {
+		if (client->deltas[i].serial == inst->serial) {
+			return &client->deltas[i].delta;
+		}
+	}
+
+	struct delta_slot *const deltas =
+		realloc(client->deltas,
+			(client->num_deltas + 1) * sizeof(*deltas));
+
+	if (deltas == NULL) {
+		return NULL;
+	}
+
+	struct delta_slot *const slot = &deltas[client->num_deltas++];
+
+	client->deltas = deltas;
+	slot->serial = inst->serial;
+	agoge_core_delta_reset(&slot->delta);
+
+	return &slot->delta;
+}
+
+static void cmd_get_frame_delta(struct client *const client,
+				const struct instance *const inst)
+{
+	struct agoge_core_delta *const delta = delta_get(client, inst);
+
+	if (delta == NULL) {
+		client->status = AGOGE_SERVER_STATUS_NO_MEM;
+		return;
+	}
+
+	uint8_t *const out = out_reserve(client, AGOGE_CORE_DELTA_SIZE_MAX);
+
+	if (out != NULL) {
+		client->out_size = agoge_core_delta_encode(
+			delta, agoge_core_ctx_ppu(inst->ctx), client->req.arg0,
+			out);
+	}
+}
+
+/// Runs a request for an existing instance; called from the thread pool.
+static void request_task(void *const udata, const size_t task_idx,
+			 const unsigned int worker_idx)
+{
+	(void)udata;
+	(void)worker_idx;
+
+	struct client *const client = server.tasks[task_idx];
+	struct instance *const inst = &server.instances[client->req.id];
+
+	switch (client->req.cmd) {
+	case AGOGE_SERVER_CMD_LOAD_ROM:
+		cmd_load_rom(client, inst);
+		return;
+
+	case AGOGE_SERVER_CMD_LOAD_STATE:
+		cmd_load_state(client, inst);
+		return;
+
+	case AGOGE_SERVER_CMD_SAVE_STATE:
+		cmd_save_state(client, inst);
+		return;
+
+	case AGOGE_SERVER_CMD_STEP:
+		cmd_step(client, inst);
+		return;
+
+	case AGOGE_SERVER_CMD_READ_MEMORY:
+		cmd_read_memory(client, inst);
+		return;
+
+	case AGOGE_SERVER_CMD_GET_FRAMEBUFFER:
+		cmd_get_framebuffer(client, inst);
+		return;
+
+	case AGOGE_SERVER_CMD_GET_FRAME_DELTA:
+		cmd_get_frame_delta(client, inst);
+		return;
+
+	case AGOGE_SERVER_CMD_CREATE:
+	case AGOGE_SERVER_CMD_DESTROY:
+	default:
+		__builtin_unreachable();
+	}
+}
+
+/// Handles a request on the main thread if it creates or destroys an
+/// instance or is invalid, or schedules it to run in the thread pool
+/// otherwise.
+static void request_schedule(struct client *const client)
+{
+	const struct req *const req = &client->req;
+
+	client->status = AGOGE_SERVER_STATUS_OK;
+	client->out_size = 0;
+	client->partial = false;
+
+	switch (req->cmd) {
+	case AGOGE_SERVER_CMD_CREATE:
+		cmd_create(client);
+		return;
+
+	case AGOGE_SERVER_CMD_DESTROY: {
+		struct instance *const inst = instance_get(req->id);
+
+		if (inst == NULL) {
+			client->status = AGOGE_SERVER_STATUS_BAD_ID;
+		} else {
+			instance_destroy(inst);
+		}
+		return;
+	}
+
+	case AGOGE_SERVER_CMD_LOAD_ROM:
+	case AGOGE_SERVER_CMD_LOAD_STATE:
+	case AGOGE_SERVER_CMD_SAVE_STATE:
+	case AGOGE_SERVER_CMD_STEP:
+	case AGOGE_SERVER_CMD_READ_MEMORY:
+	case AGOGE_SERVER_CMD_GET_FRAMEBUFFER:
+	case AGOGE_SERVER_CMD_GET_FRAME_DELTA: {
+		struct instance *const inst = instance_get(req->id);
+
+		if (inst == NULL) {
+			client->status = AGOGE_SERVER_STATUS_BAD_ID;
+			return;
+		}
+
+		inst->claimed = true;
+		server.tasks[server.num_tasks++] = client;
+
+		return;
+	}
+
+	default:
+		client->status = AGOGE_SERVER_STATUS_BAD_CMD;
+		return;
+	}
+}
+
+static void client_close(const size_t idx)
+{
+	struct client *const client = server.clients[idx];
+
+	// Give up the instance of a step which has not completed.
+	if (client->partial) {
+		server.instances[client->req.id].owner = NULL;
+	}
+
+	close(client->fd);
+	free(client->payload);
+	free(client->out);
+	free(client->deltas);
+	free(client);
+
+	server.clients[idx] = server.clients[--server.num_clients];
+}
+
+/// Sends as much of the queued response of a client as the socket takes.
+///
+/// @returns `false` if the client disconnected.
+static bool client_flush(struct client *const client)
+{
+	const size_t size = sizeof(client->resp) + client->out_size;
+
+	while (client->sent < size) {
+		const uint8_t *buf;
+		size_t left;
+
+		if (client->sent < sizeof(client->resp)) {
+			buf = &client->resp[client->sent];
+			left = sizeof(client->resp) - client->sent;
+		} else {
+			buf = &client->out[client->sent - sizeof(client->resp)];
+			left = size - client->sent;
+		}
+
+		const ssize_t n = send(client->fd, buf, left, MSG_NOSIGNAL);
+
+		if (n < 0) {
+			return (errno == EAGAIN) || (errno == EWOULDBLOCK) ||
+			       (errno == EINTR);
+		}
+		client->sent += (size_t)n;
+	}
+
+	client->sending = false;
+	return true;
+}
+
+/// Queues the response to the request of a client, sends what the socket
+/// takes, and prepares the client for its next request.
+static bool client_respond(struct client *const client)
+{
+	memset(client->resp, 0, sizeof(client->resp));
+
+	client->resp[0] = (uint8_t)client->status;
+	le32_put(&client->resp[4], (uint32_t)client->out_size);
+
+	client->ready = false;
+	client->hdr_len = 0;
+	client->payload_len = 0;
+	client->sent = 0;
+	client->sending = true;
+
+	return client_flush(client);
+}
+
+/// Receives as much of the next request of a client as is available.
+///
+/// @returns `false` if the client disconnected or violated the protocol.
+static bool client_recv(struct client *const client)
+{
+	while (!client->ready) {
+		uint8_t *dst;
+		size_t left;
+
+		if (client->hdr_len < sizeof(client->hdr)) {
+			dst = &client->hdr[client->hdr_len];
+			left = sizeof(client->hdr) - client->hdr_len;
+		} else {
+			dst = &client->payload[client->payload_len];
+			left = client->req.payload_size - client->payload_len;
+		}
+
+		const ssize_t n = recv(client->fd, dst, left, 0);
+
+		if (n == 0) {
+			return false;
+		}
+
+		if (n < 0) {
+			return (errno == EAGAIN) || (errno == EWOULDBLOCK) ||
+			       (errno == EINTR);
+		}
+
+		if (client->hdr_len < sizeof(client->hdr)) {
+			client->hdr_len += (size_t)n;
+
+			if (client->hdr_len < sizeof(client->hdr)) {
+				continue;
+			}
+
+			client->req = (struct req){
+				.cmd = client->hdr[0],
+				.id = le32_get(&client->hdr[4]),
+				.arg0 = le32_get(&client->hdr[8]),
+				.arg1 = le32_get(&client->hdr[12]),
+				.payload_size = le32_get(&client->hdr[16])
+			};
+
+			if ((client->req.payload_size >
+			     AGOGE_SERVER_PAYLOAD_MAX) ||
+			    !buf_reserve(&client->payload, &client->payload_cap,
+					 client->req.payload_size)) {
+				return false;
+			}
+		} else {
+			client->payload_len += (size_t)n;
+		}
+
+		client->ready = (client->hdr_len == sizeof(client->hdr)) &&
+				(client->payload_len ==
+				 client->req.payload_size);
+	}
+	return true;
+}
+
+static void client_accept(void)
+{
+	const int fd = accept(server.listen_fd, NULL, NULL);
+
+	if (fd < 0) {
+		return;
+	}
+
+	if (fcntl(fd, F_SETFL, O_NONBLOCK) < 0) {
+		close(fd);
+		return;
+	}
+
+	if (server.num_clients == server.clients_cap) {
+		const size_t cap = (server.clients_cap * 2) + 1;
+		struct client **const clients =
+			realloc(server.clients, cap * sizeof(*clients));
+
+		if (clients == NULL) {
+			close(fd);
+			return;
+		}
+		server.clients = clients;
+
+		struct client **const tasks =
+			realloc(server.tasks, cap * sizeof(*tasks));
+
+		if (tasks == NULL) {
+			close(fd);
+			return;
+		}
+
+		server.tasks = tasks;
+
+		struct pollfd *const pfds =
+			realloc(server.pfds, (cap + 1) * sizeof(*pfds));
+
+		if (pfds == NULL) {
+			close(fd);
+			return;
+		}
+
+		server.pfds = pfds;
+		server.clients_cap = cap;
+	}
+
+	struct client *const client = calloc(1, sizeof(*client));
+
+	if (client == NULL) {
+		close(fd);
+		return;
+	}
+
+	client->fd = fd;
+	server.clients[server.num_clients++] = client;
+}
+
+/// Runs a single round: receives requests, runs them, and responds.
+static void round_run(void)
+{
+	struct pollfd *const pfds = server.pfds;
+	bool pending = false;
+
+	pfds[0] = (struct pollfd){ .fd = server.listen_fd, .events = POLLIN };
+
+	for (size_t i = 0; i < server.num_clients; ++i) {
+		const struct client *const client = server.clients[i];
+
+		// A client with a request waiting is not read from until the
+		// request is handled, nor is its request handled until its
+		// last response is sent.
+		pfds[i + 1] = (struct pollfd){
+			.fd = client->fd,
+			.events = (short)((client->ready ? 0 : POLLIN) |
+					  (client->sending ? POLLOUT : 0))
+		};
+		pending |= client->ready && !client->sending;
+	}
+
+	// Requests deferred by the last round run without waiting.
+	if (poll(pfds, server.num_clients + 1, pending ? 0 : -1) < 0) {
+		return;
+	}
+
+	const size_t num_polled = server.num_clients;
+
+	// Closing a client moves the last one into its slot, so walk back.
+	for (size_t i = num_polled; i-- > 0;) {
+		struct client *const client = server.clients[i];
+		const short revents = pfds[i + 1].revents;
+
+		// A client which hung up is closed even with a request
+		// waiting, so that a step it started stops.
+		if ((revents & (POLLERR | POLLHUP)) ||
+		    ((revents & POLLOUT) && !client_flush(client)) ||
+		    ((revents & ~POLLOUT) && !client_recv(client))) {
+			client_close(i);
+		}
+	}
+
+	if (pfds[0].revents & POLLIN) {
+		client_accept();
+	}
+
+	server.num_tasks = 0;
+
+	for (size_t i = 0; i < server.num_clients; ++i) {
+		struct client *const client = server.clients[i];
+		const struct instance *const inst =
+			instance_get(client->req.id);
+
+		// Another request for the same instance already runs in this
+		// round, or another client's step still runs on it; defer this
+		// one to a later round.
+		const bool busy = (inst != NULL) &&
+				  (client->req.cmd != AGOGE_SERVER_CMD_CREATE) &&
+				  (inst->claimed || ((inst->owner != NULL) &&
+						     (inst->owner != client)));
+
+		client->handled = client->ready && !client->sending && !busy;
+
+		if (client->handled) {
+			request_schedule(client);
+		}
+	}
+
+	agoge_pool_run(server.pool, server.num_tasks, &request_task, NULL);
+
+	for (size_t i = 0; i < server.num_tasks; ++i) {
+		struct client *const client = server.tasks[i];
+		struct instance *const inst = &server.instances[client->req.id];
+
+		inst->claimed = false;
+		inst->owner = client->partial ? client : NULL;
+	}
+
+	for (size_t i = server.num_clients; i-- > 0;) {
+		struct client *const client = server.clients[i];
+
+		// A partial request stays ready, and continues next round.
+		if (client->handled && !client->partial &&
+		    !client_respond(client)) {
+			client_close(i);
+		}
+	}
+}
+
+static bool listen_start(const char *const path)
+{
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		fprintf(stderr, "Socket path %s is too long\n", path);
+		return false;
+	}
+	strcpy(addr.sun_path, path);
+
+	// Only replace a stale socket, never another kind of file.
+	struct stat st;
+
+	if ((lstat(path, &st) == 0) && S_ISSOCK(st.st_mode)) {
+		unlink(path);
+	}
+
+	server.listen_fd =
+		socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+	if (server.listen_fd < 0) {
+		fprintf(stderr, "Unable to create socket: %s\n",
+			strerror(errno));
+		return false;
+	}
+
+	if ((bind(server.listen_fd, (const struct sockaddr *)&addr,
+		  sizeof(addr)) < 0) ||
+	    (listen(server.listen_fd, LISTEN_BACKLOG) < 0)) {
+		fprintf(stderr, "Unable to listen on %s: %s\n", path,
+			strerror(errno));
+		close(server.listen_fd);
+
+		return false;
+	}
+	return true;
+}
+
+static void server_stop(const char *const path)
+{
+	while (server.num_clients > 0) {
+		client_close(server.num_clients - 1);
+	}
+
+	for (size_t i = 0; i < server.num_instances; ++i) {
+		instance_destroy(&server.instances[i]);
+	}
+
+	free(server.clients);
+	free(server.tasks);
+	free(server.pfds);
+	free(server.instances);
+
+	agoge_pool_destroy(server.pool);
+	close(server.listen_fd);
+	unlink(path);
+}
+
+static void usage(const char *const argv0)
+{
+	fprintf(stderr,
+		"Syntax: %s [-t num_threads] [-n max_instances] <socket_path>\n",
+		argv0);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned long num_threads = 0;
+	unsigned long max_instances = INSTANCES_MAX_DEFAULT;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "t:n:")) != -1) {
+		switch (opt) {
+		case 't':
+			num_threads = strtoul(optarg, NULL, 10);
+			break;
+
+		case 'n':
+			max_instances = strtoul(optarg, NULL, 10);
+			break;
+
+		default:
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if ((optind != (argc - 1)) || (max_instances == 0) ||
+	    (num_threads > AGOGE_POOL_WORKERS_MAX)) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const char *const path = argv[optind];
+
+	server.num_instances = max_instances;
+	server.instances = calloc(max_instances, sizeof(*server.instances));
+	server.pfds = malloc(sizeof(*server.pfds));
+	server.pool = agoge_pool_create((unsigned int)num_threads);
+
+	if ((server.instances == NULL) || (server.pfds == NULL) ||
+	    (server.pool == NULL)) {
+		fprintf(stderr, "Unable to allocate server state\n");
+		free(server.instances);
+		free(server.pfds);
+		agoge_pool_destroy(server.pool);
+
+		return EXIT_FAILURE;
+	}
+
+	if (!listen_start(path)) {
+		free(server.instances);
+		free(server.pfds);
+		agoge_pool_destroy(server.pool);
+
+		return EXIT_FAILURE;
+	}
+
+	const struct sigaction sa = { .sa_handler = &signal_handler };
+
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	while (!quit) {
+		round_run();
+	}
+
+	server_stop(path);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+// Copyright 2025 dgz
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the “Software”), to deal
+// in the Software without restriction, including without limitation the rights
+// to use copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/// @file protocol.h Defines the wire protocol of `agoge_server`.
+///
+/// Clients connect to the Unix domain stream socket of the server and send
+/// requests, each answered by exactly one response in order. A request is an
+/// `AGOGE_SERVER_REQ_SIZE` byte header followed by `payload_size` bytes of
+/// payload; a response is an `AGOGE_SERVER_RESP_SIZE` byte header followed by
+/// `payload_size` bytes of payload. Every field is little endian.
+///
+/// Request header:
+///
+/// | Offset | Size | Field          |
+/// |--------|------|----------------|
+/// | 0      | 1    | `cmd`          |
+/// | 1      | 3    | reserved       |
+/// | 4      | 4    | `id`           |
+/// | 8      | 4    | `arg0`         |
+/// | 12     | 4    | `arg1`         |
+/// | 16     | 4    | `payload_size` |
+///
+/// Response header:
+///
+/// | Offset | Size | Field          |
+/// |--------|------|----------------|
+/// | 0      | 1    | `status`       |
+/// | 1      | 3    | reserved       |
+/// | 4      | 4    | `payload_size` |
+///
+/// Requests from different clients for different instances run in parallel.
+
+#pragma once
+
+/// The size of a request header in bytes.
+#define AGOGE_SERVER_REQ_SIZE (20)
+
+/// The size of a response header in bytes.
+#define AGOGE_SERVER_RESP_SIZE (8)
+
+/// The largest request payload accepted in bytes.
+#define AGOGE_SERVER_PAYLOAD_MAX (8388608)
+
+/// Defines the commands of a request.
+enum agoge_server_cmd {
+	/// Creates an instance. The response payload is its `id` as 4 bytes.
+	AGOGE_SERVER_CMD_CREATE = 0,
+
+	/// Destroys instance `id`.
+	AGOGE_SERVER_CMD_DESTROY = 1,
+
+	/// Loads the ROM in the payload into instance `id`, and resets it.
+	AGOGE_SERVER_CMD_LOAD_ROM = 2,
+
+	/// Loads the save state in the payload into instance `id`.
+	AGOGE_SERVER_CMD_LOAD_STATE = 3,
+
+	/// Saves the state of instance `id`. The response payload is the save
+	/// state.
+	AGOGE_SERVER_CMD_SAVE_STATE = 4,
+
+	/// Sets the pressed buttons of instance `id` to `arg1`, and runs it for
+	/// `arg0` frames. Long steps run in slices between the requests of
+	/// other clients; the response comes once every frame has run.
+	AGOGE_SERVER_CMD_STEP = 5,
+
+	/// Reads `arg1` bytes starting at address `arg0` of instance `id`. The
+	/// response payload is the memory read.
+	AGOGE_SERVER_CMD_READ_MEMORY = 6,
+
+	/// Retrieves the frame of instance `id`. The response payload is the
+	/// frame, one shade (0-3) per pixel, row by row.
+	AGOGE_SERVER_CMD_GET_FRAMEBUFFER = 7,
+
+	/// Retrieves the lines of the frame of instance `id` that changed since
+	/// the previous `AGOGE_SERVER_CMD_GET_FRAME_DELTA` of the same client
+	/// for it, encoded with `arg0` as flags; see `agoge_core_delta_encode`.
+	/// The response payload is the delta. The first delta of an instance for
+	/// a client is a keyframe.
+	AGOGE_SERVER_CMD_GET_FRAME_DELTA = 8
+};
+
+/// Defines the status of a response.
+enum agoge_server_status {
+	/// The request succeeded.
+	AGOGE_SERVER_STATUS_OK = 0,
+
+	/// The command is unknown.
+	AGOGE_SERVER_STATUS_BAD_CMD = 1,
+
+	/// The instance does not exist.
+	AGOGE_SERVER_STATUS_BAD_ID = 2,
+
+	/// An argument or the payload is invalid.
+	AGOGE_SERVER_STATUS_BAD_ARG = 3,
+
+	/// The server ran out of memory or instances.
+	AGOGE_SERVER_STATUS_NO_MEM = 4,
+
+	/// The ROM was rejected, or the instance has no ROM loaded.
+	AGOGE_SERVER_STATUS_BAD_ROM = 5,
+
+	/// The save state was rejected.
+	AGOGE_SERVER_STATUS_BAD_STATE = 6,
+
+	/// The command is not supported by this build.
+	AGOGE_SERVER_STATUS_UNSUPPORTED = 7
+};